@@ -16,6 +16,7 @@
 #ifndef PokemonAutomation_ComputationThreadPool_H
 #define PokemonAutomation_ComputationThreadPool_H
 
+#include <memory>
 #include <functional>
 #include "Common/Cpp/Time.h"
 #include "Common/Cpp/Containers/Pimpl.h"
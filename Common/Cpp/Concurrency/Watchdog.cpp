@@ -25,10 +25,39 @@ Watchdog::~Watchdog(){
     m_thread.join();
 }
 Watchdog::Watchdog()
-    : m_thread([this]{ thread_body(); })
+    : m_epoch(current_time())
+    , m_wheel(WHEEL_SLOTS)
+    , m_thread([this]{ thread_body(); })
 {}
 
 
+int64_t Watchdog::tick_floor(WallClock time) const{
+    if (time <= m_epoch){
+        return 0;
+    }
+    if (time == WallClock::max()){
+        return INT64_MAX;
+    }
+    return std::chrono::floor<std::chrono::milliseconds>(time - m_epoch) / TICK;
+}
+int64_t Watchdog::tick_ceil(WallClock time) const{
+    if (time <= m_epoch){
+        return 0;
+    }
+    if (time == WallClock::max()){
+        return INT64_MAX;
+    }
+    return std::chrono::ceil<std::chrono::milliseconds>(time - m_epoch) / TICK;
+}
+
+
+void Watchdog::signal(){
+    std::lock_guard<std::mutex> wlg(m_sleep_lock);
+    m_signalled = true;
+    m_cv.notify_all();
+}
+
+
 void Watchdog::add(WatchdogCallback& callback, std::chrono::milliseconds period){
     bool signal = true;
 
@@ -36,30 +65,34 @@ void Watchdog::add(WatchdogCallback& callback, std::chrono::milliseconds period)
     {
         WriteSpinLock slg(m_state_lock);
 
+        callback.m_watchdog_kicked.store(0, std::memory_order_relaxed);
+
         auto iter = m_callbacks.find(&callback);
         if (iter == m_callbacks.end()){
             //  Callback doesn't exist. Add it.
-            auto iter1 = m_schedule.emplace(now + period, callback);
+            iter = m_callbacks.emplace(
+                std::piecewise_construct,
+                std::forward_as_tuple(&callback),
+                std::forward_as_tuple(callback, period)
+            ).first;
+            Entry& entry = iter->second;
             try{
-                m_callbacks.emplace(
-                    std::piecewise_construct,
-                    std::forward_as_tuple(&callback),
-                    std::forward_as_tuple(callback, period, iter1)
-                );
+                Slot& slot = m_wheel[0];
+                entry.iter = slot.emplace(slot.end(), &entry);
             }catch (...){
-                m_schedule.erase(iter1);
+                m_callbacks.erase(iter);
                 throw;
             }
+            signal = arm_unprotected(entry, now + period);
         }else{
             //  Callback already exists. Update the period.
             iter->second.period = period;
-            signal = update_unprotected(iter, now + period);
+            signal = arm_unprotected(iter->second, now + period);
         }
     }
 
     if (signal){
-        std::lock_guard<std::mutex> wlg(m_sleep_lock);
-        m_cv.notify_all();
+        this->signal();
     }
 }
 void Watchdog::remove(WatchdogCallback& callback){
@@ -82,9 +115,9 @@ bool Watchdog::try_remove(WatchdogCallback& callback){
         return false;
     }
 
-    //  Remove from the schedule first.
-    auto iter_s = iter_c->second.iter;
-    m_schedule.erase(iter_s);
+    //  Remove from the wheel first.
+    Entry& entry = iter_c->second;
+    m_wheel[entry.slot].erase(entry.iter);
 
     //  Unlock and remove from callback set.
     entry_lock.unlock();
@@ -95,56 +128,106 @@ bool Watchdog::try_remove(WatchdogCallback& callback){
 
 
 
-bool Watchdog::update_unprotected(CallbackMap::iterator iter, WallClock next_call){
+bool Watchdog::arm_unprotected(Entry& entry, WallClock deadline){
     //  Must be called under the "m_state_lock".
 
-    if (next_call == iter->second.iter->first){
-        //  No change in time.
-        return false;
-    }
-
-    WallClock current_wake_time = m_schedule.begin()->first;
+    entry.deadline = deadline;
+    entry.tick = std::max(tick_ceil(deadline), m_cursor);
 
-    //  Add the new time first. Then remove the old one. This ensures strong
-    //  exception safety.
-    auto new_iter = m_schedule.emplace(next_call, *iter->first);
-    m_schedule.erase(iter->second.iter);
-    iter->second.iter = new_iter;
+    size_t slot = (size_t)(entry.tick % (int64_t)WHEEL_SLOTS);
+    if (slot != entry.slot){
+        //  Splicing a list node doesn't allocate and keeps "iter" valid.
+        m_wheel[slot].splice(m_wheel[slot].end(), m_wheel[entry.slot], entry.iter);
+        entry.slot = slot;
+    }
 
-    WallClock new_wake_time = m_schedule.begin()->first;
-    return new_wake_time < current_wake_time;
+    return deadline < m_wake_time;
 }
 void Watchdog::delay(WatchdogCallback& callback, WallClock next_call){
     bool signal = false;
-
-    WallClock now = current_time();
     {
         WriteSpinLock slg(m_state_lock);
         auto iter = m_callbacks.find(&callback);
         if (iter == m_callbacks.end()){
             return;
         }
-        signal = update_unprotected(
-            iter,
-            next_call == WallClock::min()
-                ? now + iter->second.period
-                : next_call
-        );
+
+        //  An explicit time replaces any earlier kick.
+        callback.m_watchdog_kicked.store(0, std::memory_order_relaxed);
+        signal = arm_unprotected(iter->second, next_call);
     }
 
     if (signal){
-        std::lock_guard<std::mutex> wlg(m_sleep_lock);
-        m_cv.notify_all();
+        this->signal();
     }
 }
 void Watchdog::delay(WatchdogCallback& callback){
-    this->delay(callback, WallClock::min());
+    //  Only ever pushes the deadline back, so the thread doesn't need to know
+    //  until the current one expires.
+    callback.m_watchdog_kicked.store(
+        current_time().time_since_epoch().count(),
+        std::memory_order_relaxed
+    );
 }
 void Watchdog::delay(WatchdogCallback& callback, std::chrono::milliseconds delay){
     this->delay(callback, current_time() + delay);
 }
 
 
+Watchdog::Entry* Watchdog::advance_unprotected(WallClock now){
+    //  Must be called under the "m_state_lock".
+
+    int64_t now_tick = tick_floor(now);
+    int64_t last = std::min(now_tick, m_cursor + (int64_t)WHEEL_SLOTS - 1);
+
+    for (int64_t tick = m_cursor; tick <= last; tick++){
+        Slot& slot = m_wheel[(size_t)(tick % (int64_t)WHEEL_SLOTS)];
+        for (auto iter = slot.begin(); iter != slot.end();){
+            Entry& entry = **iter;
+            ++iter;
+
+            //  Armed for a later revolution.
+            if (entry.tick > now_tick){
+                continue;
+            }
+
+            //  Kicked since it was armed. Push it back.
+            WallClock kicked(WallClock::duration(
+                entry.callback.m_watchdog_kicked.load(std::memory_order_relaxed)
+            ));
+            WallClock deadline = std::max(entry.deadline, kicked + entry.period);
+            if (now < deadline){
+                //  Always lands on a tick after "now_tick", so it won't be
+                //  seen again in this pass.
+                arm_unprotected(entry, deadline);
+                continue;
+            }
+
+            //  Leave the cursor here. We'll come back for the rest of this
+            //  slot after running this one.
+            m_cursor = tick;
+            return &entry;
+        }
+    }
+
+    m_cursor = now_tick + 1;
+    return nullptr;
+}
+WallClock Watchdog::next_wake_unprotected() const{
+    //  Must be called under the "m_state_lock".
+
+    //  Wake up for the first non-empty slot. Entries there may be for a later
+    //  revolution. If so, we wake up once per revolution for nothing.
+    for (size_t c = 0; c < WHEEL_SLOTS; c++){
+        int64_t tick = m_cursor + (int64_t)c;
+        if (!m_wheel[(size_t)(tick % (int64_t)WHEEL_SLOTS)].empty()){
+            return m_epoch + tick * TICK;
+        }
+    }
+    return WallClock::max();
+}
+
+
 void Watchdog::thread_body(){
     WallClock wake_time = WallClock::min();
     while (true){
@@ -153,49 +236,33 @@ void Watchdog::thread_body(){
             if (m_stopped){
                 break;
             }
+            auto woken = [&]{ return m_stopped || m_signalled; };
             if (wake_time == WallClock::max()){
-//                cout << "Sleeping indefinitely..." << endl;
-                m_cv.wait(wlg);
-//                cout << "Waking up..." << endl;
+                m_cv.wait(wlg, woken);
             }else if (wake_time != WallClock::min()){
-//                cout << "Sleeping until... " << std::chrono::duration_cast<std::chrono::milliseconds>(wake_time - current_time()) << endl;
-                m_cv.wait_until(wlg, wake_time);
-//                cout << "Waking up..." << endl;
+                m_cv.wait_until(wlg, wake_time, woken);
+            }
+            if (m_stopped){
+                break;
             }
-        }
-//        cout << "Checking..." << endl;
 
-        WallClock now = current_time();
+            //  Clear before looking at the schedule. Anything armed after
+            //  this will signal again.
+            m_signalled = false;
+        }
 
         std::unique_lock<std::mutex> elg;
         Entry* entry;
-        CallbackMap::iterator iter_c;
         {
             WriteSpinLock slg(m_state_lock);
-
-            //  Nothing scheduled.
-            if (m_schedule.empty()){
-//                cout << "Nothing scheduled..." << endl;
-                wake_time = WallClock::max();
-                continue;
-            }
-
-            //  Check if the next scheduled thing is ready to run.
-
-            Schedule::iterator iter_s = m_schedule.begin();
-            iter_c = m_callbacks.find(&iter_s->second);
-            if (now < iter_s->first){
-                //  Not ready to run yet.
-//                cout << "Not ready to run yet..." << endl;
-                wake_time = iter_s->first;
+            entry = advance_unprotected(current_time());
+            if (entry == nullptr){
+                wake_time = next_wake_unprotected();
+                m_wake_time = wake_time;
                 continue;
-            }else{
-                //  Ready to run.
-                entry = &iter_c->second;
-                elg = std::unique_lock<std::mutex>(entry->lock);
             }
+            elg = std::unique_lock<std::mutex>(entry->lock);
         }
-//        cout << "Running..." << endl;
 
         //  Run the callback.
         try{
@@ -208,9 +275,11 @@ void Watchdog::thread_body(){
             std::cerr << "Watchdog callback threw an exception." << std::endl;
         }
 
-        WriteSpinLock slg(m_state_lock);
-        update_unprotected(iter_c, current_time() + entry->period);
-//        entry->lock.unlock();
+        {
+            WriteSpinLock slg(m_state_lock);
+            arm_unprotected(*entry, current_time() + entry->period);
+            elg.unlock();
+        }
 
         wake_time = WallClock::min();
     }
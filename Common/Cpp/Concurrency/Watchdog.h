@@ -14,6 +14,10 @@
 #ifndef PokemonAutomation_Watchdog_H
 #define PokemonAutomation_Watchdog_H
 
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <list>
 #include <map>
 #include <mutex>
 #include <condition_variable>
@@ -27,6 +31,14 @@ namespace PokemonAutomation{
 
 struct WatchdogCallback{
     virtual void on_watchdog_timeout() = 0;
+
+private:
+    friend class Watchdog;
+
+    //  Last time Watchdog::delay(callback) was called on this, as a count of
+    //  WallClock ticks. Written without locks. The watchdog thread only reads
+    //  it when this callback's timer expires.
+    std::atomic<WallClock::rep> m_watchdog_kicked{0};
 };
 
 
@@ -51,9 +63,10 @@ public:
     //
     //  All public methods are fully thread-safe with each other. (except the destructor)
     //
-    //  The above methods add() and delay(), are fast and will return quickly.
-    //  So it is safe to call them in semi-performance critical places.
-    //  (The critical section involves one spin-lock acquisition and 3 map lookups.)
+    //  delay(callback) is a single atomic store. It takes no locks and doesn't
+    //  touch the schedule. So it can be called on every video frame or audio
+    //  block. The other overloads of delay() and add() take a spin-lock and do
+    //  one map lookup.
     //
     //  remove() will also return quickly unless the callback being removed
     //  is currently running. In that case, it will block until it is done
@@ -61,32 +74,58 @@ public:
     //
 
 private:
-    using Schedule = std::multimap<WallClock, WatchdogCallback&>;
+    //  Hashed timer wheel. Each callback sits in slot (tick % WHEEL_SLOTS) of
+    //  the tick it is armed for. Callbacks armed more than one revolution out
+    //  share a slot with nearer ones and are skipped until their tick comes.
+    static constexpr std::chrono::milliseconds TICK = std::chrono::milliseconds(1);
+    static constexpr size_t WHEEL_SLOTS = 1024;
+
+    struct Entry;
+    using Slot = std::list<Entry*>;
 
     struct Entry{
         WatchdogCallback& callback;
         std::chrono::milliseconds period;
-        Schedule::iterator iter;
+
+        //  When the timer is armed for. The real deadline may be later if the
+        //  callback has been kicked since. That is resolved when this expires.
+        WallClock deadline;
+        int64_t tick = 0;
+        size_t slot = 0;
+        Slot::iterator iter;
+
         std::mutex lock;
 
-        Entry(
-            WatchdogCallback& p_callback,
-            std::chrono::milliseconds p_period,
-            Schedule::iterator p_iter
-        )
-            : callback(p_callback), period(p_period), iter(p_iter)
+        Entry(WatchdogCallback& p_callback, std::chrono::milliseconds p_period)
+            : callback(p_callback), period(p_period)
         {}
     };
     using CallbackMap = std::map<WatchdogCallback*, Entry>;
 
-    //  Return true if the next call has moved up and we should signal.
-    bool update_unprotected(CallbackMap::iterator iter, WallClock next_call);
+    int64_t tick_floor(WallClock time) const;
+    int64_t tick_ceil(WallClock time) const;
+
+    //  Move the entry to the slot for "deadline".
+    //  Return true if the thread needs to wake up earlier than planned.
+    bool arm_unprotected(Entry& entry, WallClock deadline);
+
+    //  Advance the wheel to "now". Re-arm kicked callbacks. Return the first
+    //  callback that is due or nullptr if none are.
+    Entry* advance_unprotected(WallClock now);
+    WallClock next_wake_unprotected() const;
+
+    void signal();
     void thread_body();
 
 private:
     bool m_stopped = false;
+    bool m_signalled = false;
     CallbackMap m_callbacks;
-    Schedule m_schedule;
+
+    const WallClock m_epoch;
+    int64_t m_cursor = 0;   //  Next tick to process.
+    std::vector<Slot> m_wheel;
+    WallClock m_wake_time = WallClock::max();
 
     //  Nothing should ever acquire both locks at once.
     SpinLock m_state_lock;
@@ -97,6 +97,9 @@ public:
     const_iterator find(const std::string& key) const{ return m_data.find(key); }
           iterator find(const std::string& key)      { return m_data.find(key); }
 
+    //  Returns the number of entries removed. (0 or 1)
+    size_t erase(const std::string& key){ return m_data.erase(key); }
+
     const_iterator cbegin   () const{ return m_data.cbegin(); }
     const_iterator begin    () const{ return m_data.begin(); }
           iterator begin    ()      { return m_data.begin(); }
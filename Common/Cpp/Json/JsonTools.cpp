@@ -59,6 +59,28 @@ bool file_to_string(const std::string& filename, std::string& content){
 }
 
 
+JsonValue load_json_file(const std::string& filename){
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QFile::ReadOnly)){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to open file.", filename);
+    }
+
+    //  Parse straight out of the mapped file to avoid copying it first.
+    qint64 size = file.size();
+    if (size > 0){
+        uchar* data = file.map(0, size);
+        if (data != nullptr){
+            JsonValue ret = parse_json((const char*)data, (size_t)size);
+            file.unmap(data);
+            return ret;
+        }
+    }
+
+    std::string str = file.readAll().toStdString();
+    return parse_json(str);
+}
+
+
 
 
 JsonValue from_nlohmann(const nlohmann::json& json){
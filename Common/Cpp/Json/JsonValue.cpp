@@ -366,12 +366,112 @@ bool JsonValue::read_string(std::string& value) const{
 
 
 
-JsonValue parse_json(const std::string& str){
-    return from_nlohmann(nlohmann::json::parse(str, nullptr, false));
+namespace{
+
+//  Builds the JsonValue directly from the parser events instead of building
+//  a full nlohmann::json tree and converting it afterwards.
+class JsonValueBuilder{
+public:
+    using number_integer_t = nlohmann::json::number_integer_t;
+    using number_unsigned_t = nlohmann::json::number_unsigned_t;
+    using number_float_t = nlohmann::json::number_float_t;
+    using string_t = nlohmann::json::string_t;
+    using binary_t = nlohmann::json::binary_t;
+
+    JsonValue take(){ return std::move(m_root); }
+
+    bool null(){
+        add(JsonValue());
+        return true;
+    }
+    bool boolean(bool val){
+        add(JsonValue(val));
+        return true;
+    }
+    bool number_integer(number_integer_t val){
+        add(JsonValue((int64_t)val));
+        return true;
+    }
+    bool number_unsigned(number_unsigned_t val){
+        add(JsonValue((int64_t)val));
+        return true;
+    }
+    bool number_float(number_float_t val, const string_t&){
+        add(JsonValue((double)val));
+        return true;
+    }
+    bool string(string_t& val){
+        add(JsonValue(std::move(val)));
+        return true;
+    }
+    bool binary(binary_t&){
+        add(JsonValue());
+        return true;
+    }
+
+    bool start_object(std::size_t){
+        m_stack.emplace_back(&add(JsonObject()));
+        return true;
+    }
+    bool key(string_t& val){
+        m_key = std::move(val);
+        return true;
+    }
+    bool end_object(){
+        m_stack.pop_back();
+        return true;
+    }
+    bool start_array(std::size_t){
+        m_stack.emplace_back(&add(JsonArray()));
+        return true;
+    }
+    bool end_array(){
+        m_stack.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&){
+        return false;
+    }
+
+private:
+    JsonValue& add(JsonValue&& value){
+        if (m_stack.empty()){
+            m_root = std::move(value);
+            return m_root;
+        }
+        JsonValue& parent = *m_stack.back();
+        JsonArray* array = parent.to_array();
+        if (array != nullptr){
+            array->push_back(std::move(value));
+            return (*array)[array->size() - 1];
+        }
+        //  Duplicate keys: The last one wins.
+        JsonValue& slot = (*parent.to_object())[std::move(m_key)];
+        slot = std::move(value);
+        return slot;
+    }
+
+private:
+    JsonValue m_root;
+    std::string m_key;
+
+    //  The containers that are currently open. Only the innermost one is
+    //  modified so none of these are invalidated.
+    std::vector<JsonValue*> m_stack;
+};
+
 }
-JsonValue load_json_file(const std::string& filename){
-    std::string str = file_to_string(filename);
-    return parse_json(str);
+
+JsonValue parse_json(const char* data, size_t size){
+    JsonValueBuilder builder;
+    if (!nlohmann::json::sax_parse(data, data + size, &builder)){
+        return JsonValue();
+    }
+    return builder.take();
+}
+JsonValue parse_json(const std::string& str){
+    return parse_json(str.data(), str.size());
 }
 std::string JsonValue::dump(int indent) const{
     return to_nlohmann(*this).dump(indent);
@@ -165,6 +165,8 @@ private:
 // The input string is usually loaded directly from a JSON file.
 // You can call JsonTools.h:file_to_string() to load a file as a raw JSON string.
 JsonValue parse_json(const std::string& str);
+// Same as above, but parses directly from a buffer. (e.g. a memory-mapped file)
+JsonValue parse_json(const char* data, size_t size);
 // Load file from `filename` and parse it into a `JsonValue`.
 // If unable to open the file, FileException is thrown
 // If there is error parsing the JSON, it will not throw exception.
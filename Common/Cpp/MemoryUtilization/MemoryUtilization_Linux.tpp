@@ -8,10 +8,10 @@
 #define PokemonAutomation_MemoryUtilization_Linux_TPP
 
 #include <stdint.h>
-#include <utility>
-#include <string>
-#include <fstream>
-#include <iostream>
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+#include <fcntl.h>
 #include <unistd.h>
 #include "MemoryUtilization.h"
 
@@ -50,39 +50,92 @@ uint64_t parse_integer(const char*& ptr){
     return ret;
 }
 
-MemoryUsage process_memory_usage(){
-    MemoryUsage usage;
 
-    uint64_t page_size = sysconf(_SC_PAGE_SIZE);
 
-    usage.total_system_memory = (uint64_t)sysconf(_SC_PHYS_PAGES) * page_size;
+//  A /proc file that stays open for the life of the process. Each read is a
+//  single pread() into a fixed buffer so sampling never allocates.
+class ProcFile{
+public:
+    static constexpr size_t BUFFER_SIZE = 8192;
 
+public:
+    ProcFile(const char* path)
+        : m_fd(::open(path, O_RDONLY | O_CLOEXEC))
+        , m_bytes(0)
     {
-        uint64_t bytes = 0;
-
-#if 1
-        const std::string TOKEN = "MemAvailable:";
+        m_buffer[0] = '\0';
+    }
+    ~ProcFile(){
+        if (m_fd != -1){
+            ::close(m_fd);
+        }
+    }
 
-        std::ifstream file("/proc/meminfo");
-        std::string line;
-        while (std::getline(file, line)){
-//            cout << line << endl;
+    bool read(){
+        m_bytes = 0;
+        m_buffer[0] = '\0';
+        if (m_fd == -1){
+            return false;
+        }
+        ssize_t bytes = ::pread(m_fd, m_buffer, BUFFER_SIZE - 1, 0);
+        if (bytes <= 0){
+            return false;
+        }
+        m_bytes = (size_t)bytes;
+        m_buffer[m_bytes] = '\0';
+        return true;
+    }
 
-            size_t pos = line.find(TOKEN);
-            if (pos == std::string::npos){
-                continue;
+    //  Find the line starting with "token" and return its value. Returns 0 if
+    //  it isn't there. The caller supplies "token" with its trailing colon.
+    uint64_t find_value(const char* token, size_t token_length) const{
+        const char* ptr = m_buffer;
+        const char* end = m_buffer + m_bytes;
+        while (ptr < end){
+            if ((size_t)(end - ptr) > token_length && memcmp(ptr, token, token_length) == 0){
+                ptr += token_length;
+                return parse_integer(ptr);
             }
+            const char* next = (const char*)memchr(ptr, '\n', end - ptr);
+            if (next == nullptr){
+                break;
+            }
+            ptr = next + 1;
+        }
+        return 0;
+    }
 
-            //  Skip the token.
-            pos += TOKEN.size();
+private:
+    int m_fd;
+    size_t m_bytes;
+    char m_buffer[BUFFER_SIZE];
+};
 
-            const char* ptr = &line[pos];
-            bytes = parse_integer(ptr) * 1024;
+template <size_t N>
+uint64_t find_proc_value(const ProcFile& file, const char (&token)[N]){
+    return file.find_value(token, N - 1);
+}
 
-            break;
-        }
-#endif
 
+
+MemoryUsage process_memory_usage(){
+    static const uint64_t page_size = sysconf(_SC_PAGE_SIZE);
+    static const uint64_t total_memory = (uint64_t)sysconf(_SC_PHYS_PAGES) * page_size;
+
+    //  The buffers are shared so only one sample at a time.
+    static std::mutex lock;
+    static ProcFile meminfo("/proc/meminfo");
+    static ProcFile status("/proc/self/status");
+    std::lock_guard<std::mutex> lg(lock);
+
+    MemoryUsage usage;
+    usage.total_system_memory = total_memory;
+
+    {
+        uint64_t bytes = 0;
+        if (meminfo.read()){
+            bytes = find_proc_value(meminfo, "MemAvailable:") * 1024;
+        }
         if (bytes == 0){
             bytes = (uint64_t)sysconf(_SC_AVPHYS_PAGES) * page_size;
         }
@@ -91,32 +144,9 @@ MemoryUsage process_memory_usage(){
         usage.total_used_system_memory = usage.total_system_memory - bytes;
     }
 
-    uint64_t swapped = 0;
-    {
-        const std::string VmRSS = "VmRSS:";
-        const std::string VmSwap = "VmSwap:";
-
-        pid_t current_pid = getpid();
-        std::ifstream file("/proc/" + std::to_string(current_pid) + "/status");
-        std::string line;
-        while (std::getline(file, line)){
-//            cout << line << endl;
-
-            size_t pos = line.find(VmRSS);
-            if (pos != std::string::npos){
-                pos += VmRSS.size();
-                const char* ptr = &line[pos];
-                usage.process_physical_memory = parse_integer(ptr) * 1024;
-                continue;
-            }
-            pos = line.find(VmSwap);
-            if (pos != std::string::npos){
-                pos += VmSwap.size();
-                const char* ptr = &line[pos];
-                swapped = parse_integer(ptr) * 1024;
-                continue;
-            }
-        }
+    if (status.read()){
+        usage.process_physical_memory = find_proc_value(status, "VmRSS:") * 1024;
+        uint64_t swapped = find_proc_value(status, "VmSwap:") * 1024;
         usage.process_virtual_memory = usage.process_physical_memory + swapped;
     }
 
@@ -15,8 +15,8 @@
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/PanicDump.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
-#include "Common/Cpp/Concurrency/Thread.h"
 #include "StreamInterface.h"
+#include "SerialReactorPOSIX.h"
 
 namespace PokemonAutomation{
 
@@ -24,7 +24,7 @@ void serial_debug_log(const std::string& msg);
 
 
 
-class SerialConnection : public StreamConnection{
+class SerialConnection : public StreamConnection, private SerialReactorListener{
 public:
     //  UTF-8
     SerialConnection(const std::string& name, uint32_t baud_rate)
@@ -42,7 +42,8 @@ public:
         }
 //        std::cout << "desired baud = " << baud << std::endl;
 
-        m_fd = open(name.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
+        //  Non-blocking so that the reactor can drain the port until EAGAIN.
+        m_fd = open(name.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
         if (m_fd == -1){
             int error = errno;
             std::string str = "Unable to open serial connection. Error = " + std::to_string(error);
@@ -122,14 +123,9 @@ public:
             throw ConnectionException(nullptr, "Unable to set output baud rate.");
         }
 
-        //  Start receiver thread.
+        //  Hand the port to the shared reactor thread.
         try{
-            m_listener = Thread([this]{
-                run_with_catch(
-                    "SerialConnection::SerialConnection()",
-                    [this]{ recv_loop(); }
-                );
-            });
+            serial_reactor().add(m_fd, *this);
         }catch (...){
             close(m_fd);
             throw;
@@ -144,8 +140,11 @@ public:
 
     virtual void stop() final{
         m_exit.store(true, std::memory_order_release);
+
+        //  Remove from the reactor before closing so the fd can't be reused
+        //  out from under a running callback.
+        serial_reactor().remove(m_fd);
         close(m_fd);
-        m_listener.join();
     }
 
 private:
@@ -154,23 +153,34 @@ private:
         bytes = write(m_fd, data, bytes);
     }
 
-    void recv_loop(){
-        char buffer[32];
+    //  Called on the reactor thread when data is ready.
+    virtual void on_readable() override{
         while (!m_exit.load(std::memory_order_acquire)){
-            ssize_t actual = read(m_fd, buffer, sizeof(buffer));
+            ssize_t actual = read(m_fd, m_recv_buffer, sizeof(m_recv_buffer));
             if (actual > 0){
-                on_recv(buffer, actual);
+                on_recv(m_recv_buffer, actual);
+                continue;
+            }
+            if (actual < 0 && errno == EINTR){
+                continue;
             }
+            //  EAGAIN (drained) or EOF. Go back to sleep.
+            return;
         }
     }
-    
+    virtual void on_hangup() override{
+        serial_debug_log("SerialConnection: Device has disconnected.");
+    }
+
 
 
 private:
     int m_fd;
     std::atomic<bool> m_exit;
     SpinLock m_send_lock;
-    Thread m_listener;
+
+    //  Only touched by the reactor thread.
+    char m_recv_buffer[4096];
 };
 
 
@@ -0,0 +1,243 @@
+/*  Serial Reactor for POSIX
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef _WIN32
+
+#include <vector>
+#include <algorithm>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/select.h>
+#include <sys/ioctl.h>
+#endif
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PanicDump.h"
+#include "SerialReactorPOSIX.h"
+
+namespace PokemonAutomation{
+
+void serial_debug_log(const std::string& msg);
+
+
+//  Set while the reactor thread is running a listener callback. Lets remove()
+//  be called from inside a callback without deadlocking on itself.
+static thread_local bool t_in_reactor_callback = false;
+
+
+
+#if defined(__APPLE__)
+//  macOS poll() does not support tty devices. It returns POLLNVAL for every
+//  /dev/cu.* port. So use select() there and fill in "revents" the same way
+//  poll() would.
+//
+//  select() reports a hung up tty as readable forever. Catch that by checking
+//  whether there is actually anything to read.
+static int wait_for_events(std::vector<pollfd>& fds){
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    int max_fd = -1;
+    for (pollfd& entry : fds){
+        entry.revents = 0;
+        if (entry.fd >= FD_SETSIZE){
+            entry.revents = POLLNVAL;
+            continue;
+        }
+        FD_SET(entry.fd, &read_set);
+        max_fd = std::max(max_fd, entry.fd);
+    }
+
+    int ready = select(max_fd + 1, &read_set, nullptr, nullptr, nullptr);
+    if (ready < 0){
+        return ready;
+    }
+
+    ready = 0;
+    for (size_t c = 0; c < fds.size(); c++){
+        pollfd& entry = fds[c];
+        if (entry.revents == 0 && FD_ISSET(entry.fd, &read_set)){
+            entry.revents = POLLIN;
+            int bytes = 0;
+            if (c != 0 && (ioctl(entry.fd, FIONREAD, &bytes) < 0 || bytes == 0)){
+                entry.revents |= POLLHUP;
+            }
+        }
+        if (entry.revents != 0){
+            ready++;
+        }
+    }
+    return ready;
+}
+#else
+static int wait_for_events(std::vector<pollfd>& fds){
+    return poll(fds.data(), (nfds_t)fds.size(), -1);
+}
+#endif
+
+
+
+SerialReactor::~SerialReactor(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopped = true;
+    }
+    wake();
+    m_thread.join();
+    close(m_wake_pipe[0]);
+    close(m_wake_pipe[1]);
+}
+SerialReactor::SerialReactor(){
+    if (pipe(m_wake_pipe) == -1){
+        int error = errno;
+        throw InternalSystemError(nullptr, PA_CURRENT_FUNCTION, "pipe() failed. Error = " + std::to_string(error));
+    }
+    for (int fd : m_wake_pipe){
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    try{
+        m_thread = Thread([this]{
+            run_with_catch(
+                "SerialReactor::SerialReactor()",
+                [this]{ thread_body(); }
+            );
+        });
+    }catch (...){
+        close(m_wake_pipe[0]);
+        close(m_wake_pipe[1]);
+        throw;
+    }
+}
+
+
+void SerialReactor::add(int fd, SerialReactorListener& listener){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_listeners[fd] = Entry{&listener, false};
+        m_version++;
+    }
+    wake();
+}
+void SerialReactor::remove(int fd){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        if (m_listeners.erase(fd) == 0){
+            return;
+        }
+        m_version++;
+    }
+    wake();
+
+    //  Wait out any callback that may be running on this listener.
+    if (!t_in_reactor_callback){
+        std::lock_guard<std::mutex> lg(m_dispatch_lock);
+    }
+}
+void SerialReactor::wake(){
+    char ch = 0;
+    ssize_t bytes = write(m_wake_pipe[1], &ch, 1);
+    (void)bytes;    //  If the pipe is full, the reactor is already awake.
+}
+
+
+void SerialReactor::thread_body(){
+    std::vector<pollfd> fds;
+    uint64_t version = (uint64_t)0 - 1;
+
+    while (true){
+        //  Rebuild the poll set only if it has changed.
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            if (m_stopped){
+                return;
+            }
+            if (version != m_version){
+                version = m_version;
+                fds.clear();
+                fds.emplace_back(pollfd{m_wake_pipe[0], POLLIN, 0});
+                for (const auto& item : m_listeners){
+                    if (!item.second.hung_up){
+                        fds.emplace_back(pollfd{item.first, POLLIN, 0});
+                    }
+                }
+            }
+        }
+
+        int ready = wait_for_events(fds);
+        if (ready < 0){
+            int error = errno;
+            if (error != EINTR){
+                serial_debug_log("SerialReactor: Waiting for events failed. Error = " + std::to_string(error));
+            }
+            continue;
+        }
+
+        if (fds[0].revents != 0){
+            char buffer[64];
+            while (read(m_wake_pipe[0], buffer, sizeof(buffer)) > 0);
+        }
+
+        for (size_t c = 1; c < fds.size() && ready > 0; c++){
+            pollfd& entry = fds[c];
+            short revents = entry.revents;
+            if (revents == 0){
+                continue;
+            }
+            ready--;
+
+            std::lock_guard<std::mutex> dlg(m_dispatch_lock);
+
+            //  The listener may have been removed (and the fd even reused)
+            //  since poll() returned. Always dispatch to the current owner.
+            SerialReactorListener* listener;
+            bool hung_up = revents & (POLLHUP | POLLERR | POLLNVAL);
+            {
+                std::lock_guard<std::mutex> lg(m_lock);
+                auto iter = m_listeners.find(entry.fd);
+                if (iter == m_listeners.end() || iter->second.hung_up){
+                    continue;
+                }
+                listener = iter->second.listener;
+                if (hung_up){
+                    //  Stop polling it. Otherwise poll() will return
+                    //  immediately forever.
+                    iter->second.hung_up = true;
+                    m_version++;
+                }
+            }
+
+            t_in_reactor_callback = true;
+            try{
+                if (revents & POLLIN){
+                    listener->on_readable();
+                }
+                if (hung_up){
+                    listener->on_hangup();
+                }
+            }catch (Exception& e){
+                serial_debug_log("SerialReactor: Listener threw an exception: " + e.to_str());
+            }catch (std::exception& e){
+                serial_debug_log(std::string("SerialReactor: Listener threw an exception: ") + e.what());
+            }catch (...){
+                serial_debug_log("SerialReactor: Listener threw an exception.");
+            }
+            t_in_reactor_callback = false;
+        }
+    }
+}
+
+
+
+SerialReactor& serial_reactor(){
+    static SerialReactor reactor;
+    return reactor;
+}
+
+
+
+}
+#endif
@@ -0,0 +1,80 @@
+/*  Serial Reactor for POSIX
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      A single process-wide thread that sleeps in poll() (select() on macOS)
+ *  on every open serial port and dispatches to the owning connection when data is ready.
+ *
+ *  This replaces the old model of one thread per connection spinning on a
+ *  non-blocking read(). With N controllers attached, we now have exactly one
+ *  thread that is asleep whenever the wires are quiet.
+ *
+ */
+
+#ifndef PokemonAutomation_SerialReactorPOSIX_H
+#define PokemonAutomation_SerialReactorPOSIX_H
+
+#include <map>
+#include <mutex>
+#include "Common/Cpp/Concurrency/Thread.h"
+
+namespace PokemonAutomation{
+
+
+
+struct SerialReactorListener{
+    //  Called from the reactor thread when the fd is readable. The listener
+    //  should drain the fd until EAGAIN.
+    virtual void on_readable() = 0;
+
+    //  Called from the reactor thread when the fd has hung up or errored.
+    //  The fd will no longer be polled until it is removed and re-added.
+    virtual void on_hangup(){}
+};
+
+
+class SerialReactor{
+public:
+    ~SerialReactor();
+    SerialReactor();
+
+    //  Start watching "fd". The fd must be non-blocking.
+    void add(int fd, SerialReactorListener& listener);
+
+    //  Stop watching "fd". When this function returns, the listener is
+    //  guaranteed not to be running and will never be called again.
+    //  (unless this is called from inside the listener itself)
+    void remove(int fd);
+
+private:
+    void wake();
+    void thread_body();
+
+private:
+    int m_wake_pipe[2];
+    bool m_stopped = false;
+
+    struct Entry{
+        SerialReactorListener* listener;
+        bool hung_up;
+    };
+
+    //  Protects "m_listeners", "m_version" and "m_stopped".
+    std::mutex m_lock;
+    std::map<int, Entry> m_listeners;
+    uint64_t m_version = 0;
+
+    //  Held by the reactor thread while it is running a callback.
+    std::mutex m_dispatch_lock;
+
+    Thread m_thread;
+};
+
+
+//  The process-wide reactor. Constructed on first use.
+SerialReactor& serial_reactor();
+
+
+
+}
+#endif
@@ -36,6 +36,10 @@ public:
 
         //  Called when the socket receives data from the server.
         virtual void on_receive_data(const void* data, size_t bytes){}
+
+        //  Called when an established connection is lost. The receiver
+        //  thread exits afterwards.
+        virtual void on_disconnect(const std::string& error_message){}
     };
 
     void add_listener(Listener& listener){
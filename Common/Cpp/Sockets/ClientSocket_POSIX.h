@@ -14,7 +14,9 @@
 #include <condition_variable>
 #include <sys/socket.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include "Common/Cpp/Concurrency/Thread.h"
@@ -30,6 +32,10 @@ public:
         : m_socket(socket(AF_INET, SOCK_STREAM, 0))
     {
         fcntl(m_socket, F_SETFL, O_NONBLOCK);
+
+        //  Commands are tiny and latency sensitive. Don't let Nagle hold them.
+        int no_delay = 1;
+        setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
     }
 
     virtual ~ClientSocket_POSIX(){
@@ -199,25 +205,44 @@ Connected:
                 continue;
             }
 
-            std::unique_lock<std::mutex> lg(m_lock);
-            if (state() == State::DESTRUCTING){
-                return;
-            }
+            {
+                std::unique_lock<std::mutex> lg(m_lock);
+                if (state() == State::DESTRUCTING){
+                    return;
+                }
+
+                if (bytes == 0){
+                    //  The server closed the connection. The socket stays
+                    //  readable from here on, so polling it again would spin.
+                    m_state.store(State::NOT_RUNNING, std::memory_order_relaxed);
+                    m_error = "Connection closed by the server.";
+                    lg.unlock();
+                    m_listeners.run_method(&Listener::on_disconnect, m_error);
+                    return;
+                }
 
-            if (bytes < 0){
 //                cout << "error = " << error << endl;
                 switch (error){
                 case EAGAIN:
 //                case EWOULDBLOCK:
                     break;
                 default:
-                    std::unique_lock<std::mutex> lg(m_lock);
+                    m_state.store(State::NOT_RUNNING, std::memory_order_relaxed);
                     m_error = "POSIX Error Code: " + std::to_string(error);
+                    lg.unlock();
+                    m_listeners.run_method(&Listener::on_disconnect, m_error);
                     return;
                 }
             }
 
-            m_cv.wait_for(lg, std::chrono::milliseconds(1));
+            //  Sleep until there's something to read rather than polling on a
+            //  timer so acks are delivered as soon as they arrive. The timeout
+            //  bounds how long it takes to notice close().
+            pollfd fd;
+            fd.fd = m_socket;
+            fd.events = POLLIN;
+            fd.revents = 0;
+            ::poll(&fd, 1, 1);
         }
 
     }
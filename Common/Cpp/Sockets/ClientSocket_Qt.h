@@ -98,6 +98,7 @@ private:
             &socket, &QTcpSocket::connected,
             &socket, [this]{
 //                cout << "connected()" << endl;
+                m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
                 m_state.store(State::CONNECTED, std::memory_order_release);
                 m_listeners.run_method(&Listener::on_connect_finished, "");
             }
@@ -107,6 +108,7 @@ private:
             &socket, [this]{
                 std::cout << "QTcpSocket::disconnected()" << std::endl;
                 m_state.store(State::DESTRUCTING, std::memory_order_release);
+                m_listeners.run_method(&Listener::on_disconnect, "Connection closed by the server.");
                 quit();
             }
         );
@@ -155,7 +157,8 @@ private:
                     bytes -= current_sent;
                 }
 
-//                m_socket->flush();
+                //  Push it out now instead of waiting for the event loop.
+                m_socket->flush();
 
 //                cout << "internal_send() - exit " << endl;
             }
@@ -31,6 +31,10 @@ public:
             close_socket();
             return;
         }
+
+        //  Commands are tiny and latency sensitive. Don't let Nagle hold them.
+        BOOL no_delay = TRUE;
+        setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&no_delay, sizeof(no_delay));
     }
 
     virtual ~ClientSocket_WinSocket(){
@@ -214,15 +218,25 @@ Connected:
                 return;
             }
 
-            if (bytes == SOCKET_ERROR){
-//                cout << "error = " << error << endl;
-                switch (error){
-                case WSAEWOULDBLOCK:
-                    break;
-                default:
-                    m_error = "WSA Error Code: " + std::to_string(error);
-                    return;
-                }
+            if (bytes == 0){
+                //  The server closed the connection.
+                m_state.store(State::NOT_RUNNING, std::memory_order_relaxed);
+                m_error = "Connection closed by the server.";
+                lg.unlock();
+                m_listeners.run_method(&Listener::on_disconnect, m_error);
+                return;
+            }
+
+//            cout << "error = " << error << endl;
+            switch (error){
+            case WSAEWOULDBLOCK:
+                break;
+            default:
+                m_state.store(State::NOT_RUNNING, std::memory_order_relaxed);
+                m_error = "WSA Error Code: " + std::to_string(error);
+                lg.unlock();
+                m_listeners.run_method(&Listener::on_disconnect, m_error);
+                return;
             }
 
             m_cv.wait_for(lg, std::chrono::milliseconds(1));
@@ -26,6 +26,7 @@
 #include "CommonFramework/AudioPipeline/AudioPipelineOptions.h"
 #include "CommonFramework/VideoPipeline/VideoPipelineOptions.h"
 #include "CommonFramework/ErrorReports/ErrorReports.h"
+#include "CommonFramework/Logging/Logger.h"
 #include "Integrations/DiscordSettingsOption.h"
 //#include "CommonFramework/Environment/Environment.h"
 #include "GlobalSettingsPanel.h"
@@ -102,6 +103,7 @@ GlobalSettings& GlobalSettings::instance(){
 }
 GlobalSettings::~GlobalSettings(){
     ENABLE_LIFETIME_SANITIZER0.remove_listener(*this);
+    LOG_FILE_SIZE_LIMIT.remove_listener(*this);
     OPEN_BASE_FOLDER_BUTTON.remove_listener(static_cast<ButtonListener&>(*this));
 }
 GlobalSettings::GlobalSettings()
@@ -194,6 +196,13 @@ GlobalSettings::GlobalSettings()
         LockMode::UNLOCK_WHILE_RUNNING,
         false
     )
+    , LOG_FILE_SIZE_LIMIT(
+        "<b>Log File Size Limit (MB):</b><br>"
+        "Once the log file would grow past this, it is renamed to \"&lt;name&gt;.log.1\" and a new one is started. "
+        "Zero means no limit.",
+        LockMode::UNLOCK_WHILE_RUNNING,
+        (uint32_t)(LOG_FILE_MAX_BYTES >> 20), 0
+    )
     , SAVE_DEBUG_IMAGES(
         "<b>Save Debug Images:</b><br>"
         "If the program fails to read something when it should succeed, save the image for debugging purposes.",
@@ -214,6 +223,15 @@ GlobalSettings::GlobalSettings()
         LockMode::UNLOCK_WHILE_RUNNING,
         false
     )
+    , SERIAL_INFLIGHT_WINDOW(
+        "<b>Serial Controller In-Flight Window:</b><br>"
+        "The most messages to a serial (PABotBase) controller that may be waiting for an acknowledgement at once. "
+        "Lower values may help with unreliable USB-serial adapters. "
+        "Zero means no limit other than the device's queue size.<br>"
+        "Takes effect the next time the controller connects.",
+        LockMode::UNLOCK_WHILE_RUNNING,
+        0
+    )
     , PERFORMANCE(CONSTRUCT_TOKEN)
     , AUDIO_PIPELINE(CONSTRUCT_TOKEN)
     , VIDEO_PIPELINE(CONSTRUCT_TOKEN)
@@ -264,11 +282,13 @@ GlobalSettings::GlobalSettings()
 
     PA_ADD_STATIC(m_advanced_options);
     PA_ADD_OPTION(LOG_EVERYTHING);
+    PA_ADD_OPTION(LOG_FILE_SIZE_LIMIT);
     PA_ADD_OPTION(SAVE_DEBUG_IMAGES);
     PA_ADD_OPTION(SAVE_DEBUG_VIDEOS_ON_SWITCH);
 //    PA_ADD_OPTION(NAUGHTY_MODE);
 //    PA_ADD_OPTION(HIDE_NOTIF_DISCORD_LINK);
 
+    PA_ADD_OPTION(SERIAL_INFLIGHT_WINDOW);
     PA_ADD_OPTION(PERFORMANCE);
 
     PA_ADD_OPTION(AUDIO_PIPELINE);
@@ -283,6 +303,7 @@ GlobalSettings::GlobalSettings()
     PA_ADD_OPTION(DEVELOPER_TOKEN);
 
     GlobalSettings::on_config_value_changed(this);
+    LOG_FILE_SIZE_LIMIT.add_listener(*this);
     ENABLE_LIFETIME_SANITIZER0.add_listener(*this);
     OPEN_BASE_FOLDER_BUTTON.add_listener(static_cast<ButtonListener&>(*this));
 }
@@ -317,6 +338,11 @@ void GlobalSettings::load_json(const JsonValue& json){
         if (!command_line_tests_setting->read_string(COMMAND_LINE_TEST_FOLDER, "FOLDER")){
             COMMAND_LINE_TEST_FOLDER = "CommandLineTests";
         }
+        command_line_tests_setting->read_integer(COMMAND_LINE_TEST_THREADS, "THREADS");
+        if (!command_line_tests_setting->read_string(COMMAND_LINE_TEST_REPORT, "REPORT")){
+            COMMAND_LINE_TEST_REPORT = "CommandLineTestReport.json";
+        }
+        command_line_tests_setting->read_string(COMMAND_LINE_TEST_BASELINE, "BASELINE");
 
         const JsonArray* test_list = command_line_tests_setting->get_array("TEST_LIST");
         if (test_list){
@@ -363,6 +389,15 @@ void GlobalSettings::load_json(const JsonValue& json){
             }
         }
     }
+
+    const JsonObject* kernel_benchmarks_setting = obj->get_object("KERNEL_BENCHMARKS");
+    if (kernel_benchmarks_setting){
+        kernel_benchmarks_setting->read_boolean(KERNEL_BENCHMARK_MODE, "RUN");
+        if (!kernel_benchmarks_setting->read_string(KERNEL_BENCHMARK_REPORT, "REPORT")){
+            KERNEL_BENCHMARK_REPORT = "KernelBenchmarkReport.json";
+        }
+        kernel_benchmarks_setting->read_string(KERNEL_BENCHMARK_BASELINE, "BASELINE");
+    }
 }
 
 
@@ -373,6 +408,9 @@ JsonValue GlobalSettings::to_json() const{
     JsonObject command_line_test_obj;
     command_line_test_obj["RUN"] = COMMAND_LINE_TEST_MODE;
     command_line_test_obj["FOLDER"] = COMMAND_LINE_TEST_FOLDER;
+    command_line_test_obj["THREADS"] = (int64_t)COMMAND_LINE_TEST_THREADS;
+    command_line_test_obj["REPORT"] = COMMAND_LINE_TEST_REPORT;
+    command_line_test_obj["BASELINE"] = COMMAND_LINE_TEST_BASELINE;
 
     {
         JsonArray test_list;
@@ -392,6 +430,12 @@ JsonValue GlobalSettings::to_json() const{
 
     obj["COMMAND_LINE_TESTS"] = std::move(command_line_test_obj);
 
+    JsonObject kernel_benchmark_obj;
+    kernel_benchmark_obj["RUN"] = KERNEL_BENCHMARK_MODE;
+    kernel_benchmark_obj["REPORT"] = KERNEL_BENCHMARK_REPORT;
+    kernel_benchmark_obj["BASELINE"] = KERNEL_BENCHMARK_BASELINE;
+    obj["KERNEL_BENCHMARKS"] = std::move(kernel_benchmark_obj);
+
     JsonObject debug_obj;
     const auto& debug_settings = PreloadSettings::instance().DEBUG;
     debug_obj["COLOR_CHECK"] = debug_settings.COLOR_CHECK;
@@ -403,6 +447,13 @@ JsonValue GlobalSettings::to_json() const{
 }
 
 void GlobalSettings::on_config_value_changed(void* object){
+    if (object == this || object == &LOG_FILE_SIZE_LIMIT){
+        set_log_file_max_bytes((uint64_t)LOG_FILE_SIZE_LIMIT << 20);
+    }
+    if (object == &LOG_FILE_SIZE_LIMIT){
+        return;
+    }
+
     bool enabled = ENABLE_LIFETIME_SANITIZER0;
     if (enabled){
         global_logger_tagged().log("LifeTime Sanitizer: Enabled", COLOR_BLUE);
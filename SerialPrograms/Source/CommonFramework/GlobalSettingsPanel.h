@@ -13,7 +13,7 @@
 #include "Common/Cpp/Options/StaticTextOption.h"
 #include "Common/Cpp/Options/BooleanCheckBoxOption.h"
 #include "Common/Cpp/Options/ButtonOption.h"
-//#include "Common/Cpp/Options/SimpleIntegerOption.h"
+#include "Common/Cpp/Options/SimpleIntegerOption.h"
 #include "Common/Cpp/Options/StringOption.h"
 #include "CommonFramework/Panels/SettingsPanel.h"
 #include "CommonFramework/Panels/PanelTools.h"
@@ -116,10 +116,12 @@ public:
     SectionDividerOption m_advanced_options;
 
     BooleanCheckBoxOption LOG_EVERYTHING;
+    SimpleIntegerOption<uint32_t> LOG_FILE_SIZE_LIMIT;
     BooleanCheckBoxOption SAVE_DEBUG_IMAGES;
     BooleanCheckBoxOption SAVE_DEBUG_VIDEOS_ON_SWITCH;
 //    BooleanCheckBoxOption NAUGHTY_MODE_OPTION;
     BooleanCheckBoxOption HIDE_NOTIF_DISCORD_LINK;
+    SimpleIntegerOption<uint8_t> SERIAL_INFLIGHT_WINDOW;
 
     Pimpl<PerformanceOptions> PERFORMANCE;
     Pimpl<AudioPipelineOptions> AUDIO_PIPELINE;
@@ -141,6 +143,20 @@ public:
     // Which tests to ignore running under the command line test mode.
     // If a test path appears in both COMMAND_LINE_TEST_LIST and COMMAND_LINE_IGNORE_LIST, it's still ignored.
     std::vector<std::string> COMMAND_LINE_IGNORE_LIST;
+    // How many threads to run the command line tests on. 0 means one per core.
+    size_t COMMAND_LINE_TEST_THREADS = 1;
+    // Where to write the command line test report. Empty means no report.
+    std::string COMMAND_LINE_TEST_REPORT;
+    // A previous report to compare the results against. Empty means no comparison.
+    std::string COMMAND_LINE_TEST_BASELINE;
+
+    // The mode that does not run Qt GUI, but instead benchmarks the kernels
+    // on every CPU tier the machine supports.
+    bool KERNEL_BENCHMARK_MODE = false;
+    // Where to write the kernel benchmark report. Empty means no report.
+    std::string KERNEL_BENCHMARK_REPORT;
+    // A previous kernel benchmark report to compare against. Empty means no comparison.
+    std::string KERNEL_BENCHMARK_BASELINE;
 };
 
 
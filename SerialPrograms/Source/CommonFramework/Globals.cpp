@@ -93,6 +93,7 @@ const std::string COMPILER_VERSION = "Unknown Compiler";
 
 
 const size_t LOG_HISTORY_LINES = 10000;
+const uint64_t LOG_FILE_MAX_BYTES = (uint64_t)64 << 20;
 
 
 namespace{
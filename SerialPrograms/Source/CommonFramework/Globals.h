@@ -13,6 +13,7 @@
 #ifndef PokemonAutomation_Globals_H
 #define PokemonAutomation_Globals_H
 
+#include <stdint.h>
 #include <string>
 
 namespace PokemonAutomation{
@@ -43,6 +44,10 @@ extern const std::string COMPILER_VERSION;
 
 extern const size_t LOG_HISTORY_LINES;
 
+//  Once the log file would grow past this, it is moved aside and a new one
+//  is started. This is the default. It can be changed in the settings.
+extern const uint64_t LOG_FILE_MAX_BYTES;
+
 // Path to the parent folder that holds all other folders, e.g. settings folder, screenshot folder, etc. 
 const std::string& RUNTIME_BASE_PATH();
 
@@ -9,6 +9,7 @@
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "ImageBoxes.h"
+#include "ImageStatsTable.h"
 #include "ImageStats.h"
 
 #include <iostream>
@@ -18,14 +19,22 @@ using std::endl;
 namespace PokemonAutomation{
 
 
-
-FloatPixel image_average(const ImageViewRGB32& image){
-    Kernels::PixelSums sums;
+static void pixel_sums(Kernels::PixelSums& sums, const ImageViewRGB32& image){
+    if (ImageStatsTableScope::try_add_sums(sums, image)){
+        return;
+    }
     Kernels::pixel_sum_sqr(
         sums, image.width(), image.height(),
         image.data(), image.bytes_per_row(),
         image.data(), image.bytes_per_row()
     );
+}
+
+
+
+FloatPixel image_average(const ImageViewRGB32& image){
+    Kernels::PixelSums sums;
+    pixel_sums(sums, image);
 
     FloatPixel sum((double)sums.sumR, (double)sums.sumG, (double)sums.sumB);
 
@@ -33,11 +42,7 @@ FloatPixel image_average(const ImageViewRGB32& image){
 }
 FloatPixel image_stddev(const ImageViewRGB32& image){
     Kernels::PixelSums sums;
-    Kernels::pixel_sum_sqr(
-        sums, image.width(), image.height(),
-        image.data(), image.bytes_per_row(),
-        image.data(), image.bytes_per_row()
-    );
+    pixel_sums(sums, image);
 
     FloatPixel sum((double)sums.sumR, (double)sums.sumG, (double)sums.sumB);
     FloatPixel sqr((double)sums.sqrR, (double)sums.sqrG, (double)sums.sqrB);
@@ -52,11 +57,7 @@ FloatPixel image_stddev(const ImageViewRGB32& image){
 }
 ImageStats image_stats(const ImageViewRGB32& image){
     Kernels::PixelSums sums;
-    Kernels::pixel_sum_sqr(
-        sums, image.width(), image.height(),
-        image.data(), image.bytes_per_row(),
-        image.data(), image.bytes_per_row()
-    );
+    pixel_sums(sums, image);
 
     FloatPixel sum((double)sums.sumR, (double)sums.sumG, (double)sums.sumB);
     FloatPixel sqr((double)sums.sqrR, (double)sums.sqrG, (double)sums.sqrB);
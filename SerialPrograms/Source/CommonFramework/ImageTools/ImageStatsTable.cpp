@@ -0,0 +1,183 @@
+/*  Image Stats Table
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "ImageStatsTable.h"
+
+namespace PokemonAutomation{
+
+
+static void operator+=(Kernels::PixelSums& x, const Kernels::PixelSums& y){
+    x.count += y.count;
+    x.sumR += y.sumR;
+    x.sumG += y.sumG;
+    x.sumB += y.sumB;
+    x.sqrR += y.sqrR;
+    x.sqrG += y.sqrG;
+    x.sqrB += y.sqrB;
+}
+static void operator-=(Kernels::PixelSums& x, const Kernels::PixelSums& y){
+    x.count -= y.count;
+    x.sumR -= y.sumR;
+    x.sumG -= y.sumG;
+    x.sumB -= y.sumB;
+    x.sqrR -= y.sqrR;
+    x.sqrG -= y.sqrG;
+    x.sqrB -= y.sqrB;
+}
+
+
+
+ImageStatsTable::ImageStatsTable(const ImageViewRGB32& image)
+    : m_image(image)
+    , m_tiles_x((image.width() + TILE_SIZE - 1) / TILE_SIZE)
+    , m_tiles_y((image.height() + TILE_SIZE - 1) / TILE_SIZE)
+    , m_prefix((m_tiles_x + 1) * (m_tiles_y + 1))
+{
+    size_t width = image.width();
+    size_t height = image.height();
+    size_t stride = m_tiles_x + 1;
+
+    for (size_t ty = 0; ty < m_tiles_y; ty++){
+        size_t min_y = ty * TILE_SIZE;
+        size_t rows = std::min(TILE_SIZE, height - min_y);
+
+        //  Sums of this tile row so far.
+        Kernels::PixelSums row;
+        for (size_t tx = 0; tx < m_tiles_x; tx++){
+            size_t min_x = tx * TILE_SIZE;
+            size_t cols = std::min(TILE_SIZE, width - min_x);
+            add_direct(row, min_x, min_y, min_x + cols, min_y + rows);
+
+            Kernels::PixelSums& entry = m_prefix[(ty + 1) * stride + tx + 1];
+            entry = m_prefix[ty * stride + tx + 1];
+            entry += row;
+        }
+    }
+}
+
+void ImageStatsTable::add_direct(
+    Kernels::PixelSums& sums,
+    size_t min_x, size_t min_y,
+    size_t max_x, size_t max_y
+) const{
+    if (min_x >= max_x || min_y >= max_y){
+        return;
+    }
+    const uint32_t* ptr = (const uint32_t*)((const char*)m_image.data() + min_y * m_image.bytes_per_row()) + min_x;
+    Kernels::pixel_sum_sqr(
+        sums, max_x - min_x, max_y - min_y,
+        ptr, m_image.bytes_per_row(),
+        ptr, m_image.bytes_per_row()
+    );
+}
+
+void ImageStatsTable::add_sums(
+    Kernels::PixelSums& sums,
+    size_t min_x, size_t min_y,
+    size_t max_x, size_t max_y
+) const{
+    //  Range of tiles that lie entirely inside the box. The last tile in each
+    //  direction may be short, so it counts as covered if the box reaches the
+    //  edge of the image.
+    size_t tx0 = (min_x + TILE_SIZE - 1) / TILE_SIZE;
+    size_t ty0 = (min_y + TILE_SIZE - 1) / TILE_SIZE;
+    size_t tx1 = max_x >= m_image.width()  ? m_tiles_x : max_x / TILE_SIZE;
+    size_t ty1 = max_y >= m_image.height() ? m_tiles_y : max_y / TILE_SIZE;
+    if (tx0 >= tx1 || ty0 >= ty1){
+        add_direct(sums, min_x, min_y, max_x, max_y);
+        return;
+    }
+
+    sums += prefix(tx1, ty1);
+    sums -= prefix(tx0, ty1);
+    sums -= prefix(tx1, ty0);
+    sums += prefix(tx0, ty0);
+
+    //  Now the strips around the covered tiles.
+    size_t x0 = tx0 * TILE_SIZE;
+    size_t y0 = ty0 * TILE_SIZE;
+    size_t x1 = std::min(tx1 * TILE_SIZE, max_x);
+    size_t y1 = std::min(ty1 * TILE_SIZE, max_y);
+    add_direct(sums, min_x, min_y, max_x, y0);     //  Top
+    add_direct(sums, min_x, y1, max_x, max_y);     //  Bottom
+    add_direct(sums, min_x, y0, x0, y1);           //  Left
+    add_direct(sums, x1, y0, max_x, y1);           //  Right
+}
+
+
+
+const ImageStatsTable* ImageStatsTableCache::get(const ImageViewRGB32& image, size_t pixels){
+    if (!m_ready.load(std::memory_order_acquire)){
+        size_t scanned = m_scanned_pixels.fetch_add(pixels, std::memory_order_relaxed) + pixels;
+        if (scanned < image.total_pixels()){
+            return nullptr;
+        }
+        std::call_once(m_once, [&]{
+            m_table.reset(new ImageStatsTable(image));
+            m_ready.store(true, std::memory_order_release);
+        });
+    }
+    return m_table.get();
+}
+
+
+
+static thread_local ImageStatsTableScope* t_image_stats_scope = nullptr;
+
+ImageStatsTableScope::ImageStatsTableScope(const ImageViewRGB32& image, ImageStatsTableCache& cache)
+    : m_image(image)
+    , m_cache(cache)
+    , m_previous(t_image_stats_scope)
+{
+    t_image_stats_scope = this;
+}
+ImageStatsTableScope::~ImageStatsTableScope(){
+    t_image_stats_scope = m_previous;
+}
+
+bool ImageStatsTableScope::try_add_sums(Kernels::PixelSums& sums, const ImageViewRGB32& view){
+    //  Small boxes are cheaper to scan than to look up. And if nothing else
+    //  on this frame needs the table, we'd rather not build it for them.
+    constexpr size_t MIN_SIDE = 4 * ImageStatsTable::TILE_SIZE;
+    if (view.width() < MIN_SIDE || view.height() < MIN_SIDE){
+        return false;
+    }
+
+    for (ImageStatsTableScope* scope = t_image_stats_scope; scope != nullptr; scope = scope->m_previous){
+        const ImageViewRGB32& image = scope->m_image;
+        if (view.bytes_per_row() != image.bytes_per_row()){
+            continue;
+        }
+        const char* base = (const char*)image.data();
+        const char* ptr = (const char*)view.data();
+        if (ptr < base){
+            continue;
+        }
+        size_t offset = ptr - base;
+        size_t y = offset / image.bytes_per_row();
+        size_t x_bytes = offset % image.bytes_per_row();
+        if (x_bytes % sizeof(uint32_t) != 0){
+            continue;
+        }
+        size_t x = x_bytes / sizeof(uint32_t);
+        if (x + view.width() > image.width() || y + view.height() > image.height()){
+            continue;
+        }
+
+        const ImageStatsTable* table = scope->m_cache.get(image, view.total_pixels());
+        if (table == nullptr){
+            return false;
+        }
+        table->add_sums(sums, x, y, x + view.width(), y + view.height());
+        return true;
+    }
+    return false;
+}
+
+
+
+}
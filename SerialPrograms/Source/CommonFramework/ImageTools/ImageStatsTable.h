@@ -0,0 +1,114 @@
+/*  Image Stats Table
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Precomputed pixel sums for an entire frame so that the stats of any
+ *  box on it can be answered without rescanning the box.
+ *
+ *  The table stores 2D prefix sums over 16x16 tiles. A box query takes the
+ *  fully covered tiles from the table and only scans the partial tiles along
+ *  its edges. Results are exactly the same as scanning the whole box.
+ *
+ *  A per-pixel table would make queries O(1), but would need ~80MB for a
+ *  1080p frame. The tiled table is ~450KB.
+ *
+ *  Building the table costs about one pass over the frame. So it is only
+ *  built once the boxes scanned on a frame add up to the area of the frame.
+ *  Frames that only check a box or two never pay for it.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ImageStatsTable_H
+#define PokemonAutomation_CommonFramework_ImageStatsTable_H
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqr.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+
+namespace PokemonAutomation{
+
+
+
+class ImageStatsTable{
+public:
+    static constexpr size_t TILE_SIZE = 16;
+
+    //  "image" must outlive this table.
+    ImageStatsTable(const ImageViewRGB32& image);
+
+    const ImageViewRGB32& image() const{ return m_image; }
+
+    //  Add the sums of the pixel box [min_x, max_x) x [min_y, max_y) into
+    //  "sums". Pixels with alpha < 128 are ignored.
+    void add_sums(
+        Kernels::PixelSums& sums,
+        size_t min_x, size_t min_y,
+        size_t max_x, size_t max_y
+    ) const;
+
+private:
+    const Kernels::PixelSums& prefix(size_t tile_x, size_t tile_y) const{
+        return m_prefix[tile_y * (m_tiles_x + 1) + tile_x];
+    }
+    void add_direct(
+        Kernels::PixelSums& sums,
+        size_t min_x, size_t min_y,
+        size_t max_x, size_t max_y
+    ) const;
+
+private:
+    ImageViewRGB32 m_image;
+    size_t m_tiles_x;
+    size_t m_tiles_y;
+
+    //  (m_tiles_y + 1) x (m_tiles_x + 1). Entry (x, y) is the sum of all
+    //  tiles above and to the left of it.
+    std::vector<Kernels::PixelSums> m_prefix;
+};
+
+
+
+//  Builds the table for an image once it is worth it and shares it with
+//  everyone else who asks. Thread-safe.
+class ImageStatsTableCache{
+public:
+    //  Returns null if the caller should scan the "pixels" it wants directly.
+    const ImageStatsTable* get(const ImageViewRGB32& image, size_t pixels);
+
+private:
+    std::atomic<size_t> m_scanned_pixels{0};
+    std::atomic<bool> m_ready{false};
+    std::once_flag m_once;
+    std::unique_ptr<ImageStatsTable> m_table;
+};
+
+
+
+//  While alive, image_average(), image_stddev() and image_stats() on this
+//  thread use the table from "cache" for any view that lies inside "image".
+//  Views into anything else are scanned as usual.
+class ImageStatsTableScope{
+public:
+    ImageStatsTableScope(const ImageViewRGB32& image, ImageStatsTableCache& cache);
+    ~ImageStatsTableScope();
+
+    ImageStatsTableScope(const ImageStatsTableScope&) = delete;
+    void operator=(const ImageStatsTableScope&) = delete;
+
+    //  If "view" can be served by a table bound to this thread, add its sums
+    //  into "sums" and return true.
+    static bool try_add_sums(Kernels::PixelSums& sums, const ImageViewRGB32& view);
+
+private:
+    ImageViewRGB32 m_image;
+    ImageStatsTableCache& m_cache;
+    ImageStatsTableScope* m_previous;
+};
+
+
+
+}
+#endif
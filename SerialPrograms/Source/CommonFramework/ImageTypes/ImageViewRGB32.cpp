@@ -7,6 +7,7 @@
 #include <QImage>
 #include <opencv2/core/mat.hpp>
 #include "Common/Cpp/Exceptions.h"
+#include "Kernels/ImageScale/Kernels_ImageScale.h"
 #include "ImageRGB32.h"
 #include "ImageViewRGB32.h"
 
@@ -26,8 +27,43 @@ ImageRGB32 ImageViewRGB32::copy() const{
 bool ImageViewRGB32::save(const std::string& path) const{
     return to_QImage_ref().save(QString::fromStdString(path));
 }
-ImageRGB32 ImageViewRGB32::scale_to(size_t width, size_t height) const{
-    return scaled_to_QImage(width, height);
+ImageRGB32 ImageViewRGB32::scale_to(size_t width, size_t height, ImageScaleMode mode) const{
+    if (m_ptr == nullptr){
+        return ImageRGB32();
+    }
+    ImageRGB32 ret(width, height);
+    scale_to(ret, mode);
+    return ret;
+}
+void ImageViewRGB32::scale_to(ImageRGB32& out, ImageScaleMode mode) const{
+    if (m_ptr == nullptr || !out){
+        return;
+    }
+    if (m_width == out.width() && m_height == out.height()){
+        out.copy_from(*this);
+        return;
+    }
+    switch (mode){
+    case ImageScaleMode::NEAREST:
+        Kernels::scale_nearest(
+            m_ptr, m_bytes_per_row, m_width, m_height,
+            out.data(), out.bytes_per_row(), out.width(), out.height()
+        );
+        return;
+    case ImageScaleMode::BILINEAR:
+        Kernels::scale_bilinear(
+            m_ptr, m_bytes_per_row, m_width, m_height,
+            out.data(), out.bytes_per_row(), out.width(), out.height()
+        );
+        return;
+    case ImageScaleMode::AREA:
+        Kernels::scale_area(
+            m_ptr, m_bytes_per_row, m_width, m_height,
+            out.data(), out.bytes_per_row(), out.width(), out.height()
+        );
+        return;
+    }
+    throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid scale mode.");
 }
 
 
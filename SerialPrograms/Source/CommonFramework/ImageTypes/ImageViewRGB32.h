@@ -21,6 +21,13 @@ namespace PokemonAutomation{
 class ImageRGB32;
 
 
+enum class ImageScaleMode{
+    NEAREST,    //  Fastest. Takes the pixel under each output pixel's center.
+    BILINEAR,   //  Smooth. Best for upscaling or mild downscaling.
+    AREA,       //  Averages each output pixel's box. Best for large downscaling.
+};
+
+
 class ImageViewRGB32 : public ImageViewPlanar32{
 public:
     using ImageViewPlanar32::ImageViewPlanar32;
@@ -47,7 +54,11 @@ public:
 public:
     ImageRGB32 copy() const;
     bool save(const std::string& path) const;
-    ImageRGB32 scale_to(size_t width, size_t height) const;
+    ImageRGB32 scale_to(size_t width, size_t height, ImageScaleMode mode = ImageScaleMode::NEAREST) const;
+
+    //  Scale this image into "out", reusing its buffer. The output size is
+    //  the size of "out".
+    void scale_to(ImageRGB32& out, ImageScaleMode mode = ImageScaleMode::NEAREST) const;
 
 public:
     //  QImage
@@ -4,9 +4,11 @@
  *
  */
 
+#include <algorithm>
 #include <QCoreApplication>
 #include <QMenuBar>
 #include <QDir>
+#include "Common/Cpp/Time.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Windows/DpiScaler.h"
@@ -22,10 +24,30 @@
 namespace PokemonAutomation{
 
 
-Logger& global_logger_raw(){
-    static FileWindowLogger logger(USER_FILE_PATH() + (QCoreApplication::applicationName() + ".log").toStdString());
+//  Unwritten log text is written out once there is this much of it or once
+//  the oldest line in it is this old.
+const size_t LOG_FILE_WRITE_BYTES = 64 * 1024;
+const std::chrono::milliseconds LOG_FILE_WRITE_INTERVAL(100);
+
+//  Lines kept for windows that were hidden when they were logged.
+//  Matches the line limit of the window itself.
+const size_t LOG_WINDOW_HISTORY_LINES = 1000;
+
+
+
+static FileWindowLogger& global_file_window_logger(){
+    static FileWindowLogger logger(
+        USER_FILE_PATH() + (QCoreApplication::applicationName() + ".log").toStdString(),
+        LOG_FILE_MAX_BYTES
+    );
     return logger;
 }
+Logger& global_logger_raw(){
+    return global_file_window_logger();
+}
+void set_log_file_max_bytes(uint64_t max_file_bytes){
+    global_file_window_logger().set_max_file_bytes(max_file_bytes);
+}
 
 
 void LastLogTracker::operator+=(std::string line){
@@ -47,17 +69,15 @@ FileWindowLogger::~FileWindowLogger(){
     }
     m_thread.join();
 }
-FileWindowLogger::FileWindowLogger(const std::string& path)
+FileWindowLogger::FileWindowLogger(const std::string& path, uint64_t max_file_bytes)
     : m_file(QString::fromStdString(path))
+    , m_max_file_bytes(max_file_bytes)
+    , m_file_bytes(0)
     , m_max_queue_size(LOG_HISTORY_LINES)
     , m_stopping(false)
+    , m_window_history_end(0)
 {
-    bool exists = m_file.exists();
-    bool opened = m_file.open(QIODevice::WriteOnly | QIODevice::Append);
-    if (!exists && opened){
-        std::string bom = "\xef\xbb\xbf";
-        m_file.write(bom.c_str(), bom.size());
-    }
+    open_file();
 
     m_thread = Thread([this]{
         thread_loop();
@@ -65,14 +85,38 @@ FileWindowLogger::FileWindowLogger(const std::string& path)
 }
 void FileWindowLogger::operator+=(FileWindowLoggerWindow& widget){
 //    auto scope_check = m_sanitizer.check_scope();
-    std::lock_guard<std::mutex> lg(m_lock);
+    std::lock_guard<std::mutex> lg(m_window_lock);
+    widget.m_log_position = m_window_history_end;
     m_windows.insert(&widget);
 }
 void FileWindowLogger::operator-=(FileWindowLoggerWindow& widget){
 //    auto scope_check = m_sanitizer.check_scope();
-    std::lock_guard<std::mutex> lg(m_lock);
+    std::lock_guard<std::mutex> lg(m_window_lock);
     m_windows.erase(&widget);
 }
+void FileWindowLogger::on_window_shown(FileWindowLoggerWindow& widget){
+    std::lock_guard<std::mutex> lg(m_window_lock);
+    widget.m_visible = true;
+
+    uint64_t history_start = m_window_history_end - m_window_history.size();
+    uint64_t start = std::max(widget.m_log_position, history_start);
+    widget.m_log_position = m_window_history_end;
+    if (start == m_window_history_end){
+        return;
+    }
+
+    QStringList lines;
+    lines.reserve((qsizetype)(m_window_history_end - start));
+    for (uint64_t c = start; c < m_window_history_end; c++){
+        const Line& line = m_window_history[(size_t)(c - history_start)];
+        lines.append(to_window_str(normalize_newlines(line.first), line.second));
+    }
+    widget.log_lines(std::move(lines));
+}
+void FileWindowLogger::on_window_hidden(FileWindowLoggerWindow& widget){
+    std::lock_guard<std::mutex> lg(m_window_lock);
+    widget.m_visible = false;
+}
 
 void FileWindowLogger::log(const std::string& msg, Color color){
 //    auto scope_check = m_sanitizer.check_scope();
@@ -95,6 +139,9 @@ std::vector<std::string> FileWindowLogger::get_last() const{
     std::unique_lock<std::mutex> lg(m_lock);
     return m_last_log_tracker.snapshot();
 }
+void FileWindowLogger::set_max_file_bytes(uint64_t max_file_bytes){
+    m_max_file_bytes.store(max_file_bytes, std::memory_order_relaxed);
+}
 
 
 std::string FileWindowLogger::normalize_newlines(const std::string& msg){
@@ -119,22 +166,19 @@ std::string FileWindowLogger::normalize_newlines(const std::string& msg){
 
     return str;
 }
-std::string FileWindowLogger::to_file_str(const std::string& msg){
+void FileWindowLogger::append_file_str(std::string& buffer, const std::string& msg){
     //  Replace all newlines with:
     //      <br>    for the output window.
     //      \r\n    for the log file.
 
-    std::string str;
     for (char ch : msg){
         if (ch == '\n'){
-            str += "\r\n";
+            buffer += "\r\n";
             continue;
         }
-        str += ch;
+        buffer += ch;
     }
-    str += "\r\n";
-
-    return str;
+    buffer += "\r\n";
 }
 QString FileWindowLogger::to_window_str(const std::string& msg, Color color){
     //  Replace all newlines with:
@@ -164,43 +208,131 @@ QString FileWindowLogger::to_window_str(const std::string& msg, Color color){
 
     return QString::fromStdString(str);
 }
-void FileWindowLogger::internal_log(const std::string& msg, Color color){
-//    auto scope_check = m_sanitizer.check_scope();
-    std::string line = normalize_newlines(msg);
+void FileWindowLogger::open_file(){
+    bool exists = m_file.exists();
+    bool opened = m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+    if (!exists && opened){
+        std::string bom = "\xef\xbb\xbf";
+        m_file.write(bom.c_str(), bom.size());
+    }
+    m_file_bytes = opened ? m_file.size() : 0;
+}
+void FileWindowLogger::rotate_file(){
+    QString path = m_file.fileName();
+    QString old_path = path + ".1";
+    m_file.close();
+    QFile::remove(old_path);
+    QFile::rename(path, old_path);
+    open_file();
+}
+void FileWindowLogger::write_file(){
+    if (m_file_buffer.empty()){
+        return;
+    }
+    uint64_t max_file_bytes = m_max_file_bytes.load(std::memory_order_relaxed);
+    if (max_file_bytes != 0 &&
+        m_file_bytes > 0 &&
+        m_file_bytes + m_file_buffer.size() > max_file_bytes
+    ){
+        rotate_file();
+    }
+    m_file.write(m_file_buffer.data(), m_file_buffer.size());
+    m_file.flush();
+    m_file_bytes += m_file_buffer.size();
+    m_file_buffer.clear();
+}
+void FileWindowLogger::send_to_windows(const std::deque<Line>& lines){
+    auto format = [&]{
+        QStringList formatted;
+        formatted.reserve((qsizetype)lines.size());
+        for (const Line& line : lines){
+            formatted.append(to_window_str(normalize_newlines(line.first), line.second));
+        }
+        return formatted;
+    };
+
+    bool any_visible = false;
     {
-        if (!m_windows.empty()){
-            QString str = to_window_str(line, color);
-            for (FileWindowLoggerWindow* window : m_windows){
-                window->log(str);
-            }
+        std::lock_guard<std::mutex> lg(m_window_lock);
+        for (FileWindowLoggerWindow* window : m_windows){
+            any_visible |= window->m_visible;
         }
     }
-    {
-        m_file.write(to_file_str(msg).c_str());
-        m_file.flush();
+
+    //  Only pay for formatting when someone will see it. Do it with no locks
+    //  held. QStrings are shared, so every window gets these same copies.
+    QStringList formatted;
+    if (any_visible){
+        formatted = format();
+    }
+
+    std::lock_guard<std::mutex> lg(m_window_lock);
+    m_window_history.insert(m_window_history.end(), lines.begin(), lines.end());
+    while (m_window_history.size() > LOG_WINDOW_HISTORY_LINES){
+        m_window_history.pop_front();
+    }
+    m_window_history_end += lines.size();
+
+    //  Hidden windows will catch up from the history when they are shown.
+    for (FileWindowLoggerWindow* window : m_windows){
+        if (!window->m_visible){
+            continue;
+        }
+        //  A window was shown since the check above.
+        if (!any_visible){
+            formatted = format();
+            any_visible = true;
+        }
+        window->log_lines(formatted);
+        window->m_log_position = m_window_history_end;
     }
 }
 void FileWindowLogger::thread_loop(){
 //    auto scope_check = m_sanitizer.check_scope();
+    std::deque<Line> batch;
+    WallClock write_deadline = WallClock::max();
+
     std::unique_lock<std::mutex> lg(m_lock);
     while (true){
-        m_cv.wait(lg, [&]{
+        auto ready = [&]{
             return m_stopping || !m_queue.empty();
-        });
-        if (m_stopping){
-            break;
+        };
+        if (m_file_buffer.empty()){
+            m_cv.wait(lg, ready);
+        }else{
+            m_cv.wait_until(lg, write_deadline, ready);
         }
-        auto& item = m_queue.front();
-        std::string msg = std::move(item.first);
-        Color color = item.second;
-        m_queue.pop_front();
+
+        //  Take everything that's queued at once. Anything still queued when
+        //  stopping is drained instead of dropped.
+        bool stopping = m_stopping;
+        batch.swap(m_queue);
+        m_cv.notify_all();
 
         lg.unlock();
-        internal_log(msg, color);
-        lg.lock();
 
-        if (m_queue.size() <= m_max_queue_size / 2){
-            m_cv.notify_all();
+        if (!batch.empty()){
+            if (m_file_buffer.empty()){
+                write_deadline = current_time() + LOG_FILE_WRITE_INTERVAL;
+            }
+            for (const Line& line : batch){
+                append_file_str(m_file_buffer, line.first);
+            }
+            send_to_windows(batch);
+        }
+        batch.clear();
+
+        if (stopping ||
+            m_file_buffer.size() >= LOG_FILE_WRITE_BYTES ||
+            current_time() >= write_deadline
+        ){
+            write_file();
+            write_deadline = WallClock::max();
+        }
+
+        lg.lock();
+        if (stopping && m_queue.empty()){
+            break;
         }
     }
 }
@@ -234,7 +366,7 @@ FileWindowLoggerWindow::FileWindowLoggerWindow(FileWindowLogger& logger, QWidget
 
     m_text->setReadOnly(true);
     m_text->setAcceptRichText(true);
-    m_text->document()->setMaximumBlockCount(1000);
+    m_text->document()->setMaximumBlockCount((int)LOG_WINDOW_HISTORY_LINES);
 
     connect(
         this, &FileWindowLoggerWindow::signal_log,
@@ -243,6 +375,17 @@ FileWindowLoggerWindow::FileWindowLoggerWindow(FileWindowLogger& logger, QWidget
             m_text->append(msg);
         }
     );
+    //  Always queued so that lines sent when the window is shown land after
+    //  any that were already on their way.
+    connect(
+        this, &FileWindowLoggerWindow::signal_log_lines,
+        m_text, [this](QStringList lines){
+            for (const QString& line : lines){
+                m_text->append(line);
+            }
+        },
+        Qt::QueuedConnection
+    );
 
     GlobalSettings::instance().LOG_WINDOW_SIZE->WIDTH.add_listener(*this);
     GlobalSettings::instance().LOG_WINDOW_SIZE->HEIGHT.add_listener(*this);
@@ -271,6 +414,9 @@ void FileWindowLoggerWindow::log(QString msg){
 //    cout << "FileWindowLoggerWindow::log(): " << msg.toStdString() << endl;
     emit signal_log(msg);
 }
+void FileWindowLoggerWindow::log_lines(QStringList lines){
+    emit signal_log_lines(std::move(lines));
+}
 
 void FileWindowLoggerWindow::resizeEvent(QResizeEvent* event){
     m_pending_resize = true;
@@ -286,6 +432,15 @@ void FileWindowLoggerWindow::moveEvent(QMoveEvent* event){
     m_pending_move = false;
 }
 
+void FileWindowLoggerWindow::showEvent(QShowEvent* event){
+    QMainWindow::showEvent(event);
+    m_logger.on_window_shown(*this);
+}
+void FileWindowLoggerWindow::hideEvent(QHideEvent* event){
+    QMainWindow::hideEvent(event);
+    m_logger.on_window_hidden(*this);
+}
+
 void FileWindowLoggerWindow::on_config_value_changed(void* object){
     if (object == &GlobalSettings::instance().LOG_WINDOW_SIZE->WIDTH || object == &GlobalSettings::instance().LOG_WINDOW_SIZE->HEIGHT){
         QMetaObject::invokeMethod(this, [this]{
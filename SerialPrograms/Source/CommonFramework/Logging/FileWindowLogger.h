@@ -9,9 +9,11 @@
 
 #include <deque>
 #include <set>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <QFile>
+#include <QStringList>
 #include <QTextEdit>
 #include <QMainWindow>
 #include "Common/Cpp/AbstractLogger.h"
@@ -38,35 +40,76 @@ private:
 };
 
 
+//  Lines are handed to a background thread which drains them in batches.
+//
+//  The file is written in large chunks. A chunk is written once enough has
+//  built up or once the oldest line in it is old enough. If "max_file_bytes"
+//  is non-zero, the file is renamed to "<path>.1" when it would grow past
+//  that and a new one is started.
+//
+//  Lines are only formatted for the windows while one is visible. When a
+//  window is shown again, the recent lines that it missed are formatted
+//  and sent to it then.
 class FileWindowLogger : public Logger{
 public:
     ~FileWindowLogger();
-    FileWindowLogger(const std::string& path);
+    FileWindowLogger(const std::string& path, uint64_t max_file_bytes = 0);
 
     void operator+=(FileWindowLoggerWindow& widget);
     void operator-=(FileWindowLoggerWindow& widget);
 
+    void on_window_shown(FileWindowLoggerWindow& widget);
+    void on_window_hidden(FileWindowLoggerWindow& widget);
+
     virtual void log(const std::string& msg, Color color = Color()) override;
     virtual void log(std::string&& msg, Color color = Color()) override;
     virtual std::vector<std::string> get_last() const override;
 
+    //  Takes effect on the next write. Zero disables rotation.
+    void set_max_file_bytes(uint64_t max_file_bytes);
+
 private:
+    using Line = std::pair<std::string, Color>;
+
     static std::string normalize_newlines(const std::string& msg);
-    static std::string to_file_str(const std::string& msg);
+    static void append_file_str(std::string& buffer, const std::string& msg);
     static QString to_window_str(const std::string& msg, Color color);
 
-    void internal_log(const std::string& msg, Color color);
+    void open_file();
+    void rotate_file();
+    void write_file();
+
+    //  Called by the logging thread without holding "m_lock" so that
+    //  formatting doesn't block anyone who is logging.
+    void send_to_windows(const std::deque<Line>& lines);
+
     void thread_loop();
 
 private:
     QFile m_file;
+    std::atomic<uint64_t> m_max_file_bytes;
+
+    //  Only touched by the logging thread.
+    uint64_t m_file_bytes;
+    std::string m_file_buffer;
+
     size_t m_max_queue_size;
     mutable std::mutex m_lock;
     std::condition_variable m_cv;
     LastLogTracker m_last_log_tracker;
     bool m_stopping;
-    std::deque<std::pair<std::string, Color>> m_queue;
+    std::deque<Line> m_queue;
+
+    //  Protects the windows and their history. Separate from "m_lock" so
+    //  updating the windows never holds up logging.
+    std::mutex m_window_lock;
     std::set<FileWindowLoggerWindow*> m_windows;
+
+    //  The most recent lines (unformatted), for windows that were hidden.
+    //  "m_window_history_end" is the index of the next line.
+    std::deque<Line> m_window_history;
+    uint64_t m_window_history_end;
+
     Thread m_thread;
 
 //    LifetimeSanitizer m_sanitizer;
@@ -81,11 +124,15 @@ public:
     virtual ~FileWindowLoggerWindow();
 
     void log(QString msg);
+    void log_lines(QStringList lines);
     virtual void resizeEvent(QResizeEvent* event) override;
     virtual void moveEvent(QMoveEvent* event) override;
+    virtual void showEvent(QShowEvent* event) override;
+    virtual void hideEvent(QHideEvent* event) override;
 
 signals:
     void signal_log(QString msg);
+    void signal_log_lines(QStringList lines);
 
 private:
     virtual void on_config_value_changed(void* object) override;
@@ -94,6 +141,11 @@ private:
     QTextEdit* m_text;
     bool m_pending_resize = false;
     bool m_pending_move = false;
+
+    //  Protected by the logger's "m_window_lock".
+    friend class FileWindowLogger;
+    bool m_visible = false;
+    uint64_t m_log_position = 0;
 };
 
 
@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_Logging_Logger_H
 #define PokemonAutomation_Logging_Logger_H
 
+#include <stdint.h>
 #include <string>
 #include "Common/Cpp/Color.h"
 #include "Common/Cpp/AbstractLogger.h"
@@ -18,6 +19,9 @@ namespace PokemonAutomation{
 //  Print as is. Use this to build other loggers.
 Logger& global_logger_raw();
 
+//  Rotate the log file once it would grow past this. Zero disables rotation.
+void set_log_file_max_bytes(uint64_t max_file_bytes);
+
 //  Print with timestamp and a default tag. use this directly.
 Logger& global_logger_tagged();
 
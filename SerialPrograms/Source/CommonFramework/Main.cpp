@@ -14,6 +14,7 @@
 #include "GlobalSettingsPanel.h"
 #include "PersistentSettings.h"
 #include "Tests/CommandLineTests.h"
+#include "Tests/Kernels_Benchmarks.h"
 #include "ErrorReports/ProgramDumper.h"
 #include "ErrorReports/ErrorReports.h"
 #include "Environment/HardwareValidation.h"
@@ -109,6 +110,9 @@ int run_program(int argc, char *argv[]){
     if (GlobalSettings::instance().COMMAND_LINE_TEST_MODE){
         return run_command_line_tests();
     }
+    if (GlobalSettings::instance().KERNEL_BENCHMARK_MODE){
+        return run_kernel_benchmarks();
+    }
 
     //  Check whether the hardware is powerful enough to run this program.
     if (!check_hardware()){
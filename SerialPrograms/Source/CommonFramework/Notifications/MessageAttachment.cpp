@@ -9,6 +9,7 @@
 #include "Common/Cpp/PrettyPrint.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Tools/ScreenshotEncoder.h"
 #include "MessageAttachment.h"
 
 namespace PokemonAutomation{
@@ -39,6 +40,11 @@ PendingFileSend::~PendingFileSend(){
         return;
     }
 
+    //  If it's still being written, the encoder will delete it when it's done.
+    if (m_pending && !m_pending->discard()){
+        return;
+    }
+
     QFile file(QString::fromStdString(m_filepath));
     file.remove();
 }
@@ -84,13 +90,19 @@ PendingFileSend::PendingFileSend(Logger& logger, const ImageAttachment& image)
         m_filepath += m_filename;
     }
 
-    if (image.image.save(m_filepath)){
-        logger.log("Saved image to: " + m_filepath, COLOR_BLUE);
-    }else{
-        logger.log("Unable to save screenshot to: " + m_filepath, COLOR_RED);
-        m_filename.clear();
-        m_filepath.clear();
+    //  Temporary files only need to look right in Discord. Don't upload
+    //  anything bigger than 1080p.
+    ScreenshotEncodeOptions options;
+    if (!image.keep_file){
+        options.max_width = 1920;
+        options.max_height = 1080;
     }
+
+    logger.log("Saving image to: " + m_filepath, COLOR_BLUE);
+    m_pending = ScreenshotEncoder::instance().save(logger, image.image, m_filepath, options);
+}
+bool PendingFileSend::wait_until_ready() const{
+    return !m_pending || m_pending->wait();
 }
 void PendingFileSend::extend_lifetime(){
     m_extend_lifetime.store(true, std::memory_order_release);
@@ -15,6 +15,7 @@
 
 namespace PokemonAutomation{
 
+class PendingScreenshot;
 
 struct ImageAttachment{
     ImageViewRGB32 image;
@@ -33,6 +34,10 @@ struct ImageAttachment{
 
 //  Represents a file that's in the process of being sent.
 //  If (keep_file = false), the file is automatically deleted after being sent.
+//
+//  Images are encoded in the background. "filename()" and "filepath()" are
+//  available immediately, but the file itself may not exist until
+//  "wait_until_ready()" returns.
 class PendingFileSend{
 public:
     ~PendingFileSend();
@@ -45,6 +50,10 @@ public:
     const std::string& filepath() const{ return m_filepath; }
     bool keep_file() const{ return m_keep_file; }
 
+    //  Block until the file is on disk. Returns false if it couldn't be written.
+    //  Call this from the sending thread, not the program thread.
+    bool wait_until_ready() const;
+
     //  Work around bug in Sleepy that destroys file before it's not needed anymore.
     void extend_lifetime();
 
@@ -54,6 +63,7 @@ private:
 //    QFile m_file;
     std::string m_filename;
     std::string m_filepath;
+    std::shared_ptr<PendingScreenshot> m_pending;
 };
 
 
@@ -92,6 +92,8 @@ void send_raw_notification(
     std::shared_ptr<PendingFileSend> file;
     if (image.image.width() > 0 && image.image.height() > 0){ // if image not empty
         file = std::make_shared<PendingFileSend>(logger, image);
+        //  The file is still being encoded. If that fails, the senders drop
+        //  the attachment and the embed image that points at it.
         hasImageFile = !file->filepath().empty();
     };
 
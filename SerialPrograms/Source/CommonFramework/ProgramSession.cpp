@@ -114,12 +114,13 @@ void ProgramSession::load_historical_stats(){
     if (stats){
         m_logger.log("Loading historical stats...");
 //        m_current_stats = m_descriptor.make_stats();
-        StatSet set;
-        set.open_from_file(GlobalSettings::instance().STATS_FILE);
-        const std::string& identifier = m_descriptor.identifier();
-        StatList& list = set[identifier];
-        if (list.size() != 0){
-            list.aggregate(*stats);
+        bool ok = StatsDatabase::instance().aggregate(
+            GlobalSettings::instance().STATS_FILE,
+            m_descriptor.identifier(),
+            *stats
+        );
+        if (!ok){
+            m_logger.log("Unable to load historical stats.", COLOR_RED);
         }
         m_historical_stats = std::move(stats);
     }
@@ -127,7 +128,7 @@ void ProgramSession::load_historical_stats(){
 void ProgramSession::update_historical_stats_with_current(){
     if (m_current_stats){
         m_logger.log("Saving historical stats...");
-        bool ok = StatSet::update_file(
+        bool ok = StatsDatabase::instance().append(
             GlobalSettings::instance().STATS_FILE,
             m_descriptor.identifier(),
             *m_current_stats
@@ -5,6 +5,9 @@
  */
 
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QLockFile>
 #include <QSaveFile>
 #include "Common/Cpp/Time.h"
 #include "StatsDatabase.h"
@@ -39,6 +42,59 @@ const std::map<std::string, std::string> STATS_DATABASE_ALIASES{
     {"PokemonLZA:BerryBuyer", "PokemonLZA:StallBuyer"},
 };
 
+//  Merge the journal back into the stats file once it gets this large.
+const qint64 STATS_JOURNAL_COMPACT_BYTES = 256 * 1024;
+
+//  How long to wait for another instance to release the stats file.
+const int STATS_LOCK_TIMEOUT_MILLIS = 5000;
+
+
+
+std::string stats_journal_path(const std::string& filepath){
+    return filepath + ".journal";
+}
+
+
+
+namespace{
+
+std::string lock_path(const std::string& filepath){
+    return filepath + ".lock";
+}
+
+const std::string& resolve_alias(const std::string& identifier){
+    auto iter = STATS_DATABASE_ALIASES.find(identifier);
+    return iter == STATS_DATABASE_ALIASES.end()
+        ? identifier
+        : iter->second;
+}
+
+//  Call "function(identifier, line)" on every complete record in "data".
+//  Returns the number of bytes consumed. A trailing partial record is left
+//  for the next read.
+template <typename Function>
+size_t parse_journal(const std::string& data, Function&& function){
+    size_t consumed = 0;
+    while (true){
+        size_t end = data.find('\n', consumed);
+        if (end == std::string::npos){
+            return consumed;
+        }
+        size_t line_end = end;
+        if (line_end > consumed && data[line_end - 1] == '\r'){
+            line_end--;
+        }
+        size_t tab = data.find('\t', consumed);
+        if (tab != std::string::npos && tab < line_end){
+            std::string identifier = data.substr(consumed, tab - consumed);
+            function(resolve_alias(identifier), data.substr(tab + 1, line_end - tab - 1));
+        }
+        consumed = end + 1;
+    }
+}
+
+}
+
 
 
 StatLine::StatLine(StatsTracker& tracker)
@@ -141,37 +197,26 @@ void StatSet::save_to_file(const std::string& filepath){
     }
 }
 void StatSet::open_from_file(const std::string& filepath){
+    m_data.clear();
+
     QFile file(QString::fromStdString(filepath));
-    if (!file.open(QIODevice::ReadOnly)){
-        return;
+    if (file.open(QIODevice::ReadOnly)){
+        std::string str = file.readAll().data();
+        load_from_string(str.c_str());
     }
 
-    std::string str = file.readAll().data();
-    load_from_string(str.c_str());
+    load_journal(filepath);
 }
-
-bool StatSet::update_file(
-    const std::string& filepath,
-    const std::string& identifier,
-    StatsTracker& tracker
-){
-    QFile file(QString::fromStdString(filepath));
-    while (!file.open(QIODevice::ReadWrite)){
-        return false;
+void StatSet::load_journal(const std::string& filepath){
+    QFile file(QString::fromStdString(stats_journal_path(filepath)));
+    if (!file.open(QIODevice::ReadOnly)){
+        return;
     }
-    std::string data = file.readAll().data();
-
-    StatSet set;
-    set.load_from_string(data.c_str());
-
-    set[identifier] += tracker;
-
-    data = set.to_str();
-    file.seek(0);
-    file.write(data.c_str(), data.size());
-    file.resize(data.size());
 
-    return true;
+    std::string data = file.readAll().toStdString();
+    parse_journal(data, [this](const std::string& identifier, const std::string& line){
+        m_data[identifier] += line;
+    });
 }
 
 
@@ -242,6 +287,188 @@ void StatSet::load_from_string(const char* ptr){
 
 
 
+struct StatsDatabase::Index{
+    //  Identifies the version of the stats file the totals were built from.
+    qint64 snapshot_size = -1;
+    QDateTime snapshot_time;
+
+    //  How much of the journal has been added to the totals.
+    qint64 journal_offset = 0;
+
+    std::map<std::string, std::unique_ptr<StatsTracker>> totals;
+
+    StatsTracker& operator[](const std::string& identifier){
+        std::unique_ptr<StatsTracker>& tracker = totals[identifier];
+        if (!tracker){
+            tracker = std::make_unique<StatsTracker>();
+        }
+        return *tracker;
+    }
+};
+
+
+
+StatsDatabase& StatsDatabase::instance(){
+    static StatsDatabase database;
+    return database;
+}
+StatsDatabase::StatsDatabase() = default;
+StatsDatabase::~StatsDatabase() = default;
+
+StatsDatabase::Index& StatsDatabase::index(const std::string& filepath){
+    std::unique_ptr<Index>& index = m_indices[filepath];
+    if (!index){
+        index = std::make_unique<Index>();
+    }
+    return *index;
+}
+
+void StatsDatabase::refresh(Index& index, const std::string& filepath){
+    QFileInfo snapshot(QString::fromStdString(filepath));
+    qint64 snapshot_size = snapshot.exists() ? snapshot.size() : -1;
+    QDateTime snapshot_time = snapshot.exists() ? snapshot.lastModified() : QDateTime();
+
+    QFileInfo journal(QString::fromStdString(stats_journal_path(filepath)));
+    qint64 journal_size = journal.exists() ? journal.size() : 0;
+
+    //  Another instance has compacted the stats. Start over.
+    if (snapshot_size != index.snapshot_size ||
+        snapshot_time != index.snapshot_time ||
+        journal_size < index.journal_offset
+    ){
+        reload(index, filepath);
+        index.snapshot_size = snapshot_size;
+        index.snapshot_time = snapshot_time;
+    }
+
+    if (journal_size > index.journal_offset){
+        read_journal(index, filepath);
+    }
+}
+void StatsDatabase::reload(Index& index, const std::string& filepath){
+    index.totals.clear();
+    index.journal_offset = 0;
+
+    StatSet set;
+    QFile file(QString::fromStdString(filepath));
+    if (!file.open(QIODevice::ReadOnly)){
+        return;
+    }
+    std::string str = file.readAll().data();
+    set.load_from_string(str.c_str());
+
+    for (const auto& program : set.m_data){
+        StatsTracker& tracker = index[program.first];
+        for (const StatLine& line : program.second.list()){
+            tracker.parse_and_append_line(line.stats());
+        }
+    }
+}
+void StatsDatabase::read_journal(Index& index, const std::string& filepath){
+    QFile file(QString::fromStdString(stats_journal_path(filepath)));
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(index.journal_offset)){
+        return;
+    }
+
+    std::string data = file.readAll().toStdString();
+    size_t consumed = parse_journal(data, [&](const std::string& identifier, const std::string& line){
+        StatLine stat_line(line);
+        index[identifier].parse_and_append_line(stat_line.stats());
+    });
+    index.journal_offset += consumed;
+}
+bool StatsDatabase::compact(Index& index, const std::string& filepath){
+    StatSet set;
+    set.open_from_file(filepath);
+
+    QSaveFile file(QString::fromStdString(filepath));
+    if (!file.open(QIODevice::WriteOnly)){
+        return false;
+    }
+    std::string data = set.to_str();
+    file.write(data.c_str(), data.size());
+    if (!file.commit()){
+        return false;
+    }
+
+    QFile journal(QString::fromStdString(stats_journal_path(filepath)));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        return false;
+    }
+    journal.close();
+
+    //  The totals haven't changed. Only where they came from.
+    QFileInfo snapshot(file.fileName());
+    index.snapshot_size = snapshot.size();
+    index.snapshot_time = snapshot.lastModified();
+    index.journal_offset = 0;
+
+    return true;
+}
+
+
+bool StatsDatabase::aggregate(
+    const std::string& filepath,
+    const std::string& identifier,
+    StatsTracker& tracker
+){
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    QLockFile file_lock(QString::fromStdString(lock_path(filepath)));
+    if (!file_lock.tryLock(STATS_LOCK_TIMEOUT_MILLIS)){
+        return false;
+    }
+
+    Index& index = this->index(filepath);
+    refresh(index, filepath);
+
+    auto iter = index.totals.find(resolve_alias(identifier));
+    if (iter != index.totals.end()){
+        tracker.append(*iter->second);
+    }
+    return true;
+}
+bool StatsDatabase::append(
+    const std::string& filepath,
+    const std::string& identifier,
+    StatsTracker& tracker
+){
+    std::string record = identifier;
+    record += "\t";
+    record += StatLine(tracker).to_str();
+    record += "\r\n";
+
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    QLockFile file_lock(QString::fromStdString(lock_path(filepath)));
+    if (!file_lock.tryLock(STATS_LOCK_TIMEOUT_MILLIS)){
+        return false;
+    }
+
+    Index& index = this->index(filepath);
+    refresh(index, filepath);
+
+    QFile file(QString::fromStdString(stats_journal_path(filepath)));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)){
+        return false;
+    }
+    if (file.write(record.c_str(), record.size()) != (qint64)record.size()){
+        return false;
+    }
+    qint64 journal_size = file.size();
+    file.close();
+
+    read_journal(index, filepath);
+
+    if (journal_size >= STATS_JOURNAL_COMPACT_BYTES){
+        compact(index, filepath);
+    }
+    return true;
+}
+
+
+
+
 
 
 
@@ -7,11 +7,18 @@
 #ifndef PokemonAutomation_StatsDatabase_H
 #define PokemonAutomation_StatsDatabase_H
 
+#include <memory>
+#include <mutex>
 #include "StatsTracking.h"
 
 namespace PokemonAutomation{
 
 
+//  Path of the journal that belongs to the stats file "filepath".
+std::string stats_journal_path(const std::string& filepath);
+
+
+
 class StatLine{
 public:
     StatLine(StatsTracker& tracker);
@@ -54,20 +61,66 @@ public:
     std::string to_str() const;
 
     void save_to_file(const std::string& filepath);
+
+    //  Load the stats file along with its journal.
     void open_from_file(const std::string& filepath);
 
-    static bool update_file(
+private:
+    friend class StatsDatabase;
+
+    bool get_line(std::string& line, const char*& ptr);
+    void load_from_string(const char* ptr);
+    void load_journal(const std::string& filepath);
+
+private:
+    std::map<std::string, StatList> m_data;
+};
+
+
+
+//  The stats file is only rewritten during compaction. Each run is appended
+//  to "<stats file>.journal" as a single "<identifier>\t<stat line>" record.
+//  Once the journal grows large enough, it is merged back into the stats file.
+//
+//  Every program instance sharing the file takes "<stats file>.lock" while
+//  reading or writing either file.
+//
+//  The totals for each program are kept in memory and updated by reading
+//  only the part of the journal that is new since the last time. The stats
+//  file is only parsed again if another instance has rewritten it.
+class StatsDatabase{
+public:
+    static StatsDatabase& instance();
+
+    //  Add the totals of all past runs of "identifier" to "tracker".
+    bool aggregate(
+        const std::string& filepath,
+        const std::string& identifier,
+        StatsTracker& tracker
+    );
+
+    //  Record the stats of one run.
+    bool append(
         const std::string& filepath,
         const std::string& identifier,
         StatsTracker& tracker
     );
 
 private:
-    bool get_line(std::string& line, const char*& ptr);
-    void load_from_string(const char* ptr);
+    struct Index;
+
+    StatsDatabase();
+    ~StatsDatabase();
+
+    Index& index(const std::string& filepath);
+    static void refresh(Index& index, const std::string& filepath);
+    static void reload(Index& index, const std::string& filepath);
+    static void read_journal(Index& index, const std::string& filepath);
+    static bool compact(Index& index, const std::string& filepath);
 
 private:
-    std::map<std::string, StatList> m_data;
+    std::mutex m_lock;
+    std::map<std::string, std::unique_ptr<Index>> m_indices;
 };
 
 
@@ -127,6 +127,14 @@ void StatsTracker::parse_and_append_line(const std::string& line){
 
 
 
+void StatsTracker::append(const StatsTracker& tracker){
+    for (const auto& item : tracker.m_stats){
+        m_stats[item.first] += item.second.load(std::memory_order_relaxed);
+    }
+}
+
+
+
 std::string stats_to_bar(
     Logger& logger,
     const StatsTracker* historical,
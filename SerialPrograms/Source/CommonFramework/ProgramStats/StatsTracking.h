@@ -36,6 +36,9 @@ public:
 
     void parse_and_append_line(const std::string& line);
 
+    //  Add all the counts in "tracker" to this one.
+    void append(const StatsTracker& tracker);
+
 
 protected:
 //    static constexpr bool HIDDEN_IF_ZERO = true;
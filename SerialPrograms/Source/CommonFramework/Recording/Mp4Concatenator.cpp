@@ -0,0 +1,1040 @@
+/*  MP4 Concatenator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "Mp4Concatenator.h"
+#include "Mp4Concatenator_Debugging.h"
+
+namespace PokemonAutomation{
+
+namespace{
+
+
+constexpr uint32_t box_type(const char (&str)[5]){
+    return ((uint32_t)(uint8_t)str[0] << 24) | ((uint32_t)(uint8_t)str[1] << 16) |
+           ((uint32_t)(uint8_t)str[2] <<  8) | ((uint32_t)(uint8_t)str[3] <<  0);
+}
+
+uint32_t read_u32(const char* ptr){
+    const uint8_t* p = (const uint8_t*)ptr;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+uint64_t read_u64(const char* ptr){
+    return ((uint64_t)read_u32(ptr) << 32) | read_u32(ptr + 4);
+}
+void write_u32(char* ptr, uint32_t x){
+    ptr[0] = (char)(x >> 24);
+    ptr[1] = (char)(x >> 16);
+    ptr[2] = (char)(x >>  8);
+    ptr[3] = (char)(x >>  0);
+}
+void write_u64(char* ptr, uint64_t x){
+    write_u32(ptr, (uint32_t)(x >> 32));
+    write_u32(ptr + 4, (uint32_t)x);
+}
+void append_u32(std::string& str, uint32_t x){
+    char buffer[4];
+    write_u32(buffer, x);
+    str.append(buffer, 4);
+}
+void append_u64(std::string& str, uint64_t x){
+    char buffer[8];
+    write_u64(buffer, x);
+    str.append(buffer, 8);
+}
+
+
+
+//  A parsed box. Only the boxes on the path down to the sample tables are
+//  broken into children. Everything else is kept as opaque bytes.
+struct Box{
+    uint32_t type = 0;
+    bool container = false;
+    std::string payload;
+    std::vector<Box> children;
+
+    Box* find(uint32_t child_type){
+        for (Box& child : children){
+            if (child.type == child_type){
+                return &child;
+            }
+        }
+        return nullptr;
+    }
+    const Box* find(uint32_t child_type) const{
+        return const_cast<Box*>(this)->find(child_type);
+    }
+
+    uint64_t size() const{
+        uint64_t body = 0;
+        if (container){
+            for (const Box& child : children){
+                body += child.size();
+            }
+        }else{
+            body = payload.size();
+        }
+        return body + (body + 8 > 0xffffffff ? 16 : 8);
+    }
+    void serialize(std::string& out) const{
+        uint64_t total = size();
+        if (total > 0xffffffff){
+            append_u32(out, 1);
+            append_u32(out, type);
+            append_u64(out, total);
+        }else{
+            append_u32(out, (uint32_t)total);
+            append_u32(out, type);
+        }
+        if (container){
+            for (const Box& child : children){
+                child.serialize(out);
+            }
+        }else{
+            out += payload;
+        }
+    }
+};
+
+bool is_container(uint32_t type){
+    switch (type){
+    case box_type("moov"):
+    case box_type("trak"):
+    case box_type("mdia"):
+    case box_type("minf"):
+    case box_type("stbl"):
+    case box_type("edts"):
+        return true;
+    default:
+        return false;
+    }
+}
+
+//  Iterate the boxes in [ptr, ptr + bytes).
+template <typename Callback>
+bool for_each_box(const char* ptr, uint64_t bytes, Callback&& callback){
+    uint64_t offset = 0;
+    while (offset + 8 <= bytes){
+        uint64_t size = read_u32(ptr + offset);
+        uint32_t type = read_u32(ptr + offset + 4);
+        uint64_t header = 8;
+        if (size == 1){
+            if (offset + 16 > bytes){
+                return false;
+            }
+            size = read_u64(ptr + offset + 8);
+            header = 16;
+        }else if (size == 0){
+            size = bytes - offset;
+        }
+        if (size < header || size > bytes - offset){
+            return false;
+        }
+        if (!callback(type, offset + header, size - header)){
+            return false;
+        }
+        offset += size;
+    }
+    return true;
+}
+bool parse_box(Box& box, uint32_t type, const char* body, uint64_t bytes){
+    box.type = type;
+    box.container = is_container(type);
+    if (!box.container){
+        box.payload.assign(body, (size_t)bytes);
+        return true;
+    }
+    return for_each_box(body, bytes, [&](uint32_t child_type, uint64_t offset, uint64_t child_bytes){
+        box.children.emplace_back();
+        return parse_box(box.children.back(), child_type, body + offset, child_bytes);
+    });
+}
+
+
+
+struct Chunk{
+    uint64_t offset;
+    uint32_t samples;
+    uint64_t bytes;
+};
+struct TrackSamples{
+    uint32_t handler = 0;
+    uint32_t timescale = 0;
+    std::string sample_description;     //  For comparison only.
+
+    std::vector<uint32_t> sizes;
+    std::vector<uint32_t> deltas;
+    std::vector<int32_t> composition_offsets;   //  Empty if none.
+    std::vector<bool> sync;                     //  Empty if every sample is a sync sample.
+    std::vector<Chunk> chunks;
+    std::vector<Mp4Edit> edits;                 //  Empty if there is no edit list.
+
+    uint64_t duration() const{
+        uint64_t ret = 0;
+        for (uint32_t delta : deltas){
+            ret += delta;
+        }
+        return ret;
+    }
+};
+struct InputFile{
+    std::string data;
+    Box ftyp;
+    Box moov;
+    uint32_t movie_timescale = 0;
+    std::vector<TrackSamples> tracks;
+};
+
+
+//  Encoders put bitrate hints in the sample description that vary from
+//  file to file. Blank them out so that only the codec configuration is
+//  compared.
+std::string comparable_sample_description(std::string stsd){
+    auto find = [&](const char (&type)[5], size_t start){
+        return stsd.find(std::string(type, 4), start);
+    };
+
+    //  "btrt": buffer size, max bitrate, average bitrate.
+    for (size_t pos = find("btrt", 4); pos != std::string::npos; pos = find("btrt", pos + 4)){
+        if (read_u32(&stsd[pos - 4]) == 20 && pos + 16 <= stsd.size()){
+            std::fill(stsd.begin() + pos + 4, stsd.begin() + pos + 16, 0);
+        }
+    }
+
+    //  "esds": same three fields inside the DecoderConfigDescriptor.
+    for (size_t pos = find("esds", 4); pos != std::string::npos; pos = find("esds", pos + 4)){
+        size_t end = std::min<size_t>(stsd.size(), pos - 4 + read_u32(&stsd[pos - 4]));
+        size_t c = pos + 8;     //  Skip type, version and flags.
+        auto skip_length = [&]{
+            for (size_t i = 0; i < 4 && c < end; i++){
+                if (((uint8_t)stsd[c++] & 0x80) == 0){
+                    break;
+                }
+            }
+        };
+        if (c >= end || stsd[c] != 0x03){
+            continue;
+        }
+        c++;
+        skip_length();
+        if (c + 3 > end){
+            continue;
+        }
+        uint8_t flags = (uint8_t)stsd[c + 2];
+        c += 3;
+        if (flags & 0x80){
+            c += 2;
+        }
+        if (flags & 0x40){
+            c += c < end ? 1 + (uint8_t)stsd[c] : 0;
+        }
+        if (flags & 0x20){
+            c += 2;
+        }
+        if (c >= end || stsd[c] != 0x04){
+            continue;
+        }
+        c++;
+        skip_length();
+        c += 2;     //  Object type and stream type.
+        if (c + 11 <= end){
+            std::fill(stsd.begin() + c, stsd.begin() + c + 11, 0);
+        }
+    }
+
+    return stsd;
+}
+
+
+//  Cursor over a full box payload (version + flags + body).
+class Reader{
+public:
+    Reader(const std::string& payload)
+        : m_ptr(payload.data())
+        , m_end(payload.data() + payload.size())
+    {}
+    bool has(size_t bytes) const{ return (size_t)(m_end - m_ptr) >= bytes; }
+    uint32_t u32(){ uint32_t x = read_u32(m_ptr); m_ptr += 4; return x; }
+    uint64_t u64(){ uint64_t x = read_u64(m_ptr); m_ptr += 8; return x; }
+private:
+    const char* m_ptr;
+    const char* m_end;
+};
+
+
+//  Returns false if the edit list is not something we understand.
+bool parse_edit_list(const Box& edts, std::vector<Mp4Edit>& edits){
+    const Box* elst = edts.find(box_type("elst"));
+    if (elst == nullptr){
+        return false;
+    }
+    Reader reader(elst->payload);
+    if (!reader.has(8)){
+        return false;
+    }
+    bool v1 = (reader.u32() >> 24) == 1;
+    uint32_t entries = reader.u32();
+    if (entries == 0 || !reader.has((size_t)entries * (v1 ? 20 : 12))){
+        return false;
+    }
+    for (uint32_t c = 0; c < entries; c++){
+        Mp4Edit edit;
+        edit.duration = v1 ? reader.u64() : reader.u32();
+        edit.media_time = v1 ? (int64_t)reader.u64() : (int32_t)reader.u32();
+        edit.rate = reader.u32();
+        edits.emplace_back(edit);
+    }
+    return true;
+}
+
+bool parse_track(Logger& logger, const Box& trak, TrackSamples& track){
+    const Box* mdia = trak.find(box_type("mdia"));
+    const Box* hdlr = mdia ? mdia->find(box_type("hdlr")) : nullptr;
+    const Box* mdhd = mdia ? mdia->find(box_type("mdhd")) : nullptr;
+    const Box* minf = mdia ? mdia->find(box_type("minf")) : nullptr;
+    const Box* stbl = minf ? minf->find(box_type("stbl")) : nullptr;
+    if (hdlr == nullptr || mdhd == nullptr || stbl == nullptr || hdlr->payload.size() < 12 || mdhd->payload.size() < 24){
+        logger.log("MP4 Concatenate: Track is missing required boxes.", COLOR_RED);
+        return false;
+    }
+    track.handler = read_u32(hdlr->payload.data() + 8);
+    track.timescale = read_u32(mdhd->payload.data() + (mdhd->payload[0] == 1 ? 20 : 12));
+
+    const Box* stsd = stbl->find(box_type("stsd"));
+    const Box* stts = stbl->find(box_type("stts"));
+    const Box* stsz = stbl->find(box_type("stsz"));
+    const Box* stsc = stbl->find(box_type("stsc"));
+    const Box* stco = stbl->find(box_type("stco"));
+    const Box* co64 = stbl->find(box_type("co64"));
+    const Box* ctts = stbl->find(box_type("ctts"));
+    const Box* stss = stbl->find(box_type("stss"));
+    if (stsd == nullptr || stts == nullptr || stsz == nullptr || stsc == nullptr || (stco == nullptr && co64 == nullptr)){
+        logger.log("MP4 Concatenate: Sample table is incomplete.", COLOR_RED);
+        return false;
+    }
+    track.sample_description = comparable_sample_description(stsd->payload);
+
+    //  Edit lists we don't understand are dropped.
+    const Box* edts = trak.find(box_type("edts"));
+    if (edts != nullptr && !parse_edit_list(*edts, track.edits)){
+        track.edits.clear();
+    }
+
+    //  Sample sizes.
+    {
+        Reader reader(stsz->payload);
+        if (!reader.has(12)){
+            return false;
+        }
+        reader.u32();
+        uint32_t uniform = reader.u32();
+        uint32_t count = reader.u32();
+        if (uniform != 0){
+            track.sizes.assign(count, uniform);
+        }else{
+            if (!reader.has((size_t)count * 4)){
+                return false;
+            }
+            track.sizes.resize(count);
+            for (uint32_t& size : track.sizes){
+                size = reader.u32();
+            }
+        }
+    }
+    size_t samples = track.sizes.size();
+
+    //  Decode times.
+    {
+        Reader reader(stts->payload);
+        if (!reader.has(8)){
+            return false;
+        }
+        reader.u32();
+        uint32_t entries = reader.u32();
+        if (!reader.has((size_t)entries * 8)){
+            return false;
+        }
+        for (uint32_t c = 0; c < entries; c++){
+            uint32_t count = reader.u32();
+            uint32_t delta = reader.u32();
+            if (track.deltas.size() + count > samples){
+                return false;
+            }
+            track.deltas.insert(track.deltas.end(), count, delta);
+        }
+    }
+
+    //  Composition offsets.
+    if (ctts != nullptr){
+        Reader reader(ctts->payload);
+        if (!reader.has(8)){
+            return false;
+        }
+        reader.u32();
+        uint32_t entries = reader.u32();
+        if (!reader.has((size_t)entries * 8)){
+            return false;
+        }
+        for (uint32_t c = 0; c < entries; c++){
+            uint32_t count = reader.u32();
+            int32_t offset = (int32_t)reader.u32();
+            if (track.composition_offsets.size() + count > samples){
+                return false;
+            }
+            track.composition_offsets.insert(track.composition_offsets.end(), count, offset);
+        }
+        track.composition_offsets.resize(samples, 0);
+    }
+
+    //  Sync samples.
+    if (stss != nullptr){
+        Reader reader(stss->payload);
+        if (!reader.has(8)){
+            return false;
+        }
+        reader.u32();
+        uint32_t entries = reader.u32();
+        if (!reader.has((size_t)entries * 4)){
+            return false;
+        }
+        track.sync.assign(samples, false);
+        for (uint32_t c = 0; c < entries; c++){
+            uint32_t index = reader.u32();
+            if (index == 0 || index > samples){
+                return false;
+            }
+            track.sync[index - 1] = true;
+        }
+    }
+
+    //  Chunk offsets.
+    std::vector<uint64_t> offsets;
+    {
+        Reader reader(co64 != nullptr ? co64->payload : stco->payload);
+        if (!reader.has(8)){
+            return false;
+        }
+        reader.u32();
+        uint32_t entries = reader.u32();
+        if (!reader.has((size_t)entries * (co64 != nullptr ? 8 : 4))){
+            return false;
+        }
+        offsets.resize(entries);
+        for (uint64_t& offset : offsets){
+            offset = co64 != nullptr ? reader.u64() : reader.u32();
+        }
+    }
+
+    //  Samples per chunk.
+    {
+        Reader reader(stsc->payload);
+        if (!reader.has(8)){
+            return false;
+        }
+        reader.u32();
+        uint32_t entries = reader.u32();
+        if (!reader.has((size_t)entries * 12)){
+            return false;
+        }
+        struct Entry{
+            uint32_t first_chunk;
+            uint32_t samples_per_chunk;
+        };
+        std::vector<Entry> table;
+        for (uint32_t c = 0; c < entries; c++){
+            uint32_t first_chunk = reader.u32();
+            uint32_t samples_per_chunk = reader.u32();
+            uint32_t description = reader.u32();
+            if (description != 1){
+                logger.log("MP4 Concatenate: Multiple sample descriptions are not supported.", COLOR_RED);
+                return false;
+            }
+            table.emplace_back(Entry{first_chunk, samples_per_chunk});
+        }
+
+        size_t entry = 0;
+        size_t sample = 0;
+        for (size_t c = 0; c < offsets.size(); c++){
+            while (entry + 1 < table.size() && table[entry + 1].first_chunk <= c + 1){
+                entry++;
+            }
+            if (table.empty()){
+                return false;
+            }
+            uint32_t count = table[entry].samples_per_chunk;
+            if (sample + count > samples){
+                return false;
+            }
+            uint64_t bytes = 0;
+            for (uint32_t s = 0; s < count; s++){
+                bytes += track.sizes[sample + s];
+            }
+            track.chunks.emplace_back(Chunk{offsets[c], count, bytes});
+            sample += count;
+        }
+        if (sample != samples){
+            return false;
+        }
+    }
+
+    return track.deltas.size() == samples;
+}
+
+bool load_file(Logger& logger, const std::string& filename, InputFile& file){
+    {
+        std::ifstream stream(filename, std::ios::binary);
+        if (!stream){
+            logger.log("MP4 Concatenate: Unable to open: " + filename, COLOR_RED);
+            return false;
+        }
+        std::ostringstream buffer;
+        buffer << stream.rdbuf();
+        file.data = std::move(buffer).str();
+    }
+
+    bool ok = for_each_box(file.data.data(), file.data.size(), [&](uint32_t type, uint64_t offset, uint64_t bytes){
+        switch (type){
+        case box_type("ftyp"):
+            return parse_box(file.ftyp, type, file.data.data() + offset, bytes);
+        case box_type("moov"):
+            return parse_box(file.moov, type, file.data.data() + offset, bytes);
+        default:
+            return true;
+        }
+    });
+    if (!ok || file.ftyp.type == 0 || file.moov.type == 0){
+        logger.log("MP4 Concatenate: Not a complete MP4 file: " + filename, COLOR_RED);
+        return false;
+    }
+
+    const Box* mvhd = file.moov.find(box_type("mvhd"));
+    if (mvhd == nullptr || mvhd->payload.size() < 24){
+        logger.log("MP4 Concatenate: Missing movie header: " + filename, COLOR_RED);
+        return false;
+    }
+    file.movie_timescale = read_u32(&mvhd->payload[mvhd->payload[0] == 1 ? 20 : 12]);
+    if (file.movie_timescale == 0){
+        logger.log("MP4 Concatenate: Invalid movie timescale: " + filename, COLOR_RED);
+        return false;
+    }
+
+    for (const Box& child : file.moov.children){
+        if (child.type != box_type("trak")){
+            continue;
+        }
+        file.tracks.emplace_back();
+        if (!parse_track(logger, child, file.tracks.back())){
+            logger.log("MP4 Concatenate: Unable to parse track in: " + filename, COLOR_RED);
+            return false;
+        }
+        for (const Chunk& chunk : file.tracks.back().chunks){
+            if (chunk.offset > file.data.size() || chunk.bytes > file.data.size() - chunk.offset){
+                logger.log("MP4 Concatenate: Truncated file: " + filename, COLOR_RED);
+                return false;
+            }
+        }
+        if (file.tracks.back().timescale == 0){
+            logger.log("MP4 Concatenate: Invalid track timescale: " + filename, COLOR_RED);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+//  Build the full box payloads for the joined sample tables.
+
+std::string build_stts(const std::vector<uint32_t>& deltas){
+    std::string body;
+    uint32_t entries = 0;
+    for (size_t c = 0; c < deltas.size();){
+        size_t end = c;
+        while (end < deltas.size() && deltas[end] == deltas[c]){
+            end++;
+        }
+        append_u32(body, (uint32_t)(end - c));
+        append_u32(body, deltas[c]);
+        entries++;
+        c = end;
+    }
+    std::string ret;
+    append_u32(ret, 0);
+    append_u32(ret, entries);
+    return ret + body;
+}
+std::string build_ctts(const std::vector<int32_t>& offsets){
+    std::string body;
+    uint32_t entries = 0;
+    bool negative = false;
+    for (size_t c = 0; c < offsets.size();){
+        size_t end = c;
+        while (end < offsets.size() && offsets[end] == offsets[c]){
+            end++;
+        }
+        append_u32(body, (uint32_t)(end - c));
+        append_u32(body, (uint32_t)offsets[c]);
+        negative |= offsets[c] < 0;
+        entries++;
+        c = end;
+    }
+    std::string ret;
+    append_u32(ret, negative ? 0x01000000 : 0);
+    append_u32(ret, entries);
+    return ret + body;
+}
+std::string build_stss(const std::vector<bool>& sync){
+    std::string body;
+    uint32_t entries = 0;
+    for (size_t c = 0; c < sync.size(); c++){
+        if (sync[c]){
+            append_u32(body, (uint32_t)(c + 1));
+            entries++;
+        }
+    }
+    std::string ret;
+    append_u32(ret, 0);
+    append_u32(ret, entries);
+    return ret + body;
+}
+std::string build_stsz(const std::vector<uint32_t>& sizes){
+    std::string ret;
+    append_u32(ret, 0);
+    append_u32(ret, 0);
+    append_u32(ret, (uint32_t)sizes.size());
+    for (uint32_t size : sizes){
+        append_u32(ret, size);
+    }
+    return ret;
+}
+std::string build_stsc(const std::vector<Chunk>& chunks){
+    std::string body;
+    uint32_t entries = 0;
+    for (size_t c = 0; c < chunks.size(); c++){
+        if (c == 0 || chunks[c].samples != chunks[c - 1].samples){
+            append_u32(body, (uint32_t)(c + 1));
+            append_u32(body, chunks[c].samples);
+            append_u32(body, 1);
+            entries++;
+        }
+    }
+    std::string ret;
+    append_u32(ret, 0);
+    append_u32(ret, entries);
+    return ret + body;
+}
+std::string build_elst(const std::vector<Mp4Edit>& edits){
+    bool v1 = false;
+    for (const Mp4Edit& edit : edits){
+        v1 |= edit.duration > 0xffffffff;
+        v1 |= edit.media_time > 0x7fffffff;
+    }
+    std::string ret;
+    append_u32(ret, v1 ? 0x01000000 : 0);
+    append_u32(ret, (uint32_t)edits.size());
+    for (const Mp4Edit& edit : edits){
+        if (v1){
+            append_u64(ret, edit.duration);
+            append_u64(ret, (uint64_t)edit.media_time);
+        }else{
+            append_u32(ret, (uint32_t)edit.duration);
+            append_u32(ret, (uint32_t)edit.media_time);
+        }
+        append_u32(ret, edit.rate);
+    }
+    return ret;
+}
+std::string build_chunk_offsets(const std::vector<Chunk>& chunks, bool large){
+    std::string ret;
+    append_u32(ret, 0);
+    append_u32(ret, (uint32_t)chunks.size());
+    for (const Chunk& chunk : chunks){
+        if (large){
+            append_u64(ret, chunk.offset);
+        }else{
+            append_u32(ret, (uint32_t)chunk.offset);
+        }
+    }
+    return ret;
+}
+
+Box leaf(const char (&type)[5], std::string payload){
+    Box box;
+    box.type = box_type(type);
+    box.payload = std::move(payload);
+    return box;
+}
+
+//  Overwrite the duration field of a "mvhd", "tkhd" or "mdhd".
+void patch_duration(std::string& payload, size_t v0_offset, size_t v1_offset, uint64_t duration){
+    if (payload.empty()){
+        return;
+    }
+    if (payload[0] == 1){
+        if (payload.size() >= v1_offset + 8){
+            write_u64(&payload[v1_offset], duration);
+        }
+    }else{
+        if (payload.size() >= v0_offset + 4){
+            write_u32(&payload[v0_offset], (uint32_t)std::min<uint64_t>(duration, 0xffffffff));
+        }
+    }
+}
+
+//  The edit list of each input as it will appear in the output. Inputs
+//  without one get a single edit over all of their media.
+std::vector<Mp4Edit> input_edits(const TrackSamples& track, uint32_t movie_timescale){
+    if (!track.edits.empty()){
+        return track.edits;
+    }
+    return {Mp4Edit{track.duration() * movie_timescale / track.timescale, 0, 0x00010000}};
+}
+uint64_t edit_duration(const std::vector<Mp4Edit>& edits){
+    uint64_t ret = 0;
+    for (const Mp4Edit& edit : edits){
+        ret += edit.duration;
+    }
+    return ret;
+}
+
+//  Join the edit lists of every input for one track. Each input keeps its
+//  own edits, moved to where its samples start in the joined track. That
+//  way the encoder delay at the start of each input (the AAC priming
+//  samples) is skipped at every seam and not just at the start.
+//
+//  Each input is cut to the length of its shortest track. Otherwise the
+//  few milliseconds by which the tracks of a segment differ in length would
+//  add up into an audio drift over many segments.
+std::vector<Mp4Edit> join_edit_lists(const std::vector<InputFile>& files, size_t track, uint32_t movie_timescale){
+    std::vector<Mp4Edit> ret;
+    uint64_t media_start = 0;
+    for (const InputFile& file : files){
+        uint64_t length = (uint64_t)-1;
+        for (const TrackSamples& samples : file.tracks){
+            length = std::min(length, edit_duration(input_edits(samples, movie_timescale)));
+        }
+
+        const TrackSamples& samples = file.tracks[track];
+        for (Mp4Edit edit : input_edits(samples, movie_timescale)){
+            if (length == 0){
+                break;
+            }
+            edit.duration = std::min(edit.duration, length);
+            length -= edit.duration;
+            if (edit.media_time >= 0){
+                edit.media_time += (int64_t)media_start;
+            }
+            ret.emplace_back(edit);
+        }
+        media_start += samples.duration();
+    }
+    return ret;
+}
+
+
+}
+
+
+
+bool concatenate_mp4(
+    Logger& logger,
+    const std::vector<std::string>& inputs,
+    const std::string& output
+){
+    if (inputs.empty()){
+        logger.log("MP4 Concatenate: No inputs.", COLOR_RED);
+        return false;
+    }
+
+    std::vector<InputFile> files(inputs.size());
+    for (size_t c = 0; c < inputs.size(); c++){
+        if (!load_file(logger, inputs[c], files[c])){
+            return false;
+        }
+    }
+
+    //  All inputs must have the same track layout.
+    const InputFile& first = files[0];
+    size_t tracks = first.tracks.size();
+    if (tracks == 0){
+        logger.log("MP4 Concatenate: Inputs have no tracks.", COLOR_RED);
+        return false;
+    }
+    for (const InputFile& file : files){
+        if (file.tracks.size() != tracks){
+            logger.log("MP4 Concatenate: Inputs have different numbers of tracks.", COLOR_RED);
+            return false;
+        }
+        if (file.movie_timescale != first.movie_timescale){
+            logger.log("MP4 Concatenate: Inputs have different movie timescales.", COLOR_RED);
+            return false;
+        }
+        for (size_t t = 0; t < tracks; t++){
+            const TrackSamples& a = first.tracks[t];
+            const TrackSamples& b = file.tracks[t];
+            if (a.handler != b.handler || a.timescale != b.timescale || a.sample_description != b.sample_description){
+                logger.log("MP4 Concatenate: Inputs were encoded with different settings.", COLOR_RED);
+                return false;
+            }
+        }
+    }
+
+    //  Join the sample tables. Chunk offsets are relative to the start of
+    //  the output "mdat" payload for now.
+    std::vector<TrackSamples> joined(tracks);
+    uint64_t mdat_bytes = 0;
+    for (size_t t = 0; t < tracks; t++){
+        bool has_ctts = false;
+        bool has_stss = false;
+        for (const InputFile& file : files){
+            has_ctts |= !file.tracks[t].composition_offsets.empty();
+            has_stss |= !file.tracks[t].sync.empty();
+        }
+        TrackSamples& out = joined[t];
+        for (const InputFile& file : files){
+            const TrackSamples& in = file.tracks[t];
+            out.sizes.insert(out.sizes.end(), in.sizes.begin(), in.sizes.end());
+            out.deltas.insert(out.deltas.end(), in.deltas.begin(), in.deltas.end());
+            if (has_ctts){
+                if (in.composition_offsets.empty()){
+                    out.composition_offsets.insert(out.composition_offsets.end(), in.sizes.size(), 0);
+                }else{
+                    out.composition_offsets.insert(out.composition_offsets.end(), in.composition_offsets.begin(), in.composition_offsets.end());
+                }
+            }
+            if (has_stss){
+                if (in.sync.empty()){
+                    out.sync.insert(out.sync.end(), in.sizes.size(), true);
+                }else{
+                    out.sync.insert(out.sync.end(), in.sync.begin(), in.sync.end());
+                }
+            }
+        }
+    }
+
+    //  Lay out the chunks of each input in their original interleaving.
+    struct CopyOp{
+        size_t file;
+        uint64_t source;
+        uint64_t bytes;
+    };
+    std::vector<CopyOp> copies;
+    for (size_t f = 0; f < files.size(); f++){
+        struct Ref{
+            uint64_t offset;
+            size_t track;
+            size_t chunk;
+        };
+        std::vector<Ref> order;
+        for (size_t t = 0; t < tracks; t++){
+            const std::vector<Chunk>& chunks = files[f].tracks[t].chunks;
+            for (size_t c = 0; c < chunks.size(); c++){
+                order.emplace_back(Ref{chunks[c].offset, t, c});
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [](const Ref& a, const Ref& b){
+            return a.offset < b.offset;
+        });
+
+        std::vector<size_t> base(tracks);
+        for (size_t t = 0; t < tracks; t++){
+            base[t] = joined[t].chunks.size();
+            joined[t].chunks.resize(base[t] + files[f].tracks[t].chunks.size());
+        }
+        for (const Ref& ref : order){
+            const Chunk& chunk = files[f].tracks[ref.track].chunks[ref.chunk];
+            joined[ref.track].chunks[base[ref.track] + ref.chunk] = Chunk{mdat_bytes, chunk.samples, chunk.bytes};
+            copies.emplace_back(CopyOp{f, chunk.offset, chunk.bytes});
+            mdat_bytes += chunk.bytes;
+        }
+    }
+
+    //  Rebuild the movie header from the first input.
+    Box moov = first.moov;
+    Box* mvhd = moov.find(box_type("mvhd"));
+    uint32_t movie_timescale = first.movie_timescale;
+
+    //  Fragment descriptions from the originals no longer apply.
+    moov.children.erase(
+        std::remove_if(
+            moov.children.begin(), moov.children.end(),
+            [](const Box& box){ return box.type == box_type("mvex"); }
+        ),
+        moov.children.end()
+    );
+
+    std::vector<Box*> stbls;
+    std::vector<uint64_t> movie_durations;
+    size_t t = 0;
+    for (Box& trak : moov.children){
+        if (trak.type != box_type("trak")){
+            continue;
+        }
+        const TrackSamples& samples = joined[t];
+        uint64_t media_duration = samples.duration();
+
+        //  Replace the edit list. It goes right after "tkhd".
+        std::vector<Mp4Edit> edits = join_edit_lists(files, t, movie_timescale);
+        uint64_t movie_duration = edit_duration(edits);
+        trak.children.erase(
+            std::remove_if(
+                trak.children.begin(), trak.children.end(),
+                [](const Box& box){ return box.type == box_type("edts"); }
+            ),
+            trak.children.end()
+        );
+        Box edts;
+        edts.type = box_type("edts");
+        edts.container = true;
+        edts.children.emplace_back(leaf("elst", build_elst(edits)));
+        auto tkhd_iter = std::find_if(
+            trak.children.begin(), trak.children.end(),
+            [](const Box& box){ return box.type == box_type("tkhd"); }
+        );
+        trak.children.insert(
+            tkhd_iter == trak.children.end() ? trak.children.begin() : tkhd_iter + 1,
+            std::move(edts)
+        );
+
+        Box* tkhd = trak.find(box_type("tkhd"));
+        if (tkhd != nullptr){
+            patch_duration(tkhd->payload, 20, 28, movie_duration);
+        }
+        movie_durations.emplace_back(movie_duration);
+
+        Box* mdia = trak.find(box_type("mdia"));
+        Box* mdhd = mdia->find(box_type("mdhd"));
+        Box* stbl = mdia->find(box_type("minf"))->find(box_type("stbl"));
+        patch_duration(mdhd->payload, 16, 24, media_duration);
+
+        //  Replace the sample tables. Sample groups and the like from the
+        //  originals are dropped since they index the old samples.
+        Box stsd = *stbl->find(box_type("stsd"));
+        stbl->children.clear();
+        stbl->children.emplace_back(std::move(stsd));
+        stbl->children.emplace_back(leaf("stts", build_stts(samples.deltas)));
+        if (!samples.composition_offsets.empty()){
+            stbl->children.emplace_back(leaf("ctts", build_ctts(samples.composition_offsets)));
+        }
+        if (!samples.sync.empty()){
+            stbl->children.emplace_back(leaf("stss", build_stss(samples.sync)));
+        }
+        stbl->children.emplace_back(leaf("stsc", build_stsc(samples.chunks)));
+        stbl->children.emplace_back(leaf("stsz", build_stsz(samples.sizes)));
+        stbls.emplace_back(stbl);
+        t++;
+    }
+    patch_duration(mvhd->payload, 16, 24, *std::max_element(movie_durations.begin(), movie_durations.end()));
+
+    //  Now that the size of everything before the samples is known, resolve
+    //  the chunk offsets. The offset table's own size depends only on whether
+    //  we need 64-bit offsets.
+    uint64_t mdat_header = mdat_bytes + 8 > 0xffffffff ? 16 : 8;
+    auto add_offsets = [&](bool large){
+        for (size_t c = 0; c < tracks; c++){
+            stbls[c]->children.emplace_back(
+                large
+                    ? leaf("co64", build_chunk_offsets(joined[c].chunks, true))
+                    : leaf("stco", build_chunk_offsets(joined[c].chunks, false))
+            );
+        }
+    };
+    auto remove_offsets = [&]{
+        for (Box* stbl : stbls){
+            stbl->children.pop_back();
+        }
+    };
+    add_offsets(false);
+    uint64_t mdat_start = first.ftyp.size() + moov.size() + mdat_header;
+    bool large = mdat_start + mdat_bytes > 0xffffffff;
+    if (large){
+        remove_offsets();
+        add_offsets(true);
+        mdat_start = first.ftyp.size() + moov.size() + mdat_header;
+    }
+    for (TrackSamples& samples : joined){
+        for (Chunk& chunk : samples.chunks){
+            chunk.offset += mdat_start;
+        }
+    }
+    remove_offsets();
+    add_offsets(large);
+
+    //  Write everything out.
+    std::string header;
+    first.ftyp.serialize(header);
+    moov.serialize(header);
+    if (mdat_header == 16){
+        append_u32(header, 1);
+        append_u32(header, box_type("mdat"));
+        append_u64(header, mdat_bytes + 16);
+    }else{
+        append_u32(header, (uint32_t)(mdat_bytes + 8));
+        append_u32(header, box_type("mdat"));
+    }
+
+    std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+    if (!stream){
+        logger.log("MP4 Concatenate: Unable to open for writing: " + output, COLOR_RED);
+        return false;
+    }
+    stream.write(header.data(), header.size());
+    for (const CopyOp& op : copies){
+        stream.write(files[op.file].data.data() + op.source, op.bytes);
+    }
+    stream.close();
+    if (!stream){
+        logger.log("MP4 Concatenate: Failed to write: " + output, COLOR_RED);
+        return false;
+    }
+    return true;
+}
+
+
+
+bool read_mp4_tracks(
+    Logger& logger,
+    const std::string& filename,
+    uint32_t& movie_timescale,
+    std::vector<Mp4TrackInfo>& tracks
+){
+    InputFile file;
+    if (!load_file(logger, filename, file)){
+        return false;
+    }
+
+    movie_timescale = file.movie_timescale;
+    tracks.clear();
+    for (const TrackSamples& samples : file.tracks){
+        Mp4TrackInfo& info = tracks.emplace_back();
+        info.handler = samples.handler;
+        info.timescale = samples.timescale;
+        info.media_duration = samples.duration();
+        info.edits = samples.edits;
+
+        //  FNV-1a of each sample.
+        size_t sample = 0;
+        for (const Chunk& chunk : samples.chunks){
+            const char* ptr = file.data.data() + chunk.offset;
+            for (uint32_t s = 0; s < chunk.samples; s++, sample++){
+                uint32_t hash = 2166136261u;
+                for (uint32_t c = 0; c < samples.sizes[sample]; c++){
+                    hash = (hash ^ (uint8_t)ptr[c]) * 16777619u;
+                }
+                info.sample_checksums.emplace_back(hash);
+                ptr += samples.sizes[sample];
+            }
+        }
+    }
+    return true;
+}
+
+
+
+}
@@ -0,0 +1,37 @@
+/*  MP4 Concatenator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Join a sequence of MP4 files that came out of the same encoder
+ *  settings into a single file without re-encoding.
+ *
+ *  Every input must have the same tracks in the same order with identical
+ *  sample descriptions (codec, resolution, sample rate). Each input should
+ *  start on a keyframe, which is always the case for a fresh recording.
+ *
+ *  Each input keeps its own edit list in the output. The AAC priming samples
+ *  that the encoder puts at the start of every input are skipped at each seam
+ *  the same way they are at the start of the first one.
+ *
+ */
+
+#ifndef PokemonAutomation_Recording_Mp4Concatenator_H
+#define PokemonAutomation_Recording_Mp4Concatenator_H
+
+#include <string>
+#include <vector>
+#include "Common/Cpp/AbstractLogger.h"
+
+namespace PokemonAutomation{
+
+
+//  Returns false and logs the reason if the inputs cannot be joined.
+bool concatenate_mp4(
+    Logger& logger,
+    const std::vector<std::string>& inputs,
+    const std::string& output
+);
+
+
+}
+#endif
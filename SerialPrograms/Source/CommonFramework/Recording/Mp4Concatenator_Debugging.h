@@ -0,0 +1,48 @@
+/*  MP4 Concatenator Debugging
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      What concatenate_mp4() sees when it parses a file. Only for tests and
+ *  debugging. Not part of the concatenator's interface.
+ *
+ */
+
+#ifndef PokemonAutomation_Recording_Mp4Concatenator_Debugging_H
+#define PokemonAutomation_Recording_Mp4Concatenator_Debugging_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Common/Cpp/AbstractLogger.h"
+
+namespace PokemonAutomation{
+
+
+//  One entry of an edit list. "media_time" is -1 for an empty edit.
+struct Mp4Edit{
+    uint64_t duration;      //  Movie timescale.
+    int64_t media_time;     //  Media timescale.
+    uint32_t rate;          //  16.16 fixed point.
+};
+
+//  What concatenate_mp4() reads from each track.
+struct Mp4TrackInfo{
+    uint32_t handler = 0;           //  "vide", "soun", ...
+    uint32_t timescale = 0;
+    uint64_t media_duration = 0;
+    std::vector<Mp4Edit> edits;     //  Empty if the track has no edit list.
+    std::vector<uint32_t> sample_checksums;
+};
+
+//  Read the tracks of an MP4 file. Returns false and logs the reason if the
+//  file cannot be parsed.
+bool read_mp4_tracks(
+    Logger& logger,
+    const std::string& filename,
+    uint32_t& movie_timescale,
+    std::vector<Mp4TrackInfo>& tracks
+);
+
+
+}
+#endif
@@ -31,6 +31,13 @@ public:
 
 public:
     virtual void on_samples(const float* data, size_t frames) override;
+
+    //  The recording wants every frame, but a short stall in the encoder
+    //  shouldn't hold up capture. Buffer a few frames and drop the oldest
+    //  beyond that.
+    virtual QueueSettings frame_queue_settings() const override{
+        return {QueuePolicy::DROP_OLDEST, 8};
+    }
     virtual void on_frame(std::shared_ptr<const VideoFrame> frame) override;
 
 public:
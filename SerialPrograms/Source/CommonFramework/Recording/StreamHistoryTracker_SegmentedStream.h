@@ -0,0 +1,201 @@
+/*  Stream History Tracker
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Implement by running a single recording that is cut into short segments.
+ *  Each segment is a fresh recording, so it starts on a keyframe. Segments
+ *  that are entirely older than X seconds are dropped from the front.
+ *
+ *  When saving, the retained segments are joined into one file without
+ *  re-encoding.
+ *
+ *  Compared to running two recordings in parallel, this encodes everything
+ *  once. The only overlap is while a finished segment flushes what it had
+ *  already buffered.
+ *
+ */
+
+#ifndef PokemonAutomation_StreamHistoryTracker_SegmentedStream_H
+#define PokemonAutomation_StreamHistoryTracker_SegmentedStream_H
+
+#include <deque>
+#include <QDir>
+#include <QFile>
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/AbstractLogger.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/VideoPipeline/Backends/VideoFrameQt.h"
+#include "Mp4Concatenator.h"
+#include "StreamRecorder.h"
+
+namespace PokemonAutomation{
+
+
+
+class StreamHistoryTracker{
+    //  How many segments make up one window. More segments means less
+    //  overshoot past the window in the saved file, but more cuts.
+    static constexpr int SEGMENTS_PER_WINDOW = 3;
+    static constexpr std::chrono::seconds MIN_SEGMENT_LENGTH = std::chrono::seconds(5);
+
+    struct Segment{
+        WallClock start;
+        std::unique_ptr<StreamRecording> recording;
+    };
+
+public:
+    StreamHistoryTracker(
+        Logger& logger,
+        std::chrono::seconds window,
+        size_t audio_samples_per_frame,
+        size_t audio_frames_per_second,
+        bool has_video
+    )
+        : m_logger(logger)
+        , m_window(window)
+        , m_audio_samples_per_frame(audio_samples_per_frame)
+        , m_audio_frames_per_second(audio_frames_per_second)
+        , m_has_video(has_video)
+    {
+        update_segments(current_time());
+    }
+    void set_window(std::chrono::seconds window){
+        SpinLockGuard lg(m_lock);
+        m_window = window;
+        update_segments(current_time());
+    }
+
+    bool save(const std::string& filename){
+        std::deque<Segment> segments;
+        {
+            SpinLockGuard lg(m_lock);
+            if (m_segments.empty()){
+                m_logger.log("Cannot save stream history. Recording is not enabled.", COLOR_RED);
+                return false;
+            }
+
+            m_logger.log("Saving stream history...", COLOR_BLUE);
+
+            //  Take everything we have and immediately start a new history.
+            segments = std::move(m_segments);
+            m_segments.clear();
+            update_segments(current_time());
+        }
+
+        std::string base = GlobalSettings::instance().TEMP_FOLDER;
+        base += now_to_filestring() + "-history-";
+        const char* extension = m_has_video ? ".mp4" : ".m4a";
+
+        std::vector<std::string> files;
+        for (size_t c = 0; c < segments.size(); c++){
+            std::string path = base + std::to_string(c) + extension;
+            if (segments[c].recording->stop_and_save(path)){
+                files.emplace_back(std::move(path));
+            }else{
+                m_logger.log("Unable to finalize stream history segment.", COLOR_RED);
+            }
+        }
+        segments.clear();
+
+        bool ret;
+        if (files.empty()){
+            ret = false;
+        }else if (files.size() == 1){
+            ret = move_file(files[0], filename);
+        }else{
+            ret = concatenate_mp4(m_logger, files, filename);
+            if (!ret){
+                m_logger.log("Unable to join stream history. Saving only the most recent segment.", COLOR_RED);
+                ret = move_file(files.back(), filename);
+            }
+        }
+
+        for (const std::string& file : files){
+            QFile::remove(QString::fromStdString(file));
+        }
+        return ret;
+    }
+
+
+    void on_samples(const float* samples, size_t frames){
+        WallClock now = current_time();
+        SpinLockGuard lg(m_lock);
+        update_segments(now);
+        m_segments.back().recording->push_samples(now, samples, frames);
+    }
+    void on_frame(std::shared_ptr<const VideoFrame> frame){
+        WallClock now = current_time();
+        SpinLockGuard lg(m_lock);
+        update_segments(now);
+        m_segments.back().recording->push_frame(std::move(frame));
+    }
+
+
+private:
+    static bool move_file(const std::string& from, const std::string& to){
+        QDir().remove(QString::fromStdString(to));
+        return QDir().rename(QString::fromStdString(from), QString::fromStdString(to));
+    }
+
+    std::chrono::milliseconds segment_length() const{
+        return std::max<std::chrono::milliseconds>(m_window / SEGMENTS_PER_WINDOW, MIN_SEGMENT_LENGTH);
+    }
+    void start_segment(WallClock now){
+        m_segments.emplace_back(Segment{
+            now,
+            std::make_unique<StreamRecording>(
+                m_logger, std::chrono::milliseconds(500),
+                now,
+                m_audio_samples_per_frame,
+                m_audio_frames_per_second,
+                m_has_video
+            )
+        });
+    }
+
+    void update_segments(WallClock now){
+        //  Must call under the lock.
+
+        //  If the clock went backwards, none of the history makes sense.
+        if (!m_segments.empty() && m_segments.back().start > now){
+            m_segments.clear();
+        }
+
+        if (m_segments.empty()){
+            start_segment(now);
+            return;
+        }
+
+        //  Cut a new segment. The old one keeps encoding whatever it has
+        //  buffered and then finalizes on its own thread.
+        if (now - m_segments.back().start >= segment_length()){
+            m_segments.back().recording->finish();
+            start_segment(now);
+        }
+
+        //  Drop the oldest segment once the one after it alone reaches back
+        //  far enough to cover the window.
+        WallClock threshold = now - m_window;
+        while (m_segments.size() >= 2 && m_segments[1].start <= threshold){
+            m_segments.pop_front();
+        }
+    }
+
+
+private:
+    Logger& m_logger;
+    mutable SpinLock m_lock;
+    std::chrono::milliseconds m_window;
+    const size_t m_audio_samples_per_frame;
+    const size_t m_audio_frames_per_second;
+    const bool m_has_video;
+
+    //  Ordered by start time. The last one is the one being recorded into.
+    std::deque<Segment> m_segments;
+};
+
+
+
+}
+#endif
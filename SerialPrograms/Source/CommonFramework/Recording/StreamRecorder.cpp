@@ -104,11 +104,18 @@ StreamRecording::~StreamRecording(){
 #endif
 }
 
+void StreamRecording::finish(){
+    auto scope_check = m_santizer.check_scope();
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_finishing = true;
+    m_cv.notify_all();
+}
 bool StreamRecording::stop_and_save(const std::string& filename){
     auto scope_check = m_santizer.check_scope();
     {
+        //  Drain what's already been buffered so the file doesn't end early.
         std::lock_guard<std::mutex> lg(m_lock);
-        m_stopping = true;
+        m_finishing = true;
 //        cout << "signalling: stop_and_save()" << endl;
         m_cv.notify_all();
     }
@@ -135,7 +142,7 @@ void StreamRecording::push_samples(WallClock timestamp, const float* data, size_
     WallClock threshold = timestamp - m_buffer_limit;
 
     std::lock_guard<std::mutex> lg(m_lock);
-    if (m_stopping){
+    if (m_stopping || m_finishing){
         return;
     }
 
@@ -175,7 +182,7 @@ void StreamRecording::push_frame(std::shared_ptr<const VideoFrame> frame){
     WallClock threshold = frame->timestamp - m_buffer_limit;
 
     std::lock_guard<std::mutex> lg(m_lock);
-    if (m_stopping){
+    if (m_stopping || m_finishing){
         return;
     }
 
@@ -356,6 +363,10 @@ void StreamRecording::internal_run(){
             }
 
             if (!current_audio.is_valid() && !current_frame){
+                //  Everything has been handed to the encoder.
+                if (m_finishing){
+                    break;
+                }
 //                cout << "sleeping 0..." << endl;
                 m_cv.wait(lg);
 //                cout << "waking 0..." << endl;
@@ -123,6 +123,10 @@ public:
     void push_samples(WallClock timestamp, const float* data, size_t frames);
     void push_frame(std::shared_ptr<const VideoFrame> frame);
 
+    //  Stop accepting new input. Whatever is already buffered is still
+    //  encoded, then the file is finalized in the background.
+    void finish();
+
     bool stop_and_save(const std::string& filename);
 
 private:
@@ -145,6 +149,7 @@ private:
     std::condition_variable m_cv;
 
     bool m_stopping = false;
+    bool m_finishing = false;
     WallClock m_last_drop;
 
     std::deque<AudioBlock> m_buffered_audio;
@@ -16,6 +16,7 @@
 #include "Common/Cpp/AbstractLogger.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/ProgramStats/StatsDatabase.h"
 #include "SetupSettings.h"
 
 #include <iostream>
@@ -90,25 +91,36 @@ bool migrate_stats(Logger& logger){
 
     // old location: current working directory
     QFile cur_dir_file(QString::fromStdString(path));
+    QFile cur_dir_journal(QString::fromStdString(stats_journal_path(path)));
     // new location: 
     QFile folder_file(QString::fromStdString(new_path));
 
-    if (!cur_dir_file.exists() && !folder_file.exists()){
+    // Runs that haven't been compacted yet only exist in the journal.
+    const bool cur_dir_exists = cur_dir_file.exists() || cur_dir_journal.exists();
+
+    if (!cur_dir_exists && !folder_file.exists()){
         logger.log("Clean install, nothing to migrate.");
         return true;
     }
 
-    if (!cur_dir_file.exists() && folder_file.exists()){
+    if (!cur_dir_exists && folder_file.exists()){
         logger.log("File migrated. Stats path in settings not updated. Updating...");
         GlobalSettings::instance().STATS_FILE.restore_defaults();
         return true;
     }
 
-    if (cur_dir_file.exists() && !folder_file.exists()){
-        logger.log("Migrating old stats file to the folder...");
-        cur_dir_file.copy(folder_file.fileName());
+    if (cur_dir_exists && !folder_file.exists()){
+        logger.log("Migrating old stats file and its journal to the folder...");
+        StatSet stats;
+        stats.open_from_file(path);
+        stats.save_to_file(new_path);
         logger.log("Renaming old stats file as backup...");
-        cur_dir_file.rename(cur_dir_file.fileName() + ".bak");
+        if (cur_dir_file.exists()){
+            cur_dir_file.rename(cur_dir_file.fileName() + ".bak");
+        }
+        if (cur_dir_journal.exists()){
+            cur_dir_journal.rename(cur_dir_journal.fileName() + ".bak");
+        }
         GlobalSettings::instance().STATS_FILE.restore_defaults();
         logger.log("Migrated.");
         QMessageBox box;
@@ -15,6 +15,7 @@ class ImageViewRGB32;
 class Logger;
 
 // Dump debug image to ./DebugDumps/`path`/<timestamp>-`label`.png
+// The file is written in the background by ScreenshotEncoder.
 // Return image path.
 std::string dump_debug_image(
     Logger& logger,
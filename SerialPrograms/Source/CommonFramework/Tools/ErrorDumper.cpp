@@ -16,6 +16,7 @@
 #include "CommonFramework/ErrorReports/ErrorReports.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 //#include "CommonFramework/VideoPipeline/VideoOverlay.h"
+#include "ScreenshotEncoder.h"
 #include "ErrorDumper.h"
 //#include "ProgramEnvironment.h"
 namespace PokemonAutomation{
@@ -36,7 +37,7 @@ std::string dump_image_alone(
     name += label;
     name += ".png";
     logger.log("Saving failed inference image to: " + name, COLOR_RED);
-    image.save(name);
+    ScreenshotEncoder::instance().save(logger, image, name);
     return name;
 }
 void dump_image(
@@ -0,0 +1,172 @@
+/*  Screenshot Encoder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include <QFile>
+#include <QImage>
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Options/Environment/PerformanceOptions.h"
+#include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "ScreenshotEncoder.h"
+
+namespace PokemonAutomation{
+
+
+
+PendingScreenshot::PendingScreenshot(std::string filepath)
+    : m_filepath(std::move(filepath))
+    , m_finished(false)
+    , m_success(false)
+    , m_discarded(false)
+{}
+bool PendingScreenshot::is_finished() const{
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_finished;
+}
+bool PendingScreenshot::wait() const{
+    std::unique_lock<std::mutex> lg(m_lock);
+    m_cv.wait(lg, [this]{ return m_finished; });
+    return m_success;
+}
+bool PendingScreenshot::discard(){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_discarded = true;
+    return m_finished;
+}
+bool PendingScreenshot::report_finished(bool success){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_finished = true;
+    m_success = success;
+    m_cv.notify_all();
+    return m_discarded;
+}
+
+
+
+ScreenshotEncoder& ScreenshotEncoder::instance(){
+    static ScreenshotEncoder encoder;
+    return encoder;
+}
+ScreenshotEncoder::ScreenshotEncoder()
+    : m_stopping(false)
+{
+    //  Make sure the logger outlives us. The thread may still log while
+    //  draining the queue at shutdown.
+    global_logger_tagged();
+    m_thread = Thread([this]{ thread_loop(); });
+}
+ScreenshotEncoder::~ScreenshotEncoder(){
+    //  Anything still queued is finished first. Error dumps shouldn't be lost
+    //  just because the program is closing.
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopping = true;
+        m_cv.notify_all();
+    }
+    m_thread.join();
+}
+
+std::shared_ptr<PendingScreenshot> ScreenshotEncoder::save(
+    Logger& logger,
+    std::shared_ptr<const ImageRGB32> image,
+    std::string filepath,
+    const ScreenshotEncodeOptions& options
+){
+    std::shared_ptr<PendingScreenshot> handle = std::make_shared<PendingScreenshot>(std::move(filepath));
+    if (!image || !*image){
+        logger.log("Screenshot is null.", COLOR_ORANGE);
+        handle->report_finished(false);
+        return handle;
+    }
+
+    std::unique_lock<std::mutex> lg(m_lock);
+    if (m_queue.size() >= MAX_QUEUE_SIZE){
+        logger.log("Screenshot encoder is backed up. Waiting...", COLOR_ORANGE);
+        m_cv.wait(lg, [this]{ return m_queue.size() < MAX_QUEUE_SIZE; });
+    }
+    m_queue.emplace_back(Job{std::move(image), options, handle});
+    m_cv.notify_all();
+    return handle;
+}
+std::shared_ptr<PendingScreenshot> ScreenshotEncoder::save(
+    Logger& logger,
+    const VideoSnapshot& snapshot,
+    std::string filepath,
+    const ScreenshotEncodeOptions& options
+){
+    return save(logger, snapshot.frame, std::move(filepath), options);
+}
+std::shared_ptr<PendingScreenshot> ScreenshotEncoder::save(
+    Logger& logger,
+    const ImageViewRGB32& image,
+    std::string filepath,
+    const ScreenshotEncodeOptions& options
+){
+    std::shared_ptr<const ImageRGB32> copy;
+    if (image){
+        copy = std::make_shared<const ImageRGB32>(image.copy());
+    }
+    return save(logger, std::move(copy), std::move(filepath), options);
+}
+
+
+bool ScreenshotEncoder::encode(const Job& job){
+    const ImageRGB32& image = *job.image;
+    const ScreenshotEncodeOptions& options = job.options;
+
+    size_t width = image.width();
+    size_t height = image.height();
+    if (options.max_width != 0 && width > options.max_width){
+        height = std::max<size_t>(height * options.max_width / width, 1);
+        width = options.max_width;
+    }
+    if (options.max_height != 0 && height > options.max_height){
+        width = std::max<size_t>(width * options.max_height / height, 1);
+        height = options.max_height;
+    }
+
+    QString path = QString::fromStdString(job.handle->filepath());
+    if (width == image.width() && height == image.height()){
+        return image.to_QImage_ref().save(path, nullptr, options.quality);
+    }
+    ImageRGB32 scaled(width, height);
+    image.scale_to(scaled, ImageScaleMode::AREA);
+    return scaled.to_QImage_ref().save(path, nullptr, options.quality);
+}
+void ScreenshotEncoder::thread_loop(){
+    GlobalSettings::instance().PERFORMANCE->COMPUTE_PRIORITY.set_on_this_thread(global_logger_tagged());
+
+    while (true){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lg(m_lock);
+            m_cv.wait(lg, [this]{ return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()){
+                return;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_cv.notify_all();
+        }
+
+        bool success = false;
+        try{
+            success = encode(job);
+        }catch (...){}
+
+        if (!success){
+            global_logger_tagged().log("Unable to save screenshot to: " + job.handle->filepath(), COLOR_RED);
+        }
+        if (job.handle->report_finished(success)){
+            QFile(QString::fromStdString(job.handle->filepath())).remove();
+        }
+    }
+}
+
+
+
+}
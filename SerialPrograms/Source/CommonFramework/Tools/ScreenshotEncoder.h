@@ -0,0 +1,131 @@
+/*  Screenshot Encoder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Write screenshots to disk without blocking the calling thread.
+ *
+ *  PNG-encoding a 1080p frame takes long enough to throw off timing-sensitive
+ *  programs. This hands the work to a background thread instead. The caller
+ *  gets back a handle that can be waited on by whoever needs the file.
+ *
+ *  The queue is bounded. If it is full, "save()" blocks until there's room.
+ *
+ */
+
+#ifndef PokemonAutomation_ScreenshotEncoder_H
+#define PokemonAutomation_ScreenshotEncoder_H
+
+#include <memory>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+
+namespace PokemonAutomation{
+
+class Logger;
+struct VideoSnapshot;
+
+
+struct ScreenshotEncodeOptions{
+    //  If non-zero, shrink the image (keeping aspect ratio) to fit inside
+    //  these dimensions before encoding.
+    size_t max_width = 0;
+    size_t max_height = 0;
+
+    //  Passed to QImage::save(). [0, 100] or -1 for the format's default.
+    //  For PNG this only trades file size for encode time.
+    int quality = -1;
+};
+
+
+//  A file that is being written in the background.
+class PendingScreenshot{
+public:
+    PendingScreenshot(std::string filepath);
+
+    const std::string& filepath() const{ return m_filepath; }
+
+    bool is_finished() const;
+
+    //  Block until the file has been written.
+    //  Returns false if it could not be written.
+    bool wait() const;
+
+    //  The file is no longer wanted. If it has already been written, this
+    //  returns true and the caller should delete it. Otherwise it returns
+    //  false and the encoder deletes it after writing it.
+    bool discard();
+
+    //  Returns true if the file was discarded before it finished.
+    bool report_finished(bool success);
+
+private:
+    const std::string m_filepath;
+    bool m_finished;
+    bool m_success;
+    bool m_discarded;
+    mutable std::mutex m_lock;
+    mutable std::condition_variable m_cv;
+};
+
+
+class ScreenshotEncoder{
+public:
+    static ScreenshotEncoder& instance();
+    ~ScreenshotEncoder();
+
+    //  Queue "image" to be written to "filepath". The format is deduced from
+    //  the extension.
+    std::shared_ptr<PendingScreenshot> save(
+        Logger& logger,
+        std::shared_ptr<const ImageRGB32> image,
+        std::string filepath,
+        const ScreenshotEncodeOptions& options = {}
+    );
+
+    //  Shares the snapshot's frame. No copy is made.
+    std::shared_ptr<PendingScreenshot> save(
+        Logger& logger,
+        const VideoSnapshot& snapshot,
+        std::string filepath,
+        const ScreenshotEncodeOptions& options = {}
+    );
+
+    //  The view is not owned. So this makes a copy. (which is much faster
+    //  than encoding it)
+    std::shared_ptr<PendingScreenshot> save(
+        Logger& logger,
+        const ImageViewRGB32& image,
+        std::string filepath,
+        const ScreenshotEncodeOptions& options = {}
+    );
+
+
+private:
+    struct Job{
+        std::shared_ptr<const ImageRGB32> image;
+        ScreenshotEncodeOptions options;
+        std::shared_ptr<PendingScreenshot> handle;
+    };
+
+    ScreenshotEncoder();
+    void thread_loop();
+    static bool encode(const Job& job);
+
+private:
+    static constexpr size_t MAX_QUEUE_SIZE = 4;
+
+    bool m_stopping;
+    std::deque<Job> m_queue;
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    Thread m_thread;
+};
+
+
+
+}
+#endif
@@ -45,7 +45,7 @@ void SnapshotManager::convert(uint64_t seqnum, QVideoFrame frame, WallClock time
     snapshot.timestamp = timestamp;
     try{
         WallClock time0 = current_time();
-        snapshot.frame = std::make_shared<const ImageRGB32>(frame_to_image(frame));
+        snapshot = VideoSnapshot(frame_to_image(frame), timestamp);
         WallClock time1 = current_time();
         uint32_t microseconds = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
         m_stats_conversion.report_data(m_logger, microseconds);
@@ -5,19 +5,21 @@
  */
 
 #include "Common/Cpp/Time.h"
+#include "ProcessUtilizationSampler.h"
 #include "CpuUtilizationStats.h"
 
 namespace PokemonAutomation{
 
 
 CpuUtilizationStat::CpuUtilizationStat()
-    : m_last_clock(SystemCpuTime::now())
+    : m_last_clock(ProcessUtilizationSampler::instance().get().cpu)
 {}
 OverlayStatSnapshot CpuUtilizationStat::get_current(){
     std::lock_guard<std::mutex> lg(m_lock);
 
-    WallClock now = current_time();
-    SystemCpuTime current = SystemCpuTime::now();
+    ProcessUtilizationSnapshot snapshot = ProcessUtilizationSampler::instance().get();
+    WallClock now = snapshot.timestamp;
+    const SystemCpuTime& current = snapshot.cpu;
     size_t vcores = SystemCpuTime::vcores();
     if (vcores == 0 || !current.is_valid()){
         return OverlayStatSnapshot{"CPU Utilization: ---"};
@@ -5,7 +5,7 @@
  */
 
 #include "Common/Cpp/PrettyPrint.h"
-#include "Common/Cpp/MemoryUtilization/MemoryUtilization.h"
+#include "ProcessUtilizationSampler.h"
 #include "MemoryUtilizationStats.h"
 
 namespace PokemonAutomation{
@@ -22,7 +22,7 @@ OverlayStatSnapshot MemoryUtilizationStat::get_current(){
 
 
 void MemoryUtilizationStats::update(){
-    MemoryUsage memory = process_memory_usage();
+    MemoryUsage memory = ProcessUtilizationSampler::instance().get().memory;
 
     double usage;
 
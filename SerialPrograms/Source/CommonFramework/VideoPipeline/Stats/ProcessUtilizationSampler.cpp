@@ -0,0 +1,64 @@
+/*  Process Utilization Sampler
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "ProcessUtilizationSampler.h"
+
+namespace PokemonAutomation{
+
+
+
+ProcessUtilizationSampler& ProcessUtilizationSampler::instance(){
+    static ProcessUtilizationSampler sampler;
+    return sampler;
+}
+
+bool ProcessUtilizationSampler::is_fresh() const{
+    return m_snapshot.timestamp != WallClock::min()
+        && current_time() - m_snapshot.timestamp < MAX_AGE;
+}
+
+ProcessUtilizationSnapshot ProcessUtilizationSampler::get(){
+    {
+        ReadSpinLock lg(m_lock, "ProcessUtilizationSampler::get()");
+        if (is_fresh()){
+            return m_snapshot;
+        }
+    }
+
+    std::unique_lock<std::mutex> lg(m_sample_lock, std::try_to_lock);
+    if (!lg.owns_lock()){
+        //  Someone else is already sampling. Use the previous snapshot
+        //  unless there isn't one yet.
+        {
+            ReadSpinLock lg1(m_lock, "ProcessUtilizationSampler::get()");
+            if (m_snapshot.timestamp != WallClock::min()){
+                return m_snapshot;
+            }
+        }
+        lg.lock();
+    }
+
+    //  It may have been refreshed while we were waiting for the lock.
+    {
+        ReadSpinLock lg1(m_lock, "ProcessUtilizationSampler::get()");
+        if (is_fresh()){
+            return m_snapshot;
+        }
+    }
+
+    ProcessUtilizationSnapshot snapshot;
+    snapshot.cpu = SystemCpuTime::now();
+    snapshot.memory = process_memory_usage();
+    snapshot.timestamp = current_time();
+
+    WriteSpinLock lg1(m_lock, "ProcessUtilizationSampler::get()");
+    m_snapshot = snapshot;
+    return snapshot;
+}
+
+
+
+}
@@ -0,0 +1,62 @@
+/*  Process Utilization Sampler
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      A single process-wide source of CPU and memory samples for the overlay
+ *  stats. Every console overlay reads the same snapshot so the cost of
+ *  sampling doesn't grow with the number of open consoles.
+ *
+ */
+
+#ifndef PokemonAutomation_ProcessUtilizationSampler_H
+#define PokemonAutomation_ProcessUtilizationSampler_H
+
+#include <mutex>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/CpuUtilization/CpuUtilization.h"
+#include "Common/Cpp/MemoryUtilization/MemoryUtilization.h"
+
+namespace PokemonAutomation{
+
+
+
+struct ProcessUtilizationSnapshot{
+    WallClock timestamp = WallClock::min();
+    SystemCpuTime cpu;
+    MemoryUsage memory;
+};
+
+
+class ProcessUtilizationSampler{
+public:
+    //  Overlays refresh every 100ms. Anything newer than this is reused.
+    static constexpr std::chrono::milliseconds MAX_AGE = std::chrono::milliseconds(50);
+
+public:
+    static ProcessUtilizationSampler& instance();
+
+    //  Return the latest snapshot. If it's stale, the first caller to notice
+    //  takes a new sample. Everyone else gets the previous one rather than
+    //  waiting.
+    ProcessUtilizationSnapshot get();
+
+private:
+    ProcessUtilizationSampler() = default;
+
+    //  Must hold "m_lock".
+    bool is_fresh() const;
+
+private:
+    //  Held by whoever is taking a new sample.
+    std::mutex m_sample_lock;
+
+    //  Protects "m_snapshot".
+    SpinLock m_lock;
+    ProcessUtilizationSnapshot m_snapshot;
+};
+
+
+
+}
+#endif
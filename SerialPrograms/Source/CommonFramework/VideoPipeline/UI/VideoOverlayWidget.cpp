@@ -6,6 +6,8 @@
 
 #include <QPainter>
 #include <QResizeEvent>
+#include <QScreen>
+#include <QTimer>
 #include "CommonFramework/GlobalServices.h"
 #include "VideoOverlayWidget.h"
 
@@ -31,10 +33,8 @@ VideoOverlayWidget::~VideoOverlayWidget(){
 VideoOverlayWidget::VideoOverlayWidget(QWidget& parent, VideoOverlaySession& session)
     : QWidget(&parent)
     , m_session(session)
-    , m_boxes(std::make_shared<std::vector<OverlayBox>>(session.boxes()))
-    , m_texts(std::make_shared<std::vector<OverlayText>>(session.texts()))
-    , m_images(std::make_shared<std::vector<OverlayImage>>(session.images()))
-    , m_log(std::make_shared<std::vector<OverlayLogLine>>(session.log_texts()))
+    , m_last_paint(WallClock::min())
+    , m_update_pending(false)
 //    , m_stats(nullptr)
     , m_stats_paint(
         "VideoOverlayWidget::paintEvent",
@@ -57,28 +57,39 @@ VideoOverlayWidget::VideoOverlayWidget(QWidget& parent, VideoOverlaySession& ses
 }
 
 void VideoOverlayWidget::async_update(){
+    //  Already queued. The paint will pick up this change too.
+    if (m_update_pending.exchange(true, std::memory_order_acq_rel)){
+        return;
+    }
     // by using QMetaObject::invokeMethod, we can call this->update() on a non-main thread
     // without trigger Qt crash, as normally this->update() can only be called on the main
     // thread.
-    QMetaObject::invokeMethod(this, [this]{ this->update(); });
+    QMetaObject::invokeMethod(this, [this]{ schedule_update(); });
 }
+void VideoOverlayWidget::schedule_update(){
+    if (m_timer_pending){
+        return;
+    }
 
-void VideoOverlayWidget::on_overlay_update_boxes(const std::shared_ptr<const std::vector<OverlayBox>>& boxes){
-    WriteSpinLock lg(m_lock, "VideoOverlay::update_boxes()");
-    m_boxes = boxes;
-}
-void VideoOverlayWidget::on_overlay_update_text(const std::shared_ptr<const std::vector<OverlayText>>& texts){
-    WriteSpinLock lg(m_lock, "VideoOverlay::update_text()");
-    m_texts = texts;
-}
-void VideoOverlayWidget::on_overlay_update_images(const std::shared_ptr<const std::vector<OverlayImage>>& images){
-    WriteSpinLock lg(m_lock, "VideoOverlay::update_images()");
-    m_images = images;
-}
+    double refresh_rate = 60;
+    QScreen* screen = this->screen();
+    if (screen != nullptr && screen->refreshRate() > 0){
+        refresh_rate = screen->refreshRate();
+    }
+    auto frame = std::chrono::microseconds((int64_t)(1000000 / refresh_rate));
+
+    auto elapsed = current_time() - m_last_paint;
+    if (elapsed >= frame){
+        this->update();
+        return;
+    }
 
-void VideoOverlayWidget::on_overlay_update_log(const std::shared_ptr<const std::vector<OverlayLogLine>>& logs){
-    WriteSpinLock lg(m_lock, "VideoOverlay::update_log_text()");
-    m_log = logs;
+    m_timer_pending = true;
+    int delay_ms = (int)std::chrono::ceil<std::chrono::milliseconds>(frame - elapsed).count();
+    QTimer::singleShot(delay_ms, this, [this]{
+        m_timer_pending = false;
+        this->update();
+    });
 }
 #if 0
 void VideoOverlayWidget::update_log_background(const std::shared_ptr<const std::vector<VideoOverlaySession::Box>>& bg_boxes){
@@ -88,7 +99,7 @@ void VideoOverlayWidget::update_log_background(const std::shared_ptr<const std::
 #endif
 
 void VideoOverlayWidget::on_watchdog_timeout(){
-    QMetaObject::invokeMethod(this, [this]{ this->update(); });
+    async_update();
 //    static int c = 0;
 //    cout << "VideoOverlayWidget::on_watchdog_timeout(): " << c++ << endl;
 }
@@ -98,11 +109,15 @@ void VideoOverlayWidget::resizeEvent(QResizeEvent* event){}
 
 void VideoOverlayWidget::paintEvent(QPaintEvent*){
     WallClock time0 = current_time();
+    m_last_paint = time0;
+
+    //  Clear before pulling the snapshot so that any change made after this
+    //  point requests another paint.
+    m_update_pending.store(false, std::memory_order_release);
+    m_session.update_snapshot(m_content);
 
     QPainter painter(this);
     {
-        WriteSpinLock lg(m_lock, "VideoOverlay::paintEvent()");
-
         //  The order here is important since the latter ones will go on top
         //  of the earlier ones.
         if (m_session.enabled_images()){
@@ -170,7 +185,7 @@ void VideoOverlayWidget::render_stats(QPainter& painter){
 void VideoOverlayWidget::render_boxes(QPainter& painter){
     const int width = this->width();
     const int height = this->height();
-    for (const auto& item : *m_boxes){
+    for (const auto& item : *m_content.boxes){
         QColor color = QColor((uint32_t)item.color);
         painter.setPen(color);
 //        cout << box->x << " " << box->y << ", " << box->width << " x " << box->height << endl;
@@ -248,7 +263,7 @@ void VideoOverlayWidget::render_boxes(QPainter& painter){
 void VideoOverlayWidget::render_text(QPainter& painter){
     const int width = this->width();
     const int height = this->height();
-    for (const auto& item: *m_texts){
+    for (const auto& item: *m_content.texts){
         painter.setPen(QColor((uint32_t)item.color));
         QFont text_font = this->font();
         text_font.setPointSizeF(item.font_size * height / 100.0);
@@ -264,7 +279,7 @@ void VideoOverlayWidget::render_images(QPainter& painter){
     const double width = static_cast<double>(this->width());
     const double height = static_cast<double>(this->height());
 
-    for(const auto& image_overlay: *m_images){
+    for(const auto& image_overlay: *m_content.images){
         QImage q_image = image_overlay.image.to_QImage_ref();
         // source rect is the entire portion of the q_image, in pixel units
         QRectF source_rect(0.0, 0.0, static_cast<double>(q_image.width()), static_cast<double>(q_image.height()));
@@ -279,7 +294,7 @@ void VideoOverlayWidget::render_images(QPainter& painter){
     }
 }
 void VideoOverlayWidget::render_log(QPainter& painter){
-    if (m_log->empty()){
+    if (m_content.log->empty()){
         return;
     }
 
@@ -312,7 +327,7 @@ void VideoOverlayWidget::render_log(QPainter& painter){
     //  Draw the text lines.
     double x = LOG_MIN_X + LOG_BORDER_X;
     double y = LOG_MAX_Y - LOG_BORDER_Y;
-    for (const OverlayLogLine& item: *m_log){
+    for (const OverlayLogLine& item: *m_content.log){
         painter.setPen(QColor((uint32_t)item.color));
         QFont text_font = this->font();
         text_font.setPointSizeF(height * LOG_FONT_SIZE);
@@ -7,8 +7,9 @@
 #ifndef PokemonAutomation_VideoPipeline_VideoOverlayWidget_H
 #define PokemonAutomation_VideoPipeline_VideoOverlayWidget_H
 
+#include <atomic>
 #include <QWidget>
-#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Time.h"
 #include "Common/Cpp/Concurrency/Watchdog.h"
 #include "CommonFramework/Tools/StatAccumulator.h"
 #include "CommonFramework/VideoPipeline/VideoOverlaySession.h"
@@ -45,14 +46,8 @@ private:
     // callback function from VideoOverlaySession on overlay stats enabled
     virtual void on_overlay_enabled_stats (bool enabled) override{async_update();}
 
-    // callback function from VideoOverlaySession on overlay boxes updated
-    virtual void on_overlay_update_boxes (const std::shared_ptr<const std::vector<OverlayBox>>& boxes) override;
-    // callback function from VideoOverlaySession on overlay text updated
-    virtual void on_overlay_update_text  (const std::shared_ptr<const std::vector<OverlayText>>& texts) override;
-    // callback function from VideoOverlaySession on overlay images updated
-    virtual void on_overlay_update_images(const std::shared_ptr<const std::vector<OverlayImage>>& images) override;
-    // callback function from VideoOverlaySession on overlay images updated
-    virtual void on_overlay_update_log   (const std::shared_ptr<const std::vector<OverlayLogLine>>& logs) override;
+    // callback function from VideoOverlaySession on any overlay content change
+    virtual void on_overlay_content_changed() override{async_update();}
 
     virtual void on_watchdog_timeout() override;
 
@@ -67,7 +62,12 @@ private:
     // listens to video overlay change, to get called on the non-main thread.
     // Since QWidget::update() must be called on the main thread to not crash, we have to use this
     // async_update() to avoid that.
+    //
+    // Any number of calls between two paints queue only one event, and paints
+    // are spaced at least one display refresh apart.
     void async_update();
+    // Runs on the main thread. Calls update() now or when the next frame is due.
+    void schedule_update();
 
     // render overlay stats
     void render_stats  (QPainter& painter);
@@ -83,11 +83,13 @@ private:
 private:
     VideoOverlaySession& m_session;
 
-    SpinLock m_lock;
-    std::shared_ptr<const std::vector<OverlayBox>> m_boxes;
-    std::shared_ptr<const std::vector<OverlayText>> m_texts;
-    std::shared_ptr<const std::vector<OverlayImage>> m_images;
-    std::shared_ptr<const std::vector<OverlayLogLine>> m_log;
+    //  Only accessed from the main thread.
+    VideoOverlaySession::ContentSnapshot m_content;
+    WallClock m_last_paint;
+    bool m_timer_pending = false;
+
+    //  Set when an update has been requested but the paint hasn't started.
+    std::atomic<bool> m_update_pending;
 
     PeriodicStatsReporterI32 m_stats_paint;
 };
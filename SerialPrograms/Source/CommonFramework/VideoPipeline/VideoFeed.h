@@ -7,9 +7,11 @@
 #ifndef PokemonAutomation_VideoFeedInterface_H
 #define PokemonAutomation_VideoFeedInterface_H
 
+#include <stddef.h>
 #include <memory>
 #include "Common/Cpp/Time.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/ImageTools/ImageStatsTable.h"
 
 namespace PokemonAutomation{
 
@@ -22,6 +24,10 @@ struct VideoSnapshot{
     //  This will be as close as possible to when the frame was taken.
     WallClock timestamp = WallClock::min();
 
+    //  Box statistics for "frame". Built on first use and shared by all
+    //  copies of this snapshot. Null if the snapshot doesn't offer one.
+    std::shared_ptr<ImageStatsTableCache> stats_table;
+
     VideoSnapshot()
          : frame(std::make_shared<const ImageRGB32>())
          , timestamp(WallClock::min())
@@ -29,6 +35,7 @@ struct VideoSnapshot{
     VideoSnapshot(ImageRGB32 p_frame, WallClock p_timestamp)
          : frame(std::make_shared<const ImageRGB32>(std::move(p_frame)))
          , timestamp(p_timestamp)
+         , stats_table(std::make_shared<ImageStatsTableCache>())
     {}
 
     //  Returns true if the snapshot is valid.
@@ -42,6 +49,7 @@ struct VideoSnapshot{
     void clear(){
         frame.reset();
         timestamp = WallClock::min();
+        stats_table.reset();
     }
 };
 
@@ -51,6 +59,24 @@ struct VideoSnapshot{
 //  implementations. Unsupported implementations will never fire this callback.
 class VideoFrame;
 struct VideoFrameListener{
+    //  What to do when frames arrive faster than on_frame() returns.
+    enum class QueuePolicy{
+        LATEST_ONLY,    //  Keep only the newest frame. Depth is ignored.
+        DROP_OLDEST,    //  When full, drop the oldest queued frame.
+        LOSSLESS,       //  When full, block the producer until there's room.
+    };
+    struct QueueSettings{
+        QueuePolicy policy;
+        size_t depth;
+    };
+
+    //  Only used by VideoSession::add_frame_listener(). There, on_frame() runs
+    //  on a thread owned by this listener (never concurrently with itself)
+    //  and frames are queued according to these settings.
+    virtual QueueSettings frame_queue_settings() const{
+        return {QueuePolicy::LATEST_ONLY, 1};
+    }
+
     virtual void on_frame(std::shared_ptr<const VideoFrame> frame) = 0;
 };
 
@@ -0,0 +1,106 @@
+/*  Video Frame Dispatcher
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Exceptions.h"
+#include "VideoFrameDispatcher.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+
+VideoFrameDispatcher::~VideoFrameDispatcher(){
+    stop();
+}
+void VideoFrameDispatcher::stop(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopping = true;
+    }
+    m_frame_ready.notify_all();
+    m_space_ready.notify_all();
+    m_thread.join();
+}
+VideoFrameDispatcher::VideoFrameDispatcher(Logger& logger, VideoFrameListener& listener)
+    : m_logger(logger)
+    , m_listener(listener)
+    , m_policy(listener.frame_queue_settings().policy)
+    , m_depth(
+        m_policy == VideoFrameListener::QueuePolicy::LATEST_ONLY
+            ? 1
+            : std::max(listener.frame_queue_settings().depth, (size_t)1)
+    )
+    , m_thread([this]{ thread_loop(); })
+{}
+
+
+void VideoFrameDispatcher::push(std::shared_ptr<const VideoFrame> frame){
+    {
+        std::unique_lock<std::mutex> lg(m_lock);
+        if (m_stopping){
+            return;
+        }
+        if (m_queue.size() >= m_depth){
+            switch (m_policy){
+            case VideoFrameListener::QueuePolicy::LATEST_ONLY:
+            case VideoFrameListener::QueuePolicy::DROP_OLDEST:
+                m_queue.pop_front();
+                m_dropped++;
+                break;
+            case VideoFrameListener::QueuePolicy::LOSSLESS:
+                m_space_ready.wait(lg, [&]{
+                    return m_stopping || m_queue.size() < m_depth;
+                });
+                if (m_stopping){
+                    return;
+                }
+                break;
+            }
+        }
+        m_queue.emplace_back(std::move(frame));
+    }
+    m_frame_ready.notify_one();
+}
+uint64_t VideoFrameDispatcher::dropped() const{
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_dropped;
+}
+
+
+void VideoFrameDispatcher::thread_loop(){
+    std::unique_lock<std::mutex> lg(m_lock);
+    while (true){
+        m_frame_ready.wait(lg, [&]{
+            return m_stopping || !m_queue.empty();
+        });
+        if (m_stopping){
+            return;
+        }
+
+        std::shared_ptr<const VideoFrame> frame = std::move(m_queue.front());
+        m_queue.pop_front();
+        lg.unlock();
+        m_space_ready.notify_one();
+
+        try{
+            m_listener.on_frame(std::move(frame));
+        }catch (Exception& e){
+            m_logger.log("Exception thrown from video frame listener: " + e.to_str(), COLOR_RED);
+        }catch (std::exception& e){
+            m_logger.log("Exception thrown from video frame listener: " + std::string(e.what()), COLOR_RED);
+        }
+
+        lg.lock();
+    }
+}
+
+
+
+}
@@ -0,0 +1,66 @@
+/*  Video Frame Dispatcher
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Delivers video frames to one VideoFrameListener on its own thread so that
+ *  a slow listener doesn't hold up the capture thread or the other listeners.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_VideoFrameDispatcher_H
+#define PokemonAutomation_VideoPipeline_VideoFrameDispatcher_H
+
+#include <stdint.h>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/AbstractLogger.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "VideoFeed.h"
+
+namespace PokemonAutomation{
+
+
+class VideoFrameDispatcher{
+public:
+    ~VideoFrameDispatcher();
+    VideoFrameDispatcher(Logger& logger, VideoFrameListener& listener);
+
+    //  Stops the thread. Frames still in the queue are discarded and any
+    //  blocked push() returns. Once this returns, "listener" will not be
+    //  called again. Only call from one thread at a time.
+    void stop();
+
+    //  Queue a frame for the listener. Only blocks if the listener's policy
+    //  is LOSSLESS and its queue is full.
+    void push(std::shared_ptr<const VideoFrame> frame);
+
+    //  # of frames dropped so far because the listener fell behind.
+    uint64_t dropped() const;
+
+
+private:
+    void thread_loop();
+
+
+private:
+    Logger& m_logger;
+    VideoFrameListener& m_listener;
+    const VideoFrameListener::QueuePolicy m_policy;
+    const size_t m_depth;
+
+    mutable std::mutex m_lock;
+    std::condition_variable m_frame_ready;
+    std::condition_variable m_space_ready;
+    std::deque<std::shared_ptr<const VideoFrame>> m_queue;
+    uint64_t m_dropped = 0;
+    bool m_stopping = false;
+
+    Thread m_thread;
+};
+
+
+
+}
+#endif
@@ -152,32 +152,24 @@ std::vector<OverlayStatSnapshot> VideoOverlaySession::stats() const{
 //
 
 void VideoOverlaySession::add_box(const OverlayBox& box){
-    std::shared_ptr<std::vector<OverlayBox>> ptr = std::make_shared<std::vector<OverlayBox>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::add_box()");
-        m_boxes.insert(&box);
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_boxes` asynchronously.
-        for (const auto& item : m_boxes){
-            ptr->emplace_back(*item);
+        if (!m_boxes.insert(&box).second){
+            return;
         }
+        m_boxes_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_boxes, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 void VideoOverlaySession::remove_box(const OverlayBox& box){
-    std::shared_ptr<std::vector<OverlayBox>> ptr = std::make_shared<std::vector<OverlayBox>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::remove_box()");
-        m_boxes.erase(&box);
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_boxes` asynchronously.
-        for (const auto& item : m_boxes){
-            ptr->emplace_back(*item);
+        if (m_boxes.erase(&box) == 0){
+            return;
         }
+        m_boxes_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_boxes, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 std::vector<OverlayBox> VideoOverlaySession::boxes() const{
     ReadSpinLock lg(m_lock);
@@ -194,32 +186,24 @@ std::vector<OverlayBox> VideoOverlaySession::boxes() const{
 //
 
 void VideoOverlaySession::add_text(const OverlayText& text){
-    std::shared_ptr<std::vector<OverlayText>> ptr = std::make_shared<std::vector<OverlayText>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::add_text()");
-        m_texts.insert(&text);
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_texts` asynchronously.
-        for (const auto& item : m_texts){
-            ptr->emplace_back(*item);
+        if (!m_texts.insert(&text).second){
+            return;
         }
+        m_texts_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_text, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 void VideoOverlaySession::remove_text(const OverlayText& text){
-    std::shared_ptr<std::vector<OverlayText>> ptr = std::make_shared<std::vector<OverlayText>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::remove_text()");
-        m_texts.erase(&text);
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_texts` asynchronously.
-        for (const auto& item : m_texts){
-            ptr->emplace_back(*item);
+        if (m_texts.erase(&text) == 0){
+            return;
         }
+        m_texts_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_text, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 std::vector<OverlayText> VideoOverlaySession::texts() const{
     ReadSpinLock lg(m_lock);
@@ -236,32 +220,24 @@ std::vector<OverlayText> VideoOverlaySession::texts() const{
 //
 
 void VideoOverlaySession::add_image(const OverlayImage& image){
-    std::shared_ptr<std::vector<OverlayImage>> ptr = std::make_shared<std::vector<OverlayImage>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::add_image()");
-        m_images.insert(&image);
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_images` asynchronously.
-        for (const auto& item : m_images){
-            ptr->emplace_back(*item);
+        if (!m_images.insert(&image).second){
+            return;
         }
+        m_images_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_images, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 void VideoOverlaySession::remove_image(const OverlayImage& image){
-    std::shared_ptr<std::vector<OverlayImage>> ptr = std::make_shared<std::vector<OverlayImage>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::remove_image()");
-        m_images.erase(&image);
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_images` asynchronously.
-        for (const auto& item : m_images){
-            ptr->emplace_back(*item);
+        if (m_images.erase(&image) == 0){
+            return;
         }
+        m_images_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_images, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 std::vector<OverlayImage> VideoOverlaySession::images() const{
     ReadSpinLock lg(m_lock);
@@ -278,7 +254,6 @@ std::vector<OverlayImage> VideoOverlaySession::images() const{
 //
 
 void VideoOverlaySession::add_log(std::string message, Color color){
-    std::shared_ptr<std::vector<OverlayLogLine>> ptr = std::make_shared<std::vector<OverlayLogLine>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::add_log_text()");
         m_log_texts.emplace_front(color, std::move(message));
@@ -286,28 +261,20 @@ void VideoOverlaySession::add_log(std::string message, Color color){
         if (m_log_texts.size() > LOG_MAX_LINES){
             m_log_texts.pop_back();
         }
-
-        //  We create a newly allocated Box vector to avoid listener accessing
-        //  `m_log_texts` asynchronously.
-        for(const auto& item : m_log_texts){
-            ptr->emplace_back(item);
-        }
+        m_log_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_log, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 void VideoOverlaySession::clear_log(){
-    std::shared_ptr<std::vector<OverlayLogLine>> ptr = std::make_shared<std::vector<OverlayLogLine>>();
     {
         WriteSpinLock lg(m_lock, "VideoOverlaySession::clear_log_texts()");
-        m_log_texts.clear();
-
-        //  We create a newly allocated log text vector to avoid listener accessing
-        //  `m_log_texts` asynchronously.
-        for(const auto& item : m_log_texts){
-            ptr->emplace_back(item);
+        if (m_log_texts.empty()){
+            return;
         }
+        m_log_texts.clear();
+        m_log_version++;
     }
-    m_listeners.run_method(&ContentListener::on_overlay_update_log, ptr);
+    m_listeners.run_method(&ContentListener::on_overlay_content_changed);
 }
 std::vector<OverlayLogLine> VideoOverlaySession::log_texts() const{
     ReadSpinLock lg(m_lock);
@@ -319,6 +286,49 @@ std::vector<OverlayLogLine> VideoOverlaySession::log_texts() const{
 }
 
 
+//
+//  Snapshot
+//
+
+//  Rebuild "layer" from "source" only if it is older than "current_version".
+template <typename Type, typename Container, typename Convert>
+void refresh_layer(
+    std::shared_ptr<const std::vector<Type>>& layer, uint64_t& layer_version,
+    const Container& source, uint64_t current_version,
+    Convert&& convert
+){
+    if (layer && layer_version == current_version){
+        return;
+    }
+    std::shared_ptr<std::vector<Type>> ptr = std::make_shared<std::vector<Type>>();
+    ptr->reserve(source.size());
+    for (const auto& item : source){
+        ptr->emplace_back(convert(item));
+    }
+    layer = std::move(ptr);
+    layer_version = current_version;
+}
+
+void VideoOverlaySession::update_snapshot(ContentSnapshot& snapshot) const{
+    ReadSpinLock lg(m_lock);
+    refresh_layer(
+        snapshot.boxes, snapshot.boxes_version, m_boxes, m_boxes_version,
+        [](const OverlayBox* item) -> const OverlayBox& { return *item; }
+    );
+    refresh_layer(
+        snapshot.texts, snapshot.texts_version, m_texts, m_texts_version,
+        [](const OverlayText* item) -> const OverlayText& { return *item; }
+    );
+    refresh_layer(
+        snapshot.images, snapshot.images_version, m_images, m_images_version,
+        [](const OverlayImage* item) -> const OverlayImage& { return *item; }
+    );
+    refresh_layer(
+        snapshot.log, snapshot.log_version, m_log_texts, m_log_version,
+        [](const OverlayLogLine& item) -> const OverlayLogLine& { return item; }
+    );
+}
+
 
 
 
@@ -8,11 +8,16 @@
  *  This class is not responsible for any UI. However, any changes made to this
  *  class will be forwarded to any UI components that are attached to it.
  *
+ *  Changes only mark the content dirty. Attached UI pulls a snapshot when it
+ *  repaints, so a burst of add/remove calls doesn't copy the whole overlay
+ *  each time.
+ *
  */
 
 #ifndef PokemonAutomation_VideoPipeline_VideoOverlaySession_H
 #define PokemonAutomation_VideoPipeline_VideoOverlaySession_H
 
+#include <stdint.h>
 #include <memory>
 #include <vector>
 #include <list>
@@ -51,19 +56,25 @@ public:
         virtual void on_overlay_enabled_log    (bool enabled){}
         virtual void on_overlay_enabled_stats  (bool enabled){}
 
-        // Returns a copy to avoid the caller (UI object) accessing the data async while the data
-        // is modified by VideoOverlaySession::add/remove_box().
-        virtual void on_overlay_update_boxes  (const std::shared_ptr<const std::vector<OverlayBox>>& boxes){}
-        // Returns a copy to avoid the caller (UI object) accessing the data async while the data
-        // is modified by VideoOverlaySession::add/remove_text().
-        virtual void on_overlay_update_text   (const std::shared_ptr<const std::vector<OverlayText>>& texts){}
-        // Returns a copy to avoid the caller (UI object) accessing the data async while the data
-        // is modified by VideoOverlaySession::add/remove_image().
-        virtual void on_overlay_update_images (const std::shared_ptr<const std::vector<OverlayImage>>& images){}
-        // Returns a copy to avoid the caller (UI object) accessing the data async while the data
-        // is modified by VideoOverlaySession::add/remove_log().
-        virtual void on_overlay_update_log    (const std::shared_ptr<const std::vector<OverlayLogLine>>& boxes){}
+        // Called after any box, text, image or log change. Nothing is copied here.
+        // The listener should note that it is dirty and call update_snapshot() when
+        // it next renders. Many changes between two renders cost one snapshot.
+        virtual void on_overlay_content_changed(){}
+
+    };
 
+    //  A copy of the overlay content, refreshed by update_snapshot(). Each layer
+    //  is only re-copied if it has changed since the last refresh. The vectors
+    //  are immutable once published so they can be held across the refresh.
+    struct ContentSnapshot{
+        uint64_t boxes_version = 0;
+        uint64_t texts_version = 0;
+        uint64_t images_version = 0;
+        uint64_t log_version = 0;
+        std::shared_ptr<const std::vector<OverlayBox>> boxes;
+        std::shared_ptr<const std::vector<OverlayText>> texts;
+        std::shared_ptr<const std::vector<OverlayImage>> images;
+        std::shared_ptr<const std::vector<OverlayLogLine>> log;
     };
 
     //  Add a UI class to listen to any overlay change. The UI class needs to inherit Listener.
@@ -113,6 +124,9 @@ public:
 
     std::vector<OverlayStatSnapshot> stats() const;
 
+    //  Bring "snapshot" up to date with the current content.
+    void update_snapshot(ContentSnapshot& snapshot) const;
+
 
     virtual void add_box(const OverlayBox& box) override;
     virtual void remove_box(const OverlayBox& box) override;
@@ -145,6 +159,13 @@ private:
     std::set<const OverlayImage*> m_images;
     std::deque<OverlayLogLine> m_log_texts;
 
+    //  Bumped on every change to the respective layer. Protected by "m_lock".
+    //  Starts at 1 so that an empty ContentSnapshot is always out of date.
+    uint64_t m_boxes_version = 1;
+    uint64_t m_texts_version = 1;
+    uint64_t m_images_version = 1;
+    uint64_t m_log_version = 1;
+
     std::list<OverlayStat*> m_stats_order;
     std::map<OverlayStat*, std::list<OverlayStat*>::iterator> m_stats;
 
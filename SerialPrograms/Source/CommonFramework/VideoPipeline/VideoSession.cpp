@@ -4,6 +4,7 @@
  *
  */
 
+#include <vector>
 #include "Common/Cpp/EarlyShutdown.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/GlobalServices.h"
@@ -32,10 +33,29 @@ bool VideoSession::try_remove_state_listener(StateListener& listener){
 }
 
 void VideoSession::add_frame_listener(VideoFrameListener& listener){
-    m_frame_listeners.add(listener);
+    std::lock_guard<std::mutex> lg(m_frame_listener_lock);
+    auto& dispatcher = m_frame_listeners[&listener];
+    if (!dispatcher){
+        dispatcher = std::make_shared<VideoFrameDispatcher>(m_logger, listener);
+    }
 }
 void VideoSession::remove_frame_listener(VideoFrameListener& listener){
-    m_frame_listeners.remove(listener);
+    std::shared_ptr<VideoFrameDispatcher> dispatcher;
+    {
+        std::lock_guard<std::mutex> lg(m_frame_listener_lock);
+        auto iter = m_frame_listeners.find(&listener);
+        if (iter == m_frame_listeners.end()){
+            return;
+        }
+        dispatcher = std::move(iter->second);
+        m_frame_listeners.erase(iter);
+    }
+
+    //  Stop the listener's thread outside the lock so we don't hold up the
+    //  other listeners while it finishes its current frame. "on_frame()" may
+    //  still hold a reference, so stop explicitly rather than relying on the
+    //  destructor.
+    dispatcher->stop();
 }
 
 
@@ -332,7 +352,19 @@ double VideoSession::fps_display() const{
     return m_fps_tracker_rendered.events_per_second();
 }
 void VideoSession::on_frame(std::shared_ptr<const VideoFrame> frame){
-    m_frame_listeners.run_method(&VideoFrameListener::on_frame, frame);
+    //  Push outside the lock. A LOSSLESS listener can block here and must
+    //  not hold up the other listeners or add/remove_frame_listener().
+    std::vector<std::shared_ptr<VideoFrameDispatcher>> dispatchers;
+    {
+        std::lock_guard<std::mutex> lg(m_frame_listener_lock);
+        dispatchers.reserve(m_frame_listeners.size());
+        for (auto& item : m_frame_listeners){
+            dispatchers.emplace_back(item.second);
+        }
+    }
+    for (const std::shared_ptr<VideoFrameDispatcher>& dispatcher : dispatchers){
+        dispatcher->push(frame);
+    }
     {
         WriteSpinLock lg(m_fps_lock);
         m_fps_tracker_source.push_event(frame->timestamp);
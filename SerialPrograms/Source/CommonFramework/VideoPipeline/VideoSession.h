@@ -9,12 +9,14 @@
 
 #include <memory>
 #include <deque>
+#include <map>
 #include <mutex>
 #include "Common/Cpp/EventRateTracker.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "Common/Cpp/Concurrency/Watchdog.h"
 #include "VideoSourceDescriptor.h"
 #include "VideoSource.h"
+#include "VideoFrameDispatcher.h"
 
 namespace PokemonAutomation{
 
@@ -167,8 +169,8 @@ private:
     //  When this function is called, the VideoSession will update its internal fps record
     //  and call frame listeners added by VideoSession::add_frame_listener().
     //  This function is thread-safe as it has a lock to prevent concurrent fps calls.
-    //  Note the lock does not protect the other frame listeners added by
-    //  VideoSession::add_frame_listener().
+    //  Frame listeners are not called from here. The frame is only queued to
+    //  each listener's VideoFrameDispatcher, which calls it on its own thread.
     virtual void on_frame(std::shared_ptr<const VideoFrame> frame) override;
     //  Overwrites VideoSource::RenderedFrameListener::on_rendered_frame()
     //  This function is called when the video source finds a new rendered frame so
@@ -221,7 +223,10 @@ private:
     std::deque<Command> m_queued_commands;
 
     ListenerSet<StateListener> m_state_listeners;
-    ListenerSet<VideoFrameListener> m_frame_listeners;
+    std::mutex m_frame_listener_lock;
+    //  Shared so that "on_frame()" can push to them without holding
+    //  "m_frame_listener_lock".
+    std::map<VideoFrameListener*, std::shared_ptr<VideoFrameDispatcher>> m_frame_listeners;
 };
 
 
@@ -0,0 +1,412 @@
+/*  Video Source (File)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <QUrl>
+#include <QWidget>
+#include <QPainter>
+#include <QFileDialog>
+#include <QMediaPlayer>
+#include <QVideoSink>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include "Common/Cpp/Json/JsonObject.h"
+#include "CommonFramework/VideoPipeline/Backends/VideoFrameQt.h"
+#include "VideoSource_File.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+
+bool VideoSourceDescriptor_File::operator==(const VideoSourceDescriptor& x) const{
+    if (typeid(*this) != typeid(x)){
+        return false;
+    }
+
+    const VideoSourceDescriptor_File& other = static_cast<const VideoSourceDescriptor_File&>(x);
+    std::string other_path = other.path();
+    VideoFilePlaybackMode other_mode = other.mode();
+
+    ReadSpinLock lg(m_lock);
+    return m_path == other_path && m_mode == other_mode;
+}
+
+std::string VideoSourceDescriptor_File::path() const{
+    ReadSpinLock lg(m_lock);
+    return m_path;
+}
+void VideoSourceDescriptor_File::set_path(std::string path){
+    WriteSpinLock lg(m_lock);
+    m_path = std::move(path);
+}
+VideoFilePlaybackMode VideoSourceDescriptor_File::mode() const{
+    ReadSpinLock lg(m_lock);
+    return m_mode;
+}
+void VideoSourceDescriptor_File::set_mode(VideoFilePlaybackMode mode){
+    WriteSpinLock lg(m_lock);
+    m_mode = mode;
+}
+
+void VideoSourceDescriptor_File::run_post_select(){
+    std::string path = QFileDialog::getOpenFileName(
+        nullptr, "Open video file", ".", "*.mp4 *.mkv *.avi *.mov *.webm"
+    ).toStdString();
+    set_path(std::move(path));
+}
+void VideoSourceDescriptor_File::load_json(const JsonValue& json){
+    const JsonObject* obj = json.to_object();
+    if (obj == nullptr){
+        return;
+    }
+    WriteSpinLock lg(m_lock);
+    const std::string* path = obj->get_string("Path");
+    if (path != nullptr){
+        m_path = *path;
+    }
+    const std::string* mode = obj->get_string("Mode");
+    if (mode != nullptr){
+        m_mode = *mode == "Stepping"
+            ? VideoFilePlaybackMode::Stepping
+            : VideoFilePlaybackMode::RealTime;
+    }
+}
+JsonValue VideoSourceDescriptor_File::to_json() const{
+    ReadSpinLock lg(m_lock);
+    JsonObject obj;
+    obj["Path"] = m_path;
+    obj["Mode"] = m_mode == VideoFilePlaybackMode::Stepping ? "Stepping" : "RealTime";
+    return obj;
+}
+
+std::unique_ptr<VideoSource> VideoSourceDescriptor_File::make_VideoSource(Logger& logger, Resolution resolution) const{
+    return std::make_unique<VideoSource_File>(logger, path(), mode(), resolution);
+}
+
+
+
+
+
+VideoSource_File::~VideoSource_File(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopping = true;
+        m_end_of_media = true;
+    }
+    m_cv.notify_all();
+
+    //  Stepping: the decoder thread exits at its next frame.
+    m_stepping_thread.join();
+
+    if (m_player){
+        //  Wait for a frame callback that's already running on the decoder
+        //  thread, then make sure no later one touches this object.
+        {
+            std::lock_guard<std::mutex> lg(m_callback_gate->lock);
+            m_callback_gate->source = nullptr;
+        }
+        m_metaobject.reset();
+        m_player->stop();
+    }
+}
+VideoSource_File::VideoSource_File(
+    Logger& logger,
+    const std::string& path,
+    VideoFilePlaybackMode mode,
+    Resolution resolution
+)
+    : VideoSource(logger, false)
+    , m_logger(logger)
+    , m_path(path)
+    , m_mode(mode)
+    , m_requested_resolution(resolution)
+    , m_resolutions{
+        {1280, 720},
+        {1920, 1080},
+        {3840, 2160},
+    }
+    , m_resolution(resolution)
+    , m_stepping_epoch(current_time())
+    , m_last_timestamp(WallClock::min())
+{
+    m_logger.log(
+        std::string("Opening video file (") +
+        (mode == VideoFilePlaybackMode::Stepping ? "stepping" : "real-time") +
+        "): " + path
+    );
+
+    if (mode == VideoFilePlaybackMode::Stepping){
+        m_stepping_thread = Thread([this]{ stepping_thread(); });
+        return;
+    }
+
+    m_metaobject.reset(new QObject());
+    m_video_sink.reset(new QVideoSink());
+    m_player.reset(new QMediaPlayer());
+    m_callback_gate.reset(new CallbackGate{{}, this});
+
+    QObject::connect(
+        m_video_sink.get(), &QVideoSink::videoFrameChanged,
+        m_metaobject.get(), [gate = m_callback_gate](const QVideoFrame& frame){
+            std::lock_guard<std::mutex> lg(gate->lock);
+            if (gate->source != nullptr){
+                gate->source->on_decoded_frame(frame);
+            }
+        },
+        Qt::DirectConnection
+    );
+    QObject::connect(
+        m_player.get(), &QMediaPlayer::mediaStatusChanged,
+        m_metaobject.get(), [this](QMediaPlayer::MediaStatus status){
+            if (status == QMediaPlayer::EndOfMedia || status == QMediaPlayer::InvalidMedia){
+                on_end_of_media();
+            }
+        }
+    );
+    QObject::connect(
+        m_player.get(), &QMediaPlayer::errorOccurred,
+        m_metaobject.get(), [this](QMediaPlayer::Error error, const QString& message){
+            m_logger.log("Unable to play video file: " + message.toStdString(), COLOR_RED);
+            on_end_of_media();
+        }
+    );
+
+    m_player->setVideoSink(m_video_sink.get());
+    m_player->setSource(QUrl::fromLocalFile(QString::fromStdString(path)));
+    m_player->play();
+}
+
+
+bool VideoSource_File::finished() const{
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_end_of_media && m_queue.empty();
+}
+Resolution VideoSource_File::current_resolution() const{
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_resolution;
+}
+
+
+void VideoSource_File::request_repaint(){
+    ReadSpinLock lg(m_display_lock);
+    if (m_display != nullptr){
+        QWidget* display = m_display;
+        QMetaObject::invokeMethod(display, [display]{ display->update(); });
+    }
+}
+void VideoSource_File::on_decoded_frame(const QVideoFrame& frame){
+    if (!frame.isValid()){
+        return;
+    }
+
+    WallClock now = current_time();
+
+    QImage image = frame.toImage();
+    QImage::Format format = image.format();
+    if (format != QImage::Format_ARGB32 && format != QImage::Format_RGB32){
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    ImageRGB32 converted(image);
+    if (m_requested_resolution){
+        converted = converted.scale_to(m_requested_resolution.width, m_requested_resolution.height);
+    }
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_resolution = Resolution(converted.width(), converted.height());
+        m_current = VideoSnapshot(std::move(converted), now);
+    }
+    m_cv.notify_all();
+
+    report_source_frame(std::make_shared<VideoFrame>(now, frame));
+    request_repaint();
+}
+//  The frame owns a copy of the pixels. Listeners may hold on to it long after
+//  "image" is gone.
+static QVideoFrame make_video_frame(const ImageViewRGB32& image){
+#if QT_VERSION >= 0x060800
+    return QVideoFrame(image.to_QImage_owning());
+#else
+    //  QVideoFrame(const QImage&) doesn't exist before Qt 6.8.
+    QVideoFrame frame(QVideoFrameFormat(
+        QSize((int)image.width(), (int)image.height()),
+        QVideoFrameFormat::Format_BGRA8888
+    ));
+    if (!frame.map(QVideoFrame::WriteOnly)){
+        return QVideoFrame();
+    }
+    uchar* dst = frame.bits(0);
+    size_t dst_bytes_per_row = frame.bytesPerLine(0);
+    const char* src = (const char*)image.data();
+    for (size_t r = 0; r < image.height(); r++){
+        memcpy(dst + r * dst_bytes_per_row, src + r * image.bytes_per_row(), image.width() * sizeof(uint32_t));
+    }
+    frame.unmap();
+    return frame;
+#endif
+}
+void VideoSource_File::stepping_thread(){
+    cv::VideoCapture capture(m_path);
+    if (!capture.isOpened()){
+        m_logger.log("Unable to open video file: " + m_path, COLOR_RED);
+        on_end_of_media();
+        return;
+    }
+
+    double fps = capture.get(cv::CAP_PROP_FPS);
+    if (!(fps > 0)){
+        fps = 60;
+    }
+
+    cv::Mat frame;
+    for (uint64_t index = 0;; index++){
+        //  Don't decode ahead of the consumer by more than the queue depth.
+        {
+            std::unique_lock<std::mutex> lg(m_lock);
+            m_cv.wait(lg, [this]{
+                return m_stopping || m_queue.size() < STEPPING_QUEUE_DEPTH;
+            });
+            if (m_stopping){
+                return;
+            }
+        }
+
+        if (!capture.read(frame) || frame.empty()){
+            break;
+        }
+
+        //  Use the video's own clock. Fall back to the frame index if the
+        //  container doesn't have one.
+        double position_ms = capture.get(cv::CAP_PROP_POS_MSEC);
+        WallClock timestamp = position_ms > 0 || index == 0
+            ? m_stepping_epoch + std::chrono::microseconds((int64_t)(position_ms * 1000))
+            : m_stepping_epoch + std::chrono::microseconds((int64_t)(index * 1000000 / fps));
+
+        ImageRGB32 image(frame.cols, frame.rows);
+        cv::Mat bgra = image.to_opencv_Mat();
+        cv::cvtColor(frame, bgra, frame.channels() == 1 ? cv::COLOR_GRAY2BGRA : cv::COLOR_BGR2BGRA);
+        if (m_requested_resolution){
+            image = image.scale_to(m_requested_resolution.width, m_requested_resolution.height);
+        }
+
+        std::shared_ptr<VideoFrame> video_frame = std::make_shared<VideoFrame>(
+            timestamp, make_video_frame(image)
+        );
+
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            //  Keep it strictly increasing in case of duplicate timestamps.
+            if (m_last_timestamp != WallClock::min() && timestamp <= m_last_timestamp){
+                timestamp = m_last_timestamp + std::chrono::microseconds(1);
+                video_frame->timestamp = timestamp;
+            }
+            m_last_timestamp = timestamp;
+            m_resolution = Resolution(image.width(), image.height());
+            m_queue.emplace_back(std::move(image), timestamp);
+        }
+        m_cv.notify_all();
+
+        report_source_frame(std::move(video_frame));
+        request_repaint();
+    }
+
+    on_end_of_media();
+}
+void VideoSource_File::on_end_of_media(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        if (m_end_of_media){
+            return;
+        }
+        m_end_of_media = true;
+    }
+    m_logger.log("Reached end of video file: " + m_path);
+    m_cv.notify_all();
+}
+
+
+VideoSnapshot VideoSource_File::snapshot_latest_blocking(){
+    std::unique_lock<std::mutex> lg(m_lock);
+
+    if (m_mode == VideoFilePlaybackMode::RealTime){
+        m_cv.wait(lg, [this]{ return m_end_of_media || m_current; });
+        return m_current;
+    }
+
+    //  Stepping: hand out the next frame in order.
+    m_cv.wait(lg, [this]{ return m_end_of_media || !m_queue.empty(); });
+    if (m_queue.empty()){
+        return m_current;
+    }
+    m_current = std::move(m_queue.front());
+    m_queue.pop_front();
+    VideoSnapshot ret = m_current;
+    lg.unlock();
+
+    //  Wake the decoder now that there's room.
+    m_cv.notify_all();
+    return ret;
+}
+VideoSnapshot VideoSource_File::snapshot_recent_nonblocking(WallClock min_time){
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_current;
+}
+
+
+
+class VideoWidget_File : public QWidget{
+public:
+    ~VideoWidget_File(){
+        WriteSpinLock lg(m_source.m_display_lock);
+        m_source.m_display = nullptr;
+    }
+    VideoWidget_File(QWidget* parent, VideoSource_File& source)
+        : QWidget(parent)
+        , m_source(source)
+    {
+        WriteSpinLock lg(m_source.m_display_lock);
+        m_source.m_display = this;
+    }
+
+private:
+    virtual void paintEvent(QPaintEvent* event) override{
+        QWidget::paintEvent(event);
+
+        VideoSnapshot snapshot = m_source.snapshot_recent_nonblocking(WallClock::min());
+        if (!snapshot){
+            return;
+        }
+
+        QRect rect(0, 0, this->width(), this->height());
+        QPainter painter(this);
+        painter.drawImage(rect, snapshot->to_QImage_ref());
+
+        m_source.report_rendered_frame(current_time());
+    }
+
+private:
+    VideoSource_File& m_source;
+};
+
+
+
+
+
+QWidget* VideoSource_File::make_display_QtWidget(QWidget* parent){
+    return new VideoWidget_File(parent, *this);
+}
+
+
+
+
+}
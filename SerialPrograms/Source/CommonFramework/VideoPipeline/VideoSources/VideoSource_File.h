@@ -0,0 +1,183 @@
+/*  Video Source (File)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Play back a recorded video file (e.g. one saved by StreamRecorder) as a
+ *  video source. Used to replay inference offline and to benchmark it.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_VideoSource_File_H
+#define PokemonAutomation_VideoPipeline_VideoSource_File_H
+
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "CommonFramework/VideoPipeline/VideoSourceDescriptor.h"
+#include "CommonFramework/VideoPipeline/VideoSource.h"
+
+class QObject;
+class QMediaPlayer;
+class QVideoSink;
+class QVideoFrame;
+
+namespace PokemonAutomation{
+
+
+enum class VideoFilePlaybackMode{
+    //  Play at normal speed. Snapshots return the latest decoded frame, so
+    //  frames are skipped if the consumer is slower than the video.
+    RealTime,
+
+    //  Frames are pulled one at a time from a frame-accurate decoder (OpenCV)
+    //  and queued. Each snapshot_latest_blocking() returns the next one,
+    //  waiting for the decoder if needed. Nothing is ever dropped. Snapshot
+    //  timestamps come from the video's own presentation times, so a replay
+    //  sees the same frames and timestamps regardless of how fast it runs.
+    Stepping,
+};
+
+
+
+class VideoSourceDescriptor_File : public VideoSourceDescriptor{
+public:
+    VideoSourceDescriptor_File()
+        : VideoSourceDescriptor(VideoSourceType::VideoPlayback)
+    {}
+    VideoSourceDescriptor_File(std::string path, VideoFilePlaybackMode mode = VideoFilePlaybackMode::RealTime)
+        : VideoSourceDescriptor(VideoSourceType::VideoPlayback)
+        , m_path(std::move(path))
+        , m_mode(mode)
+    {}
+
+public:
+    // get the video file path
+    std::string path() const;
+    // set the video file path
+    void set_path(std::string path);
+
+    VideoFilePlaybackMode mode() const;
+    void set_mode(VideoFilePlaybackMode mode);
+
+    virtual bool should_reload() const override{ return true; }
+    virtual bool operator==(const VideoSourceDescriptor& x) const override;
+    virtual std::string display_name() const override{
+        return "Play Video File";
+    }
+
+    virtual void run_post_select() override;
+    virtual void load_json(const JsonValue& json) override;
+    virtual JsonValue to_json() const override;
+
+    virtual std::unique_ptr<VideoSource> make_VideoSource(Logger& logger, Resolution resolution) const override;
+
+
+private:
+    mutable SpinLock m_lock;
+    std::string m_path;
+    VideoFilePlaybackMode m_mode = VideoFilePlaybackMode::RealTime;
+};
+
+
+
+class VideoSource_File : public VideoSource{
+public:
+    //  Max # of decoded frames held in Stepping mode before decoding waits.
+    static constexpr size_t STEPPING_QUEUE_DEPTH = 16;
+
+public:
+    ~VideoSource_File();
+    VideoSource_File(
+        Logger& logger,
+        const std::string& path,
+        VideoFilePlaybackMode mode,
+        Resolution resolution
+    );
+
+    const std::string& path() const{
+        return m_path;
+    }
+
+    //  True once the whole file has been decoded and, in Stepping mode,
+    //  every frame has been handed out.
+    bool finished() const;
+
+    virtual Resolution current_resolution() const override;
+    virtual const std::vector<Resolution>& supported_resolutions() const override{
+        return m_resolutions;
+    }
+
+    virtual VideoSnapshot snapshot_latest_blocking() override;
+    virtual VideoSnapshot snapshot_recent_nonblocking(WallClock min_time) override;
+
+    virtual QWidget* make_display_QtWidget(QWidget* parent) override;
+
+
+private:
+    //  RealTime mode. Called on the media player's decoder thread.
+    void on_decoded_frame(const QVideoFrame& frame);
+
+    //  Stepping mode. Runs on "m_stepping_thread".
+    void stepping_thread();
+
+    void on_end_of_media();
+    void request_repaint();
+
+
+private:
+    friend class VideoWidget_File;
+
+    Logger& m_logger;
+    const std::string m_path;
+    const VideoFilePlaybackMode m_mode;
+    const Resolution m_requested_resolution;
+    std::vector<Resolution> m_resolutions;
+
+    //  RealTime mode only.
+    std::unique_ptr<QObject> m_metaobject;
+    std::unique_ptr<QVideoSink> m_video_sink;
+    std::unique_ptr<QMediaPlayer> m_player;
+
+    mutable std::mutex m_lock;
+    std::condition_variable m_cv;
+    Resolution m_resolution;
+    bool m_end_of_media = false;
+    bool m_stopping = false;
+
+    //  Shared with the decoder callback. Lets the destructor wait out a
+    //  callback that's already running and turn away any that come later.
+    //  (RealTime mode only)
+    struct CallbackGate{
+        std::mutex lock;
+        VideoSource_File* source;
+    };
+    std::shared_ptr<CallbackGate> m_callback_gate;
+
+    //  Stepping mode: the video's first frame maps to this time.
+    WallClock m_stepping_epoch;
+    WallClock m_last_timestamp;
+
+    //  Decoded frames not yet handed out. (Stepping mode only)
+    std::deque<VideoSnapshot> m_queue;
+
+    //  The last frame handed out. (Stepping mode)
+    //  The last frame decoded. (RealTime mode)
+    VideoSnapshot m_current;
+
+    //  Repaint requests for the display widget.
+    SpinLock m_display_lock;
+    QWidget* m_display = nullptr;
+
+    //  Stepping mode only.
+    Thread m_stepping_thread;
+};
+
+
+
+
+
+}
+#endif
@@ -43,15 +43,15 @@ std::vector<ImageRGB32> make_image_set(
 
     std::vector<ImageRGB32> ret;
     ptrdiff_t limit = (ptrdiff_t)tolerance;
+    ret.reserve((2 * limit + 1) * (2 * limit + 1));
     for (ptrdiff_t y = -limit; y <= limit; y++){
         for (ptrdiff_t x = -limit; x <= limit; x++){
 //            if (x != 0 || y != -4){
 //                continue;
 //            }
 
-            ret.emplace_back(
-                extract_box_reference(screen, box, x * scale, y * scale).scale_to(width, height)
-            );
+            ret.emplace_back(width, height);
+            extract_box_reference(screen, box, x * scale, y * scale).scale_to(ret.back());
 //            cout << "make_image_set(): image = " << ret.back().width() << " x " << ret.back().height() << endl;
 //            if (x == 0 && y == 0){
 //                ret.back().save("image.png");
@@ -12,6 +12,13 @@ namespace PokemonAutomation{
 
 
 bool VisualInferenceCallback::process_frame(const VideoSnapshot& frame){
+    if (!frame.stats_table){
+        return process_frame(*frame.frame, frame.timestamp);
+    }
+
+    //  Let box stats on this frame share the snapshot's table with every
+    //  other callback looking at the same frame.
+    ImageStatsTableScope scope(*frame.frame, *frame.stats_table);
     return process_frame(*frame.frame, frame.timestamp);
 }
 bool VisualInferenceCallback::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
@@ -5,6 +5,7 @@
  */
 
 //#include "Common/Cpp/Exceptions.h"
+#include <algorithm>
 #include "Common/Cpp/Time.h"
 #include "SuperscalarScheduler.h"
 
@@ -36,33 +37,53 @@ void SuperscalarScheduler::clear() noexcept{
     m_device_sent_time = now;
     m_max_free_time = now;
     m_state_changes.clear();
-    m_live_commands.clear();
+    for (size_t id : m_live_ids){
+        m_resources[id].command.reset();
+    }
+    m_live_ids.clear();
     m_pending_clear = false;
 }
 
+SuperscalarScheduler::Command& SuperscalarScheduler::resource_slot(size_t resource_id){
+    if (resource_id >= m_resources.size()){
+        m_resources.resize(resource_id + 1);
+    }
+    return m_resources[resource_id];
+}
+void SuperscalarScheduler::add_state_change(WallClock timestamp){
+    auto iter = std::lower_bound(m_state_changes.begin(), m_state_changes.end(), timestamp);
+    if (iter == m_state_changes.end() || *iter != timestamp){
+        m_state_changes.insert(iter, timestamp);
+    }
+}
+
 SuperscalarScheduler::State SuperscalarScheduler::current_live_commands(){
     WallClock device_sent_time = m_device_sent_time;
     State ret;
 //    cout << "device_sent_time = " << std::chrono::duration_cast<Milliseconds>(device_sent_time - m_local_start).count() << endl;
-    for (auto& item : m_live_commands){
-//        cout << "busy = " << std::chrono::duration_cast<Milliseconds>(item.second.busy_time - m_local_start).count()
-//             << ", done = " << std::chrono::duration_cast<Milliseconds>(item.second.done_time - m_local_start).count() << endl;
-        if (item.second.busy_time <= device_sent_time && device_sent_time < item.second.done_time){
-            ret.emplace_back(item.second.command);
+    for (size_t id : m_live_ids){
+        const Command& command = m_resources[id];
+//        cout << "busy = " << std::chrono::duration_cast<Milliseconds>(command.busy_time - m_local_start).count()
+//             << ", done = " << std::chrono::duration_cast<Milliseconds>(command.done_time - m_local_start).count() << endl;
+        if (command.busy_time <= device_sent_time && device_sent_time < command.done_time){
+            ret.emplace_back(command.command);
         }
     }
     return ret;
 }
 void SuperscalarScheduler::clear_finished_commands(){
     WallClock device_sent_time = m_device_sent_time;
-    for (auto iter = m_live_commands.begin(); iter != m_live_commands.end();){
-//        cout << "device_sent_time = " << device_sent_time << ", free_time = " << iter->second.free_time << endl;
-        if (device_sent_time >= iter->second.free_time){
-            iter = m_live_commands.erase(iter);
+    size_t kept = 0;
+    for (size_t id : m_live_ids){
+        Command& command = m_resources[id];
+//        cout << "device_sent_time = " << device_sent_time << ", free_time = " << command.free_time << endl;
+        if (device_sent_time >= command.free_time){
+            command.command.reset();
         }else{
-            ++iter;
+            m_live_ids[kept++] = id;
         }
     }
+    m_live_ids.resize(kept);
 }
 bool SuperscalarScheduler::iterate_schedule(Schedule& schedule){
 //    cout << "----------------------------> " << m_state_changes.size() << endl;
@@ -74,17 +95,15 @@ bool SuperscalarScheduler::iterate_schedule(Schedule& schedule){
         return false;
     }
 
-    auto iter = m_state_changes.begin();
+    WallClock first_state_change = m_state_changes[0];
 
     WallClock next_state_change;
-    if (m_device_sent_time < *iter){
-        next_state_change = *iter;
+    if (m_device_sent_time < first_state_change){
+        next_state_change = first_state_change;
     }else{
-        auto next = iter;
-        ++next;
-        next_state_change = next == m_state_changes.end()
+        next_state_change = m_state_changes.size() < 2
             ? m_device_issue_time
-            : *next;
+            : m_state_changes[1];
     }
 
     //  Things get complicated if we overshoot the issue time.
@@ -108,8 +127,8 @@ bool SuperscalarScheduler::iterate_schedule(Schedule& schedule){
     clear_finished_commands();
 
     m_device_sent_time = next_state_change;
-    if (next_state_change > *iter){
-        m_state_changes.erase(iter);
+    if (next_state_change > first_state_change){
+        m_state_changes.erase(m_state_changes.begin());
     }
 
     ScheduleEntry& entry = schedule.emplace_back();
@@ -193,7 +212,7 @@ void SuperscalarScheduler::issue_nop(Schedule& schedule, WallDuration delay){
 //         << ", max_free_time = " << std::chrono::duration_cast<Milliseconds>((m_max_free_time - m_local_start)).count()
 //         << endl;
     WallClock next_issue_time = m_device_issue_time + delay;
-    m_state_changes.insert(next_issue_time);
+    add_state_change(next_issue_time);
     m_device_issue_time = next_issue_time;
     m_max_free_time = std::max(m_max_free_time, m_device_issue_time);
     m_local_last_activity = current_time();
@@ -211,10 +230,12 @@ void SuperscalarScheduler::issue_wait_for_resource(Schedule& schedule, size_t re
 //         << endl;
 
     //  Resource is not ready yet. Stall until it is.
-    auto iter = m_live_commands.find(resource_id);
-    if (iter != m_live_commands.end() && m_device_sent_time < iter->second.free_time){
-        m_device_issue_time = iter->second.free_time;
-        m_local_last_activity = current_time();
+    if (resource_id < m_resources.size()){
+        const Command& command = m_resources[resource_id];
+        if (command.command && m_device_sent_time < command.free_time){
+            m_device_issue_time = command.free_time;
+            m_local_last_activity = current_time();
+        }
     }
 
     process_schedule(schedule);
@@ -229,13 +250,13 @@ void SuperscalarScheduler::issue_to_resource(
     }
 
     //  Resource is busy. Stall until it is free.
-    auto ret = m_live_commands.try_emplace(resource->id);
-    if (!ret.second){
-//        cout << m_device_sent_time << " : " << ret.first->second.free_time << endl;
-        m_device_issue_time = std::max(m_device_issue_time, ret.first->second.free_time);
+    size_t resource_id = resource->id;
+    Command& command = resource_slot(resource_id);
+    if (command.command){
+//        cout << m_device_sent_time << " : " << command.free_time << endl;
+        m_device_issue_time = std::max(m_device_issue_time, command.free_time);
         process_schedule(schedule);
     }
-    Command& command = ret.first->second;
 
     delay    = std::max(delay, WallDuration::zero());
     hold     = std::max(hold, WallDuration::zero());
@@ -254,9 +275,15 @@ void SuperscalarScheduler::issue_to_resource(
     WallClock release_time = m_device_issue_time + hold;
     WallClock free_time = release_time + cooldown;
 
-    m_state_changes.insert(m_device_issue_time);
-    m_state_changes.insert(release_time);
+    add_state_change(m_device_issue_time);
+    add_state_change(release_time);
 
+    if (!command.command){
+        m_live_ids.insert(
+            std::lower_bound(m_live_ids.begin(), m_live_ids.end(), resource_id),
+            resource_id
+        );
+    }
     command.command = std::move(resource);
     command.busy_time = m_device_issue_time;
     command.done_time = release_time;
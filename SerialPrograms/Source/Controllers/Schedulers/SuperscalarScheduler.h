@@ -8,8 +8,7 @@
 #define PokemonAutomation_Controllers_SuperscalarScheduler_H
 
 #include <memory>
-#include <set>
-#include <map>
+#include <vector>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Time.h"
 #include "Common/Cpp/AbstractLogger.h"
@@ -64,9 +63,8 @@ public:
     //
 
     WallClock busy_until(size_t resource_id) const{
-        auto iter = m_live_commands.find(resource_id);
-        return iter != m_live_commands.end()
-            ? iter->second.free_time
+        return resource_id < m_resources.size() && m_resources[resource_id].command
+            ? m_resources[resource_id].free_time
             : WallClock::min();
     }
 
@@ -91,7 +89,11 @@ public:
 
 
 private:
+    struct Command;
+
     void clear() noexcept;
+    Command& resource_slot(size_t resource_id);
+    void add_state_change(WallClock timestamp);
     State current_live_commands();
     void clear_finished_commands();
     bool iterate_schedule(Schedule& schedule);
@@ -121,20 +123,29 @@ private:
     //  The current timestamp of what has been sent to the device.
     WallClock m_device_sent_time;
 
-    //  Maximum of: m_live_commands[]->second.free_time
+    //  Maximum of: m_resources[m_live_ids[]].free_time
     WallClock m_max_free_time;
 
-    //  A set of all the scheduled state changes that will happen. Between
-    //  timestamps in this set, the state is constant.
-    std::set<WallClock> m_state_changes;
+    //  A sorted list of all the scheduled state changes that will happen.
+    //  Between timestamps in this list, the state is constant.
+    //
+    //  This only ever holds a handful of entries. So a flat array beats a tree
+    //  and, since capacity is never released, it stops allocating once warm.
+    std::vector<WallClock> m_state_changes;
 
     struct Command{
-        std::shared_ptr<const SchedulerResource> command;
+        std::shared_ptr<const SchedulerResource> command;   //  Null if not live.
         WallClock busy_time;    //  Timestamp of when resource will be become busy.
         WallClock done_time;    //  Timestamp of when resource will be done being busy.
         WallClock free_time;    //  Timestamp of when resource can be used again.
     };
-    std::map<size_t, Command> m_live_commands;
+
+    //  One slot per resource, indexed by resource id. Resource ids are small
+    //  dense enums so this stays tiny.
+    std::vector<Command> m_resources;
+
+    //  Sorted ids of the slots in "m_resources" that are live.
+    std::vector<size_t> m_live_ids;
 };
 
 
@@ -16,6 +16,16 @@
 namespace PokemonAutomation{
 
 
+//  A non-owning view of a received message. The body points directly into the
+//  connection's receive buffer and is only valid for the duration of the
+//  callback it was passed to. Convert to a BotBaseMessage to keep it.
+struct BotBaseMessageView{
+    uint8_t type;
+    const char* body;
+    size_t body_size;
+};
+
+
 struct BotBaseMessage{
     uint8_t type;
     std::string body;
@@ -27,6 +37,10 @@ struct BotBaseMessage{
         : type(p_type)
         , body(std::move(p_body))
     {}
+    explicit BotBaseMessage(const BotBaseMessageView& view)
+        : type(view.type)
+        , body(view.body, view.body_size)
+    {}
 
     template <typename Params>
     BotBaseMessage(uint8_t p_type, const Params& params)
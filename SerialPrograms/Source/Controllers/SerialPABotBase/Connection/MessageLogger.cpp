@@ -58,7 +58,7 @@ void MessageLogger::on_send(const BotBaseMessage& message, bool is_retransmit){
         log("Sending: " + str, COLOR_DARKGREEN);
     }
 }
-void MessageLogger::on_recv(const BotBaseMessage& message){
+void MessageLogger::on_recv(const BotBaseMessageView& message){
     bool print = false;
     do{
         if (PABB_MSG_IS_ERROR(message.type)){
@@ -76,7 +76,7 @@ void MessageLogger::on_recv(const BotBaseMessage& message){
     if (!print){
         return;
     }
-    std::string str = message_to_string(message);
+    std::string str = message_to_string(BotBaseMessage(message));
     if (!str.empty()){
         log("Receive: " + str, COLOR_DARKGREEN);
     }
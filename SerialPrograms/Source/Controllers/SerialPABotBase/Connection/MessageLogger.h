@@ -30,7 +30,7 @@ public:
 
 
     virtual void on_send(const BotBaseMessage& message, bool is_retransmit) override;
-    virtual void on_recv(const BotBaseMessage& message) override;
+    virtual void on_recv(const BotBaseMessageView& message) override;
 
 private:
     std::atomic<bool> m_log_everything_owner;
@@ -13,12 +13,13 @@
 namespace PokemonAutomation{
 
 struct BotBaseMessage;
+struct BotBaseMessageView;
 
 
 class MessageSniffer{
 public:
     virtual void on_send(const BotBaseMessage& message, bool is_retransmit){}
-    virtual void on_recv(const BotBaseMessage& message){}
+    virtual void on_recv(const BotBaseMessageView& message){}
 };
 
 
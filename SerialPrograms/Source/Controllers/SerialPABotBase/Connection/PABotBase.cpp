@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
 #include "Common/Cpp/PanicDump.h"
 #include "Common/Cpp/Concurrency/SpinPause.h"
 #include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
@@ -36,6 +37,10 @@
 namespace PokemonAutomation{
 
 
+//  How often the retransmit thread logs the connection stats.
+const std::chrono::minutes CONNECTION_STATS_LOG_PERIOD(10);
+
+
 
 PABotBase::PABotBase(
     Logger& logger,
@@ -46,9 +51,11 @@ PABotBase::PABotBase(
     : PABotBaseConnection(logger, std::move(connection))
     , m_logger(logger)
     , m_max_pending_requests(PABB_DEVICE_MINIMUM_QUEUE_SIZE)
+    , m_inflight_window((size_t)-1)
     , m_send_seq(1)
-    , m_retransmit_delay(retransmit_delay)
     , m_last_ack(current_time())
+    , m_rtt(retransmit_delay, std::chrono::milliseconds(20), std::chrono::milliseconds(1000))
+    , m_last_send(current_time())
     , m_state(State::RUNNING)
     , m_error(false)
 {
@@ -83,6 +90,12 @@ size_t PABotBase::inflight_requests(){
     }
     return ret;
 }
+size_t PABotBase::inflight_limit() const{
+    return std::min(
+        m_max_pending_requests.load(std::memory_order_relaxed),
+        m_inflight_window.load(std::memory_order_relaxed)
+    );
+}
 
 void PABotBase::connect(){
     auto scope_check = m_sanitizer.check_scope();
@@ -113,6 +126,8 @@ void PABotBase::stop(std::string error_message){
     m_cv.notify_all();
     m_retransmit_thread.join();
 
+    m_logger.log("Connection Stats: " + connection_stats().to_str());
+
     {
         ReadSpinLock lg(m_state_lock, "PABotBase::stop()");
 
@@ -146,6 +161,33 @@ void PABotBase::on_cancellable_cancel(){
 void PABotBase::set_queue_limit(size_t queue_limit){
     m_max_pending_requests.store(queue_limit, std::memory_order_relaxed);
 }
+void PABotBase::set_inflight_window(size_t window){
+    m_inflight_window.store(window == 0 ? (size_t)-1 : window, std::memory_order_relaxed);
+}
+
+std::string PABotBase::ConnectionStats::to_str() const{
+    std::string str;
+    str += "SRTT = " + tostr_fixed(srtt.count() / 1000., 3) + " ms";
+    str += ", RTTVAR = " + tostr_fixed(rttvar.count() / 1000., 3) + " ms";
+    str += ", RTO = " + tostr_fixed(rto.count() / 1000., 3) + " ms";
+    str += ", Samples = " + tostr_u_commas(rtt_samples);
+    str += ", Sent = " + tostr_u_commas(messages_sent);
+    str += ", Retransmitted = " + tostr_u_commas(messages_retransmitted);
+    str += " (" + tostr_u_commas(retransmit_rounds) + " rounds)";
+    return str;
+}
+PABotBase::ConnectionStats PABotBase::connection_stats(){
+    ReadSpinLock lg(m_state_lock);
+    return ConnectionStats{
+        m_rtt.srtt(),
+        m_rtt.rttvar(),
+        m_rtt.rto(),
+        m_rtt.samples(),
+        m_messages_sent,
+        m_messages_retransmitted,
+        m_retransmit_rounds,
+    };
+}
 
 void PABotBase::wait_for_all_requests(Cancellable* cancelled){
     auto scope_check = m_sanitizer.check_scope();
@@ -265,6 +307,7 @@ void PABotBase::clear_all_active_commands(uint64_t seqnum){
                 {
                     PendingRequest& handle = ret.first->second;
                     handle.silent_remove = true;
+                    handle.retransmitted = true;    //  Don't time its ack.
                     handle.request = std::move(message);
                     handle.first_sent = current_time();
                 }
@@ -303,6 +346,15 @@ uint64_t PABotBase::infer_full_seqnum(const Map& map, seqnum_t seqnum) const{
         : hi_candidate;
 }
 
+template <typename Pending>
+void PABotBase::record_ack_unprotected(const Pending& pending, WallClock now){
+    //  Karn's algorithm: An ack for a retransmitted message is ambiguous.
+    if (pending.retransmitted){
+        return;
+    }
+    m_rtt.add_sample(std::chrono::duration_cast<std::chrono::microseconds>(now - pending.first_sent));
+}
+
 uint64_t PABotBase::oldest_live_seqnum() const{
     auto scope_check = m_sanitizer.check_scope();
 
@@ -318,18 +370,20 @@ uint64_t PABotBase::oldest_live_seqnum() const{
 }
 
 template <typename Params, bool variable_length>
-void PABotBase::process_ack_request(BotBaseMessage message){
+void PABotBase::process_ack_request(const BotBaseMessageView& message){
     auto scope_check = m_sanitizer.check_scope();
 
     if constexpr (!variable_length){
-        if (message.body.size() != sizeof(Params)){
+        if (message.body_size != sizeof(Params)){
             m_logger.log("Ignoring message with invalid size.");
             return;
         }
     }
-    const Params* params = (const Params*)message.body.c_str();
+    const Params* params = (const Params*)message.body;
     seqnum_t seqnum = params->seqnum;
 
+    WallClock now = current_time();
+
     AckState state;
     {
         WriteSpinLock lg(m_state_lock, "PABotBase::process_ack_request()");
@@ -349,16 +403,17 @@ void PABotBase::process_ack_request(BotBaseMessage message){
 
         state = iter->second.state;
         if (state == AckState::NOT_ACKED){
+            record_ack_unprotected(iter->second, now);
             if (iter->second.silent_remove){
                 m_pending_requests.erase(iter);
             }else{
                 iter->second.state = AckState::ACKED;
-                iter->second.ack = std::move(message);
+                iter->second.ack = BotBaseMessage(message);
             }
         }
     }
 
-    m_last_ack.store(current_time(), std::memory_order_release);
+    m_last_ack.store(now, std::memory_order_release);
 
     switch (state){
     case AckState::NOT_ACKED:
@@ -376,16 +431,18 @@ void PABotBase::process_ack_request(BotBaseMessage message){
     }
 }
 template <typename Params>
-void PABotBase::process_ack_command(BotBaseMessage message){
+void PABotBase::process_ack_command(const BotBaseMessageView& message){
     auto scope_check = m_sanitizer.check_scope();
 
-    if (message.body.size() != sizeof(Params)){
+    if (message.body_size != sizeof(Params)){
         m_logger.log("Ignoring message with invalid size.");
         return;
     }
-    const Params* params = (const Params*)message.body.c_str();
+    const Params* params = (const Params*)message.body;
     seqnum_t seqnum = params->seqnum;
 
+    WallClock now = current_time();
+
     WriteSpinLock lg(m_state_lock, "PABotBase::process_ack_command()");
 
     if (m_pending_commands.empty()){
@@ -401,13 +458,14 @@ void PABotBase::process_ack_command(BotBaseMessage message){
     }
     iter->second.sanitizer.check_usage();
 
-    m_last_ack.store(current_time(), std::memory_order_release);
+    m_last_ack.store(now, std::memory_order_release);
 
     switch (iter->second.state){
     case AckState::NOT_ACKED:
 //        std::cout << "acked: " << full_seqnum << std::endl;
+        record_ack_unprotected(iter->second, now);
         iter->second.state = AckState::ACKED;
-        iter->second.ack = std::move(message);
+        iter->second.ack = BotBaseMessage(message);
         return;
     case AckState::ACKED:
         m_logger.log("Duplicate command ack message: seqnum = " + std::to_string(seqnum));
@@ -418,14 +476,14 @@ void PABotBase::process_ack_command(BotBaseMessage message){
     }
 }
 template <typename Params>
-void PABotBase::process_command_finished(BotBaseMessage message){
+void PABotBase::process_command_finished(const BotBaseMessageView& message){
     auto scope_check = m_sanitizer.check_scope();
 
-    if (message.body.size() != sizeof(Params)){
+    if (message.body_size != sizeof(Params)){
         m_logger.log("Ignoring message with invalid size.");
         return;
     }
-    const Params* params = (const Params*)message.body.c_str();
+    const Params* params = (const Params*)message.body;
     seqnum_t seqnum = params->seqnum;
     seqnum_t command_seqnum = params->seq_of_original_command;
 
@@ -471,7 +529,7 @@ void PABotBase::process_command_finished(BotBaseMessage message){
         case AckState::NOT_ACKED:
         case AckState::ACKED:
             iter->second.state = AckState::FINISHED;
-            iter->second.ack = std::move(message);
+            iter->second.ack = BotBaseMessage(message);
             if (iter->second.silent_remove){
                 m_pending_commands.erase(iter);
             }
@@ -483,34 +541,34 @@ void PABotBase::process_command_finished(BotBaseMessage message){
     }
     m_cv.notify_all();
 }
-void PABotBase::on_recv_message(BotBaseMessage message){
+void PABotBase::on_recv_message(const BotBaseMessageView& message){
     auto scope_check = m_sanitizer.check_scope();
 
     switch (message.type){
     case PABB_MSG_ACK_COMMAND:
-        process_ack_command<pabb_MsgAckCommand>(std::move(message));
+        process_ack_command<pabb_MsgAckCommand>(message);
         return;
     case PABB_MSG_ACK_REQUEST:
-        process_ack_request<pabb_MsgAckRequest>(std::move(message));
+        process_ack_request<pabb_MsgAckRequest>(message);
         return;
     case PABB_MSG_ACK_REQUEST_I8:
-        process_ack_request<pabb_MsgAckRequestI8>(std::move(message));
+        process_ack_request<pabb_MsgAckRequestI8>(message);
         return;
     case PABB_MSG_ACK_REQUEST_I16:
-        process_ack_request<pabb_MsgAckRequestI16>(std::move(message));
+        process_ack_request<pabb_MsgAckRequestI16>(message);
         return;
     case PABB_MSG_ACK_REQUEST_I32:
-        process_ack_request<pabb_MsgAckRequestI32>(std::move(message));
+        process_ack_request<pabb_MsgAckRequestI32>(message);
         return;
     case PABB_MSG_ACK_REQUEST_DATA:
-        process_ack_request<pabb_MsgAckRequestData, true>(std::move(message));
+        process_ack_request<pabb_MsgAckRequestData, true>(message);
         return;
     case PABB_MSG_ERROR_INVALID_TYPE:{
-        if (message.body.size() != sizeof(pabb_MsgInfoInvalidType)){
+        if (message.body_size != sizeof(pabb_MsgInfoInvalidType)){
             m_logger.log("Ignoring message with invalid size.");
             return;
         }
-        const pabb_MsgInfoInvalidType* params = (const pabb_MsgInfoInvalidType*)message.body.c_str();
+        const pabb_MsgInfoInvalidType* params = (const pabb_MsgInfoInvalidType*)message.body;
         {
             WriteSpinLock lg(m_state_lock);
             m_error_message = "PABotBase incompatibility. Device does not recognize message type: " + std::to_string(params->type);
@@ -523,11 +581,11 @@ void PABotBase::on_recv_message(BotBaseMessage message){
         m_cv.notify_all();
     }
     case PABB_MSG_ERROR_MISSED_REQUEST:{
-        if (message.body.size() != sizeof(pabb_MsgInfoMissedRequest)){
+        if (message.body_size != sizeof(pabb_MsgInfoMissedRequest)){
             m_logger.log("Ignoring message with invalid size.");
             return;
         }
-        const pabb_MsgInfoMissedRequest* params = (const pabb_MsgInfoMissedRequest*)message.body.c_str();
+        const pabb_MsgInfoMissedRequest* params = (const pabb_MsgInfoMissedRequest*)message.body;
         if (params->seqnum == 1){
             {
                 WriteSpinLock lg(m_state_lock);
@@ -556,7 +614,7 @@ void PABotBase::on_recv_message(BotBaseMessage message){
         return;
     }
     case PABB_MSG_REQUEST_COMMAND_FINISHED:{
-        process_command_finished<pabb_MsgRequestCommandFinished>(std::move(message));
+        process_command_finished<pabb_MsgRequestCommandFinished>(message);
         return;
     }
     }
@@ -566,79 +624,74 @@ void PABotBase::retransmit_thread(){
     auto scope_check = m_sanitizer.check_scope();
 
 //    cout << "retransmit_thread()" << endl;
-    auto last_sent = current_time();
+    WallClock next_stats_log = current_time() + CONNECTION_STATS_LOG_PERIOD;
+    uint64_t last_logged_sent = 0;
     while (m_state.load(std::memory_order_acquire) == State::RUNNING){
-        auto now = current_time();
-
-        if (now - last_sent < m_retransmit_delay){
-            std::unique_lock<std::mutex> lg(m_sleep_lock);
-            if (m_state.load(std::memory_order_acquire) != State::RUNNING){
-                break;
+        WallClock now = current_time();
+
+        //  Log the connection stats every so often, but not while idle.
+        if (now >= next_stats_log){
+            ConnectionStats stats = connection_stats();
+            if (stats.messages_sent != last_logged_sent){
+                m_logger.log("Connection Stats: " + stats.to_str());
+                last_logged_sent = stats.messages_sent;
             }
-            if (m_error.load(std::memory_order_acquire)){
-                break;
-            }
-            m_cv.wait_for(lg, m_retransmit_delay);
-            continue;
+            next_stats_log = now + CONNECTION_STATS_LOG_PERIOD;
         }
 
-        //  Process retransmits.
-        WriteSpinLock lg(m_state_lock, "PABotBase::retransmit_thread()");
-//        std::cout << "retransmit_thread - m_pending_messages.size(): " << m_pending_messages.size() << std::endl;
-//        cout << "m_pending_messages.size()" << endl;
-
-        //  Retransmit
-        //      Iterate through all pending requests and retransmit them in
-        //  chronological order. ~~Skip the ones that are new.~~
-        //  (Don't skip the new ones since it will lead to gaps.)
-
-        //  Gather together all requests/commands. Sort them by seqnum and
-        //  resend everything.
-
-        WallClock oldest = last_sent;
+        WallClock wake_time;
+        {
+            WriteSpinLock lg(m_state_lock, "PABotBase::retransmit_thread()");
+
+            //  The only timer is "last send + RTO". Anything sent or resent
+            //  pushes it back. So this is O(1) unless it has actually expired.
+            std::chrono::microseconds rto = m_rtt.rto();
+            wake_time = m_last_send + rto;
+            if (now >= wake_time){
+                //  Retransmit
+                //      Gather together all unacked requests/commands. Sort them
+                //  by seqnum and resend everything. (Don't skip the new ones
+                //  since it will lead to gaps.)
+                std::map<uint64_t, const BotBaseMessage*> messages;
+                for (auto& item : m_pending_requests){
+                    item.second.sanitizer.check_usage();
+                    if (item.second.state == AckState::NOT_ACKED){
+                        item.second.retransmitted = true;
+                        messages[item.first] = &item.second.request;
+                    }
+                }
+                for (auto& item : m_pending_commands){
+                    item.second.sanitizer.check_usage();
+                    if (item.second.state == AckState::NOT_ACKED){
+                        item.second.retransmitted = true;
+                        messages[item.first] = &item.second.request;
+                    }
+                }
 
-        std::map<uint64_t, const BotBaseMessage*> messages;
-        for (auto& item : m_pending_requests){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED){
-                oldest = std::max(oldest, item.second.first_sent);
-                messages[item.first] = &item.second.request;
-            }
-        }
-        for (auto& item : m_pending_commands){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED){
-                oldest = std::max(oldest, item.second.first_sent);
-                messages[item.first] = &item.second.request;
-            }
-        }
+                if (!messages.empty()){
+                    for (const auto& item : messages){
+                        send_message(*item.second, true);
+                    }
+                    m_messages_retransmitted += messages.size();
+                    m_retransmit_rounds++;
+                    m_rtt.backoff();
+                    m_last_send = current_time();
+                    continue;
+                }
 
-        if (!messages.empty() && now - oldest >= m_retransmit_delay){
-            for (const auto& item : messages){
-                send_message(*item.second, true);
+                //  Nothing outstanding. Check again in one RTO.
+                wake_time = now + rto;
             }
         }
 
-#if 0
-        for (auto& item : m_pending_requests){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED &&
-                current_time() - item.second.first_sent >= m_retransmit_delay
-            ){
-                send_message(item.second.request, true);
-            }
+        std::unique_lock<std::mutex> lg(m_sleep_lock);
+        if (m_state.load(std::memory_order_acquire) != State::RUNNING){
+            break;
         }
-        for (auto& item : m_pending_commands){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED &&
-                current_time() - item.second.first_sent >= m_retransmit_delay
-            ){
-                send_message(item.second.request, true);
-            }
+        if (m_error.load(std::memory_order_acquire)){
+            break;
         }
-#endif
-
-        last_sent = current_time();
+        m_cv.wait_until(lg, std::min(wake_time, next_stats_log));
     }
 //    cout << "retransmit_thread() - exit" << endl;
 }
@@ -674,10 +727,8 @@ uint64_t PABotBase::try_issue_request(
         throw ConnectionException(&m_logger, m_error_message);
     }
 
-    size_t queue_limit = m_max_pending_requests.load(std::memory_order_relaxed);
-
     //  Too many unacked requests in flight.
-    if (!do_not_block && inflight_requests() >= queue_limit){
+    if (!do_not_block && inflight_requests() >= inflight_limit()){
 //        m_logger.log("Message throttled due to too many inflight requests.");
         return 0;
     }
@@ -714,6 +765,9 @@ uint64_t PABotBase::try_issue_request(
     handle.request = std::move(message);
     handle.first_sent = current_time();
 
+    m_last_send = handle.first_sent;
+    m_messages_sent++;
+
 #ifdef INTENTIONALLY_DROP_MESSAGES
     if (rand() % 10 != 0){
         send_message(handle.request, false);
@@ -763,7 +817,7 @@ uint64_t PABotBase::try_issue_command(
     }
 
     //  Too many unacked requests in flight.
-    if (inflight_requests() >= queue_limit){
+    if (inflight_requests() >= inflight_limit()){
 //        m_logger.log("Message throttled due to too many inflight requests.");
         return 0;
     }
@@ -794,6 +848,9 @@ uint64_t PABotBase::try_issue_command(
     handle.request = std::move(message);
     handle.first_sent = current_time();
 
+    m_last_send = handle.first_sent;
+    m_messages_sent++;
+
 #ifdef INTENTIONALLY_DROP_MESSAGES
     if (rand() % 10 != 0){
         send_message(handle.request, false);
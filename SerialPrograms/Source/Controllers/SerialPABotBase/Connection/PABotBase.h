@@ -36,6 +36,7 @@
 #include "Controllers/SerialPABotBase/Connection/PABotBaseConnection.h"
 #include "BotBase.h"
 #include "BotBaseMessage.h"
+#include "RttEstimator.h"
 
 
 namespace PokemonAutomation{
@@ -45,6 +46,8 @@ class PABotBase : public BotBaseController, private PABotBaseConnection{
     static const seqnum_t MAX_SEQNUM_GAP = (seqnum_t)-1 >> 2;
 
 public:
+    //  "retransmit_delay" is only the initial retransmit timeout. Once acks
+    //  start coming back, the timeout adapts to the measured round trip.
     PABotBase(
         Logger& logger,
         std::unique_ptr<StreamConnection> connection,
@@ -75,6 +78,23 @@ public:
     }
     void set_queue_limit(size_t queue_limit);
 
+    //  Cap the # of unacked requests/commands on the wire. This is on top of
+    //  the queue limit. Zero means no extra cap. (default)
+    void set_inflight_window(size_t window);
+
+    struct ConnectionStats{
+        std::chrono::microseconds srtt;
+        std::chrono::microseconds rttvar;
+        std::chrono::microseconds rto;
+        uint64_t rtt_samples;
+        uint64_t messages_sent;
+        uint64_t messages_retransmitted;
+        uint64_t retransmit_rounds;
+
+        std::string to_str() const;
+    };
+    ConnectionStats connection_stats();
+
 public:
     //  Basic Requests
 
@@ -100,6 +120,7 @@ private:
     struct PendingRequest{
         AckState state = AckState::NOT_ACKED;
         bool silent_remove;
+        bool retransmitted = false;
         BotBaseMessage request;
         BotBaseMessage ack;
         WallClock first_sent;
@@ -108,6 +129,7 @@ private:
     struct PendingCommand{
         AckState state = AckState::NOT_ACKED;
         bool silent_remove;
+        bool retransmitted = false;
         BotBaseMessage request;
         BotBaseMessage ack;
         WallClock first_sent;
@@ -119,13 +141,17 @@ private:
 
     uint64_t oldest_live_seqnum() const;
 
+    //  Must be called under "m_state_lock".
+    template <typename Pending>
+    void record_ack_unprotected(const Pending& pending, WallClock now);
+
     template <typename Params, bool variable_length = false>
-    void process_ack_request(BotBaseMessage message);
+    void process_ack_request(const BotBaseMessageView& message);
     template <typename Params>
-    void process_ack_command(BotBaseMessage message);
+    void process_ack_command(const BotBaseMessageView& message);
 
-    template <typename Params> void process_command_finished(BotBaseMessage message);
-    virtual void on_recv_message(BotBaseMessage message) override;
+    template <typename Params> void process_command_finished(const BotBaseMessageView& message);
+    virtual void on_recv_message(const BotBaseMessageView& message) override;
 
     void clear_all_active_commands(uint64_t seqnum);
 
@@ -133,6 +159,7 @@ private:
 
 private:
     size_t inflight_requests();
+    size_t inflight_limit() const;
 
     //  Returns the seqnum of the request. If failed, returns zero.
     uint64_t try_issue_request(
@@ -183,10 +210,22 @@ private:
 
     std::atomic<size_t> m_max_pending_requests;
 
+    std::atomic<size_t> m_inflight_window;
+
     uint64_t m_send_seq;
-    std::chrono::milliseconds m_retransmit_delay;
     std::atomic<std::chrono::time_point<std::chrono::system_clock>> m_last_ack;
 
+    //  Retransmit state. Protected by "m_state_lock".
+    //
+    //  Since the device drops anything that arrives after a gap, every unacked
+    //  message is always resent together in seqnum order. So there is only one
+    //  timer per connection: "m_last_send + RTO".
+    RttEstimator m_rtt;
+    WallClock m_last_send;
+    uint64_t m_messages_sent = 0;
+    uint64_t m_messages_retransmitted = 0;
+    uint64_t m_retransmit_rounds = 0;
+
     std::map<uint64_t, PendingRequest> m_pending_requests;
     std::map<uint64_t, PendingCommand> m_pending_commands;
 
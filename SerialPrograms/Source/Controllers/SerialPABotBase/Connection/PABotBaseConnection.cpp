@@ -4,6 +4,8 @@
  * 
  */
 
+#include <string.h>
+#include <algorithm>
 #include "Common/CRC32.h"
 #include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
 //#include "Controllers/SerialPABotBase/Connection/MessageConverter.h"
@@ -51,11 +53,8 @@ void PABotBaseConnection::send_zeros(uint8_t bytes){
         return;
     }
 
-    char ch = 0;
-    for (uint8_t c = 0; c < bytes; c++){
-        m_connection->send(&ch, 1);
-//        Sleep(10);
-    }
+    char buffer[256] = {};
+    m_connection->send(buffer, bytes);
 }
 void PABotBaseConnection::send_message(const BotBaseMessage& message, bool is_retransmit){
     if (!m_connection){
@@ -70,14 +69,15 @@ void PABotBaseConnection::send_message(const BotBaseMessage& message, bool is_re
         throw InternalProgramError(&m_logger, PA_CURRENT_FUNCTION, "Message is too long.");
     }
 
-    std::string buffer;
-    buffer += ~(uint8_t)total_bytes;
-    buffer += message.type;
-    buffer += message.body;
-    buffer += std::string(sizeof(uint32_t), 0);
-    pabb_crc32_write_to_message(&buffer[0], buffer.size());
+    //  Serialize on the stack. This is called from multiple threads so we
+    //  can't share a member buffer without adding another lock.
+    char buffer[PABB_PROTOCOL_MAX_PACKET_SIZE];
+    buffer[0] = ~(uint8_t)total_bytes;
+    buffer[1] = message.type;
+    memcpy(buffer + 2, message.body.data(), message.body.size());
+    pabb_crc32_write_to_message(buffer, total_bytes);
 
-    m_connection->send(&buffer[0], buffer.size());
+    m_connection->send(buffer, total_bytes);
 }
 
 
@@ -109,18 +109,35 @@ void PABotBaseConnection::push_error_byte(ErrorBatchType type, char byte){
     m_current_error_type = type;
 }
 void PABotBaseConnection::on_recv(const void* data, size_t bytes){
-    //  Push into receive buffer.
-    for (size_t c = 0; c < bytes; c++){
-        m_recv_buffer.emplace_back(((const char*)data)[c]);
-    }
+    const char* ptr = (const char*)data;
+    while (bytes > 0){
+        //  Out of room at the back. Move the partial frame to the front.
+        if (m_recv_end == RECV_BUFFER_SIZE){
+            size_t remaining = m_recv_end - m_recv_start;
+            memmove(m_recv_buffer, m_recv_buffer + m_recv_start, remaining);
+            m_recv_start = 0;
+            m_recv_end = remaining;
+        }
 
-    while (!m_recv_buffer.empty()){
-        uint8_t length = ~m_recv_buffer[0];
+        size_t block = std::min(bytes, RECV_BUFFER_SIZE - m_recv_end);
+        memcpy(m_recv_buffer + m_recv_end, ptr, block);
+        m_recv_end += block;
+        ptr += block;
+        bytes -= block;
 
-        if (m_recv_buffer[0] == 0){
+        parse_recv_buffer();
+    }
+}
+void PABotBaseConnection::parse_recv_buffer(){
+    while (m_recv_start < m_recv_end){
+        const char* frame = m_recv_buffer + m_recv_start;
+        size_t available = m_recv_end - m_recv_start;
+        uint8_t length = ~frame[0];
+
+        if (frame[0] == 0){
 //            m_logger.log("Skipping zero byte.");
             push_error_byte(ErrorBatchType::ZERO_BYTES, 0);
-            m_recv_buffer.pop_front();
+            m_recv_start++;
             continue;
         }
 
@@ -132,7 +149,7 @@ void PABotBaseConnection::on_recv(const void* data, size_t bytes){
                 m_logger.log("Message is too short: bytes = " + std::to_string(length));
                 push_error_byte(ErrorBatchType::OTHER, ~length);
             }
-            m_recv_buffer.pop_front();
+            m_recv_start++;
             continue;
         }
 
@@ -144,27 +161,26 @@ void PABotBaseConnection::on_recv(const void* data, size_t bytes){
 //                : std::string(", char = ") + ascii;
 //            m_logger.log("Message is too long: bytes = " + std::to_string(length) + text);
             push_error_byte(ErrorBatchType::ASCII_BYTES, ~length);
-            m_recv_buffer.pop_front();
+            m_recv_start++;
             continue;
         }
 
         //  Message is incomplete.
-        if (length > m_recv_buffer.size()){
-            return;
+        if (length > available){
+            break;
         }
 
         m_current_error_type = ErrorBatchType::NO_ERROR_;
         m_current_error_batch.clear();
 
-        std::string message(m_recv_buffer.begin(), m_recv_buffer.begin() + length);
-
         //  Verify checksum
         {
             //  Calculate checksum.
-            uint32_t checksumA = pabb_crc32(0xffffffff, &message[0], length - sizeof(uint32_t));
+            uint32_t checksumA = pabb_crc32(0xffffffff, frame, length - sizeof(uint32_t));
 
             //  Read the checksum from the message.
-            uint32_t checksumE = ((uint32_t*)(&message[0] + length))[-1];
+            uint32_t checksumE;
+            memcpy(&checksumE, frame + length - sizeof(uint32_t), sizeof(uint32_t));
 
             //  Compare
 //            std::cout << checksumA << " / " << checksumE << std::endl;
@@ -172,15 +188,22 @@ void PABotBaseConnection::on_recv(const void* data, size_t bytes){
                 m_logger.log("Invalid Checksum: bytes = " + std::to_string(length));
 //                std::cout << checksumA << " / " << checksumE << std::endl;
 //                log(message_to_string(message[1], &message[2], length - PABB_PROTOCOL_OVERHEAD));
-                m_recv_buffer.pop_front();
+                m_recv_start++;
                 continue;
             }
         }
-        m_recv_buffer.erase(m_recv_buffer.begin(), m_recv_buffer.begin() + length);
+        m_recv_start += length;
 
-        BotBaseMessage msg(message[1], std::string(&message[2], length - PABB_PROTOCOL_OVERHEAD));
+        //  The frame stays in the buffer until the next on_recv(). So the view
+        //  remains valid for the duration of these calls.
+        BotBaseMessageView msg{(uint8_t)frame[1], frame + 2, (size_t)length - PABB_PROTOCOL_OVERHEAD};
         m_sniffer->on_recv(msg);
-        on_recv_message(std::move(msg));
+        on_recv_message(msg);
+    }
+
+    if (m_recv_start == m_recv_end){
+        m_recv_start = 0;
+        m_recv_end = 0;
     }
 }
 
@@ -15,10 +15,10 @@
 #define PokemonAutomation_PABotBaseConnection_H
 
 #include <memory>
-#include <deque>
 #include "Common/Cpp/SerialConnection/StreamInterface.h"
 #include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
 #include "BotBase.h"
+#include "BotBaseMessage.h"
 #include "MessageSniffer.h"
 
 namespace PokemonAutomation{
@@ -43,7 +43,13 @@ protected:
 
 private:
     virtual void on_recv(const void* data, size_t bytes) override;
-    virtual void on_recv_message(BotBaseMessage message) = 0;
+
+    //  The message body points into the receive buffer. It is only valid
+    //  for the duration of this call.
+    virtual void on_recv_message(const BotBaseMessageView& message) = 0;
+
+    //  Parse and dispatch every complete frame in the receive buffer.
+    void parse_recv_buffer();
 
     enum class ErrorBatchType{
         NO_ERROR_,
@@ -56,7 +62,14 @@ private:
 
 private:
     std::unique_ptr<StreamConnection> m_connection;
-    std::deque<char> m_recv_buffer;
+
+    //  Contiguous receive buffer. Frames are parsed and CRC-checked in place.
+    //  Unparsed data is always shorter than one packet, so compacting it to
+    //  the front when the buffer fills up is cheap.
+    static constexpr size_t RECV_BUFFER_SIZE = 4096;
+    size_t m_recv_start = 0;
+    size_t m_recv_end = 0;
+    char m_recv_buffer[RECV_BUFFER_SIZE];
 
     ErrorBatchType m_current_error_type;
     std::string m_current_error_batch;
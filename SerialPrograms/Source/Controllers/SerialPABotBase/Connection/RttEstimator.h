@@ -0,0 +1,77 @@
+/*  Round-Trip Time Estimator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Standard TCP-style (RFC 6298) smoothed RTT and RTT variance tracking
+ *  used to pick the retransmit timeout for a connection.
+ *
+ *  Healthy links converge to a timeout a few milliseconds above the real round
+ *  trip. Lossy links back off exponentially until an ack comes back.
+ *
+ *  This class is not thread-safe.
+ *
+ */
+
+#ifndef PokemonAutomation_RttEstimator_H
+#define PokemonAutomation_RttEstimator_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+
+namespace PokemonAutomation{
+
+
+class RttEstimator{
+public:
+    using Duration = std::chrono::microseconds;
+
+    RttEstimator(Duration initial_rto, Duration min_rto, Duration max_rto)
+        : m_min_rto(min_rto)
+        , m_max_rto(max_rto)
+        , m_rto(std::clamp(initial_rto, min_rto, max_rto))
+    {}
+
+    Duration srtt() const{ return m_srtt; }
+    Duration rttvar() const{ return m_rttvar; }
+    Duration rto() const{ return m_rto; }
+    uint64_t samples() const{ return m_samples; }
+
+    //  Feed a measured round trip. Per Karn's algorithm, do not call this for
+    //  messages that have been retransmitted since we can't tell which copy
+    //  the ack belongs to.
+    void add_sample(Duration rtt){
+        if (m_samples == 0){
+            m_srtt = rtt;
+            m_rttvar = rtt / 2;
+        }else{
+            Duration error = m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt;
+            m_rttvar = (3 * m_rttvar + error) / 4;
+            m_srtt = (7 * m_srtt + rtt) / 8;
+        }
+        m_samples++;
+
+        //  A fresh sample also cancels any backoff.
+        Duration variance = std::max<Duration>(4 * m_rttvar, std::chrono::milliseconds(1));
+        m_rto = std::clamp(m_srtt + variance, m_min_rto, m_max_rto);
+    }
+
+    //  Called when the timeout fires and we retransmit.
+    void backoff(){
+        m_rto = std::min(2 * m_rto, m_max_rto);
+    }
+
+private:
+    Duration m_min_rto;
+    Duration m_max_rto;
+
+    Duration m_srtt = Duration::zero();
+    Duration m_rttvar = Duration::zero();
+    Duration m_rto;
+    uint64_t m_samples = 0;
+};
+
+
+
+}
+#endif
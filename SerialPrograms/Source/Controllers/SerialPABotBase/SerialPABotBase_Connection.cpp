@@ -134,6 +134,12 @@ void SerialPABotBase_Connection::process_queue_size(){
 
     m_logger.Logger::log("Setting queue size to: " + std::to_string(queue_size));
     m_botbase->set_queue_limit(queue_size);
+
+    uint8_t window = GlobalSettings::instance().SERIAL_INFLIGHT_WINDOW;
+    if (window != 0){
+        m_logger.Logger::log("Setting in-flight window to: " + std::to_string(window));
+    }
+    m_botbase->set_inflight_window(window);
 }
 
 void SerialPABotBase_Connection::throw_incompatible_protocol(){
@@ -5,6 +5,7 @@
  */
 
 #include <deque>
+#include <algorithm>
 #include <QString>
 #include <QFile>
 #include <QHttpMultiPart>
@@ -35,6 +36,9 @@ namespace DiscordWebhook{
 DiscordWebhookSender::DiscordWebhookSender()
     : m_logger(global_logger_raw(), "DiscordWebhookSender")
     , m_stopping(false)
+    , m_tokens(256)     //  Start full. This gets clamped on first use.
+    , m_last_refill(current_time())
+    , m_next_batch_id(0)
     , m_dispatcher(nullptr, 1)
     , m_queue(m_dispatcher)
 {}
@@ -56,6 +60,27 @@ DiscordWebhookSender& DiscordWebhookSender::instance(){
     return sender;
 }
 
+//  Embeds are built before their screenshots are encoded. If one couldn't be
+//  written, drop the embed images that point at it so they don't show up as
+//  broken images.
+static void remove_attachment_images(JsonObject& json, const std::string& filename){
+    JsonArray* embeds = json.get_array("embeds");
+    if (embeds == nullptr){
+        return;
+    }
+    const std::string url = "attachment://" + filename;
+    for (JsonValue& item : *embeds){
+        JsonObject* embed = item.to_object();
+        if (embed == nullptr){
+            continue;
+        }
+        const JsonObject* image = embed->get_object("image");
+        if (image != nullptr && image->get_string_default("url") == url){
+            embed->erase("image");
+        }
+    }
+}
+
 void DiscordWebhookSender::send(
     Logger& logger,
     const QUrl& url, std::chrono::milliseconds delay,
@@ -63,31 +88,11 @@ void DiscordWebhookSender::send(
     std::shared_ptr<PendingFileSend> file,
     std::function<void()> finish_callback
 ){
-    cleanup_stuck_requests();
-    std::shared_ptr<JsonValue> json(new JsonValue(obj.clone()));
-//    cout << "Scheduling Webhook Message... (queue = " + tostr_u_commas(m_queue.size()) + ")" << endl;
-    logger.log("Scheduling Webhook Message... (queue = " + tostr_u_commas(m_queue.size()) + ")", COLOR_PURPLE);
-    m_queue.add_event(
-        delay,
-        [
-            this, url,
-            json = std::move(json),
-            file = std::move(file),
-            finish_callback = std::move(finish_callback)
-        ]{
-            throttle();
-            std::vector<DiscordFileAttachment> attachments;
-            if (file){
-                attachments.emplace_back(
-                    DiscordFileAttachment{file->filename(), file->filepath()}
-                );
-            }
-            internal_send(url, *json, attachments);
-            if (finish_callback){
-                finish_callback();
-            }
-        }
-    );
+    std::vector<std::shared_ptr<PendingFileSend>> files;
+    if (file){
+        files.emplace_back(std::move(file));
+    }
+    send(logger, url, delay, obj, std::move(files), std::move(finish_callback));
 }
 void DiscordWebhookSender::send(
     Logger& logger,
@@ -97,7 +102,7 @@ void DiscordWebhookSender::send(
     std::function<void()> finish_callback
 ){
     cleanup_stuck_requests();
-    std::shared_ptr<JsonValue> json(new JsonValue(obj.clone()));
+    std::shared_ptr<JsonObject> json(new JsonObject(obj.clone()));
 //    cout << "Scheduling Webhook Message... (queue = " + tostr_u_commas(m_queue.size()) + ")" << endl;
     logger.log("Scheduling Webhook Message... (queue = " + tostr_u_commas(m_queue.size()) + ")", COLOR_PURPLE);
     m_queue.add_event(
@@ -108,17 +113,20 @@ void DiscordWebhookSender::send(
             files = std::move(files),
             finish_callback = std::move(finish_callback)
         ]{
-            throttle();
-            std::vector<DiscordFileAttachment> attachments;
+            Message message{url, std::move(*json), {}, {}};
             for (auto& file : files){
-                attachments.emplace_back(
+                if (!file->wait_until_ready()){
+                    remove_attachment_images(message.json, file->filename());
+                    continue;
+                }
+                message.files.emplace_back(
                     DiscordFileAttachment{file->filename(), file->filepath()}
                 );
             }
-            internal_send(url, *json, attachments);
             if (finish_callback){
-                finish_callback();
+                message.finish_callbacks.emplace_back(std::move(finish_callback));
             }
+            enqueue(std::move(message));
         }
     );
 }
@@ -144,26 +152,188 @@ void DiscordWebhookSender::cleanup_stuck_requests(){
         m_event_loop->exit();
     }
 }
-void DiscordWebhookSender::throttle(){
-    //  Throttle the messages.
-    auto duration = THROTTLE_DURATION;
-    auto now = current_time();
-    while (!m_sent.empty() && m_sent[0] + duration < now){
-        m_sent.pop_front();
-    }
-    if (!m_sent.empty() && m_sent.size() >= GlobalSettings::instance().DISCORD->webhooks.sends_per_second){
-        m_logger.log("Throttling webhook messages due to rate limit...", COLOR_RED);
-        std::unique_lock<std::mutex> lg(m_lock);
-        m_cv.wait_for(
-            lg, duration,
-            [&]{ return m_stopping.load(std::memory_order_relaxed) || m_sent.empty() || m_sent[0] + duration < now; }
+void DiscordWebhookSender::sleep_until(WallClock time){
+    std::unique_lock<std::mutex> lg(m_lock);
+    m_cv.wait_until(
+        lg, time,
+        [&]{ return m_stopping.load(std::memory_order_relaxed); }
+    );
+}
+void DiscordWebhookSender::throttle(const QString& webhook){
+    //  Discord told us to back off this webhook.
+    auto iter = m_blocked_until.find(webhook);
+    if (iter != m_blocked_until.end()){
+        if (iter->second > current_time()){
+            m_logger.log("Waiting for Discord rate limit to reset...", COLOR_RED);
+            sleep_until(iter->second);
+        }
+        m_blocked_until.erase(iter);
+    }
+
+    //  Our own limit across all webhooks.
+    double rate = GlobalSettings::instance().DISCORD->webhooks.sends_per_second;
+    WallClock now = current_time();
+    m_tokens = std::min(rate, m_tokens + rate * std::chrono::duration<double>(now - m_last_refill).count());
+    m_last_refill = now;
+    if (m_tokens < 1){
+        WallClock ready = now + std::chrono::duration_cast<WallClock::duration>(
+            std::chrono::duration<double>((1 - m_tokens) / rate)
         );
-        if (m_stopping.load(std::memory_order_relaxed)){
+        m_logger.log("Throttling webhook messages due to rate limit...", COLOR_RED);
+        sleep_until(ready);
+        m_tokens = 1;
+        m_last_refill = ready;
+    }
+    m_tokens -= 1;
+}
+
+
+void DiscordWebhookSender::enqueue(Message message){
+    const QString webhook = message.url.toString();
+    auto iter = m_batches.find(webhook);
+
+    //  Attachments are never coalesced. Send whatever is pending for this
+    //  webhook first to keep the messages in order.
+    if (!message.files.empty()){
+        if (iter != m_batches.end()){
+            flush(webhook, iter->second.id);
+        }
+        transmit(message);
+        return;
+    }
+
+    if (iter != m_batches.end()){
+        if (try_merge(iter->second.message, message)){
             return;
         }
-        m_sent.clear();
+        flush(webhook, iter->second.id);
+    }
+
+    uint64_t id = m_next_batch_id++;
+    m_batches.emplace(webhook, PendingBatch{id, std::move(message)});
+    m_queue.add_event(
+        COALESCE_WINDOW,
+        [this, webhook, id]{ flush(webhook, id); }
+    );
+}
+void DiscordWebhookSender::flush(const QString& webhook, uint64_t batch_id){
+    //  The batch may have already been sent early to make room for another.
+    auto iter = m_batches.find(webhook);
+    if (iter == m_batches.end() || iter->second.id != batch_id){
+        return;
+    }
+    Message message = std::move(iter->second.message);
+    m_batches.erase(iter);
+    transmit(message);
+}
+//  The embed text that Discord counts towards its per-message limit. This
+//  counts bytes, which is never less than the characters Discord counts.
+static size_t embed_text_length(const JsonArray* embeds){
+    if (embeds == nullptr){
+        return 0;
+    }
+    size_t total = 0;
+    auto add = [&](const JsonObject* obj, const std::string& key){
+        if (obj == nullptr){
+            return;
+        }
+        const std::string* str = obj->get_string(key);
+        if (str != nullptr){
+            total += str->size();
+        }
+    };
+    for (const JsonValue& item : *embeds){
+        const JsonObject* embed = item.to_object();
+        if (embed == nullptr){
+            continue;
+        }
+        add(embed, "title");
+        add(embed, "description");
+        add(embed->get_object("author"), "name");
+        add(embed->get_object("footer"), "text");
+        const JsonArray* fields = embed->get_array("fields");
+        if (fields == nullptr){
+            continue;
+        }
+        for (const JsonValue& field : *fields){
+            add(field.to_object(), "name");
+            add(field.to_object(), "value");
+        }
+    }
+    return total;
+}
+bool DiscordWebhookSender::try_merge(Message& batch, Message& message){
+    const std::string* batch_content = batch.json.get_string("content");
+    const std::string* message_content = message.json.get_string("content");
+    size_t content_length = 0;
+    content_length += batch_content == nullptr ? 0 : batch_content->size();
+    content_length += message_content == nullptr ? 0 : message_content->size();
+    if (content_length + 1 > MAX_CONTENT_LENGTH){
+        return false;
+    }
+
+    JsonArray* batch_embeds = batch.json.get_array("embeds");
+    JsonArray* message_embeds = message.json.get_array("embeds");
+    size_t embeds = 0;
+    embeds += batch_embeds == nullptr ? 0 : batch_embeds->size();
+    embeds += message_embeds == nullptr ? 0 : message_embeds->size();
+    if (embeds > MAX_EMBEDS){
+        return false;
+    }
+    if (embed_text_length(batch_embeds) + embed_text_length(message_embeds) > MAX_EMBED_TEXT_LENGTH){
+        return false;
+    }
+
+    //  Only merge messages that have nothing else in them.
+    for (const auto& item : message.json){
+        if (item.first != "content" && item.first != "embeds"){
+            return false;
+        }
+    }
+    for (const auto& item : batch.json){
+        if (item.first != "content" && item.first != "embeds"){
+            return false;
+        }
+    }
+
+    if (message_content != nullptr && !message_content->empty()){
+        std::string content = batch_content == nullptr ? "" : *batch_content;
+        if (!content.empty()){
+            content += "\n";
+        }
+        content += *message_content;
+        batch.json["content"] = std::move(content);
+    }
+    if (message_embeds != nullptr && !message_embeds->empty()){
+        if (batch_embeds == nullptr){
+            batch.json["embeds"] = JsonArray();
+            batch_embeds = batch.json.get_array("embeds");
+        }
+        for (JsonValue& embed : *message_embeds){
+            batch_embeds->push_back(std::move(embed));
+        }
+    }
+    for (auto& callback : message.finish_callbacks){
+        batch.finish_callbacks.emplace_back(std::move(callback));
+    }
+    return true;
+}
+void DiscordWebhookSender::transmit(Message& message){
+    const QString webhook = message.url.toString();
+    const JsonValue json(std::move(message.json));
+    for (size_t attempt = 0; attempt < MAX_ATTEMPTS; attempt++){
+        if (m_stopping.load(std::memory_order_acquire)){
+            break;
+        }
+        throttle(webhook);
+        if (!internal_send(message.url, json, message.files)){
+            break;
+        }
+        m_logger.log("Webhook message was rate limited. Retrying...", COLOR_RED);
+    }
+    for (auto& callback : message.finish_callbacks){
+        callback();
     }
-    m_sent.push_back(now);
 }
 
 
@@ -185,13 +355,32 @@ void DiscordWebhookSender::process_reply(QNetworkReply* reply){
 //        qDebug() << err;
     }
 }
+bool DiscordWebhookSender::process_rate_limit(const QString& webhook, QNetworkReply& reply){
+    int status = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    //  "Retry-After" comes with a 429. Otherwise, if the bucket is empty,
+    //  "X-RateLimit-Reset-After" says when it refills. Both are in seconds.
+    double wait_seconds = 0;
+    if (status == 429){
+        wait_seconds = std::max(reply.rawHeader("Retry-After").toDouble(), 1.0);
+    }else if (reply.hasRawHeader("X-RateLimit-Remaining") && reply.rawHeader("X-RateLimit-Remaining").toInt() == 0){
+        wait_seconds = reply.rawHeader("X-RateLimit-Reset-After").toDouble();
+    }
+
+    if (wait_seconds > 0){
+        m_blocked_until[webhook] = current_time() + std::chrono::duration_cast<WallClock::duration>(
+            std::chrono::duration<double>(wait_seconds)
+        );
+    }
+    return status == 429;
+}
 
-void DiscordWebhookSender::internal_send(
+bool DiscordWebhookSender::internal_send(
     const QUrl& url, const JsonValue& json,
     const std::vector<DiscordFileAttachment>& files
 ){
     if (m_stopping.load(std::memory_order_acquire)){
-        return;
+        return false;
     }
 
     {
@@ -199,6 +388,12 @@ void DiscordWebhookSender::internal_send(
         m_event_loop.reset(new QEventLoop);
     }
 
+    //  Created on first use so it lives on the worker thread.
+    if (!m_manager){
+        m_manager.reset(new QNetworkAccessManager);
+    }
+
+    bool retry = false;
     try{
         QHttpMultiPart multiPart(QHttpMultiPart::FormDataType);
         if (!json.is_null()){
@@ -211,6 +406,7 @@ void DiscordWebhookSender::internal_send(
             multiPart.append(json_part);
         }
 
+        //  Files are streamed from disk as the request is written.
         std::vector<QHttpPart> file_parts;
         std::deque<QFile> file_readers;
         file_parts.reserve(files.size());
@@ -232,17 +428,19 @@ void DiscordWebhookSender::internal_send(
         }
 
         QNetworkRequest request(url);
-        QNetworkAccessManager manager;
-        m_event_loop->connect(&manager, SIGNAL(finished(QNetworkReply*)), SLOT(quit()));
 //        cout << "Sending Webhook Message... (queue = " + tostr_u_commas(m_queue.size()) + ")" << endl;
         m_logger.log("Sending Webhook Message... (queue = " + tostr_u_commas(m_queue.size()) + ")", COLOR_BLUE);
-        std::unique_ptr<QNetworkReply> reply(manager.post(request, &multiPart));
+        std::unique_ptr<QNetworkReply> reply(m_manager->post(request, &multiPart));
+        m_event_loop->connect(reply.get(), SIGNAL(finished()), SLOT(quit()));
 
         if (!m_stopping.load(std::memory_order_acquire)){
 //            cout << "internal_send() - exec" << endl;
 
             m_event_loop->exec();
             process_reply(reply.get());
+            if (reply->isFinished()){
+                retry = process_rate_limit(url.toString(), *reply);
+            }
 
 //            cout << "internal_send() - end" << endl;
         }
@@ -254,10 +452,10 @@ void DiscordWebhookSender::internal_send(
 
     std::lock_guard<std::mutex> lg(m_send_lock);
     m_event_loop.reset();
+    return retry;
 }
 
 
-
 void send_embed(
     Logger& logger,
     bool should_ping,
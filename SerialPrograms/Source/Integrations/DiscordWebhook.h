@@ -7,16 +7,18 @@
 #ifndef PokemonAutomation_DiscordWebhook_H
 #define PokemonAutomation_DiscordWebhook_H
 
-#include <deque>
+#include <map>
 #include <condition_variable>
 #include <QNetworkReply>
 #include "Common/Cpp/Time.h"
+#include "Common/Cpp/Json/JsonObject.h"
 #include "Common/Cpp/Concurrency/ScheduledTaskRunner.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/Options/ScreenshotFormatOption.h"
 #include "CommonFramework/Notifications/MessageAttachment.h"
 
 class QEventLoop;
+class QNetworkAccessManager;
 
 namespace PokemonAutomation{
     class JsonArray;
@@ -31,11 +33,26 @@ struct DiscordFileAttachment{
 };
 
 
+//  All webhook messages go through a single worker thread which owns one
+//  long-lived QNetworkAccessManager, so connections to Discord are kept alive
+//  and reused across messages.
+//
+//  Text messages (no attachments) to the same webhook that become ready
+//  within COALESCE_WINDOW of each other are merged into one message as long
+//  as the result stays within Discord's limits: the content length, the
+//  number of embeds, and the total text across all embeds.
+//
+//  Sends are paced by a token bucket that refills at "sends_per_second".
+//  On top of that, each webhook is held back for as long as Discord's
+//  rate-limit headers say, and messages rejected with 429 are retried.
 class DiscordWebhookSender : public QObject{
     Q_OBJECT
 
-    static constexpr auto THROTTLE_DURATION = std::chrono::seconds(1);
-//    static constexpr size_t MAX_IN_WINDOW = 2;
+    static constexpr auto COALESCE_WINDOW = std::chrono::milliseconds(500);
+    static constexpr size_t MAX_CONTENT_LENGTH = 2000;
+    static constexpr size_t MAX_EMBEDS = 10;
+    static constexpr size_t MAX_EMBED_TEXT_LENGTH = 6000;
+    static constexpr size_t MAX_ATTEMPTS = 3;
 
 private:
     DiscordWebhookSender();
@@ -62,12 +79,32 @@ public:
 
 
 private:
+    struct Message{
+        QUrl url;
+        JsonObject json;
+        std::vector<DiscordFileAttachment> files;
+        std::vector<std::function<void()>> finish_callbacks;
+    };
+    struct PendingBatch{
+        uint64_t id;
+        Message message;
+    };
+
     void cleanup_stuck_requests();
-//    void thread_loop();
-    void throttle();
+    void sleep_until(WallClock time);
+    void throttle(const QString& webhook);
+
+    //  Everything below runs only on the worker thread.
+    void enqueue(Message message);
+    void flush(const QString& webhook, uint64_t batch_id);
+    static bool try_merge(Message& batch, Message& message);
+    void transmit(Message& message);
 
     void process_reply(QNetworkReply* reply);
-    void internal_send(
+    //  Returns true if Discord rejected the message due to rate limiting.
+    bool process_rate_limit(const QString& webhook, QNetworkReply& reply);
+    //  Returns true if the message should be retried.
+    bool internal_send(
         const QUrl& url, const JsonValue& json,
         const std::vector<DiscordFileAttachment>& files
     );
@@ -81,7 +118,20 @@ private:
     std::mutex m_send_lock;
     std::unique_ptr<QEventLoop> m_event_loop;
 
-    std::deque<WallClock> m_sent;
+    //  Owned by the worker thread. Destroyed after it has stopped.
+    std::unique_ptr<QNetworkAccessManager> m_manager;
+
+    //  Token bucket shared by all webhooks.
+    double m_tokens;
+    WallClock m_last_refill;
+
+    //  Per webhook: don't send before this time. From Discord's headers.
+    std::map<QString, WallClock> m_blocked_until;
+
+    //  Per webhook: text messages waiting to be coalesced.
+    std::map<QString, PendingBatch> m_batches;
+    uint64_t m_next_batch_id;
+
     AsyncDispatcher m_dispatcher;
     ScheduledTaskRunner m_queue;
 };
@@ -0,0 +1,167 @@
+/*  Image HSV
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_ImageHSV.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void rgb32_to_hsv32_Default(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+);
+void rgb32_to_hsv32_x64_SSE41(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+);
+void rgb32_to_hsv32_x64_AVX2(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+);
+void rgb32_to_hsv32_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+);
+void rgb32_to_hsv32_arm64_NEON(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+);
+
+HsvDistanceSum hsv32_distance_Default(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+HsvDistanceSum hsv32_distance_x64_SSE41(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+HsvDistanceSum hsv32_distance_x64_AVX2(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+HsvDistanceSum hsv32_distance_x64_AVX512(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+HsvDistanceSum hsv32_distance_arm64_NEON(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+
+
+
+void rgb32_to_hsv32(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        rgb32_to_hsv32_x64_AVX512(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        rgb32_to_hsv32_x64_AVX2(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        rgb32_to_hsv32_x64_SSE41(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        rgb32_to_hsv32_arm64_NEON(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+        return;
+    }
+#endif
+    rgb32_to_hsv32_Default(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+}
+
+
+using HsvDistanceFunction = HsvDistanceSum (*)(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+static HsvDistanceFunction hsv32_distance_function(){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        return hsv32_distance_x64_AVX512;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        return hsv32_distance_x64_AVX2;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        return hsv32_distance_x64_SSE41;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        return hsv32_distance_arm64_NEON;
+    }
+#endif
+    return hsv32_distance_Default;
+}
+
+HsvDistanceSum hsv32_distance(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    return hsv32_distance_function()(image0, bytes_per_row0, image1, bytes_per_row1, width, height);
+}
+
+void hsv32_distance_offsets(
+    const uint32_t* templ, size_t templ_bytes_per_row, size_t templ_width, size_t templ_height,
+    const uint32_t* query, size_t query_bytes_per_row, size_t query_width, size_t query_height,
+    size_t window_width, size_t window_height,
+    HsvDistanceSum* results, size_t offsets_x, size_t offsets_y
+){
+    HsvDistanceFunction function = hsv32_distance_function();
+
+    //  The template stays hot in cache across all the offsets.
+    for (size_t y = 0; y < offsets_y; y++){
+        size_t height = y < query_height
+            ? std::min(std::min(window_height, query_height - y), templ_height)
+            : 0;
+        for (size_t x = 0; x < offsets_x; x++){
+            size_t width = x < query_width
+                ? std::min(std::min(window_width, query_width - x), templ_width)
+                : 0;
+            const uint32_t* window = (const uint32_t*)((const char*)query + y * query_bytes_per_row) + x;
+            results[y * offsets_x + x] = width == 0 || height == 0
+                ? HsvDistanceSum()
+                : function(templ, templ_bytes_per_row, window, query_bytes_per_row, width, height);
+        }
+    }
+}
+
+
+
+}
+}
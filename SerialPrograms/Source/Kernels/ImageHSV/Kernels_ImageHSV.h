@@ -0,0 +1,71 @@
+/*  Image HSV
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Convert ARGB32 images to AHSV32 and compare AHSV32 images.
+ *
+ *  AHSV32 pixels are laid out as: A << 24 | H << 16 | S << 8 | V
+ *  where hue [0, 360) is mapped onto [0, 256).
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageHSV_H
+#define PokemonAutomation_Kernels_ImageHSV_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Convert an ARGB32 image to AHSV32. Alpha is passed through.
+//  "in" and "out" may be the same buffer.
+void rgb32_to_hsv32(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+);
+
+
+//  Only pixels that are opaque (alpha >= 128) in both images are counted.
+//  For each of them, "sum" accumulates:
+//
+//      2*dH^2 + 2*dS^2 + dV^2
+//
+//  where dH is the distance around the hue circle. (never more than 128)
+//
+//  This is twice the usual "dH^2 + dS^2 + 0.5*dV^2" so that it stays an
+//  integer. The RMS distance is sqrt(0.5 * sum / count).
+struct HsvDistanceSum{
+    uint64_t sum = 0;
+    uint64_t count = 0;
+};
+
+//  Compare two AHSV32 images of the same size.
+HsvDistanceSum hsv32_distance(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+);
+
+//  Slide a (window_width x window_height) window over "query" with its
+//  top-left corner at every (x, y) in [0, offsets_x) x [0, offsets_y).
+//  Compare each window against the top-left of "templ".
+//
+//  Windows and templates are clipped to the images the same way
+//  "sub_image()" clips, so the compared area may differ between offsets.
+//
+//  "results" has (offsets_x * offsets_y) entries. The result for (x, y) is
+//  at "results[y * offsets_x + x]".
+void hsv32_distance_offsets(
+    const uint32_t* templ, size_t templ_bytes_per_row, size_t templ_width, size_t templ_height,
+    const uint32_t* query, size_t query_bytes_per_row, size_t query_width, size_t query_height,
+    size_t window_width, size_t window_height,
+    HsvDistanceSum* results, size_t offsets_x, size_t offsets_y
+);
+
+
+}
+}
+#endif
@@ -0,0 +1,46 @@
+/*  Image HSV (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Kernels_ImageHSV_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageHSV_Default{
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t width){
+        rgb32_to_hsv32_row_Default(out, in, width);
+    }
+    static PA_FORCE_INLINE void distance_row(
+        uint64_t& sum, uint64_t& count,
+        const uint32_t* row0, const uint32_t* row1, size_t width
+    ){
+        hsv32_distance_row_Default(sum, count, row0, row1, width);
+    }
+};
+
+
+
+void rgb32_to_hsv32_Default(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+    convert_rgb32_to_hsv32<ImageHSV_Default>(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+}
+HsvDistanceSum hsv32_distance_Default(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    return compare_hsv32<ImageHSV_Default>(image0, bytes_per_row0, image1, bytes_per_row1, width, height);
+}
+
+
+
+}
+}
@@ -0,0 +1,137 @@
+/*  Image HSV Routines
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Scalar reference and shared drivers for the ImageHSV kernels.
+ *
+ *  Hue, saturation and value are all computed with integer math. The results
+ *  are identical to the original floating-point conversion.
+ *
+ *  With M = max(R,G,B), m = min(R,G,B), d = M - m:
+ *
+ *      V = M
+ *      S = 255 - (255*m + M/2) / M             (0 if M == 0)
+ *      H = (256*X + 3d) / 6d                   (0 if d == 0)
+ *
+ *  where X = G - B, B - R + 2d or R - G + 4d depending on which channel is
+ *  the max. When R is the max and G < B, H is negative and clamps to 0.
+ *
+ *  The numerators are less than 2^19 and the divisors at most 1530. So a
+ *  correctly rounded float division truncates to the exact quotient. This is
+ *  what the SIMD versions use.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageHSV_Routines_H
+#define PokemonAutomation_Kernels_ImageHSV_Routines_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageHSV.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+PA_FORCE_INLINE uint32_t rgb32_to_hsv32_pixel_Default(uint32_t pixel){
+    int r = (pixel >> 16) & 0xff;
+    int g = (pixel >>  8) & 0xff;
+    int b = pixel & 0xff;
+
+    int M = r > g ? r : g;
+    M = M > b ? M : b;
+    int m = r < g ? r : g;
+    m = m < b ? m : b;
+    int delta = M - m;
+
+    int S = M == 0 ? 0 : 255 - (255 * m + M / 2) / M;
+
+    int H = 0;
+    if (delta > 0){
+        int x;
+        if (M == r){
+            x = g - b;
+        }else if (M == g){
+            x = b - r + 2 * delta;
+        }else{
+            x = r - g + 4 * delta;
+        }
+        x = 256 * x + 3 * delta;
+        H = x < 0 ? 0 : x / (6 * delta);
+    }
+
+    return (pixel & 0xff000000) | ((uint32_t)H << 16) | ((uint32_t)S << 8) | (uint32_t)M;
+}
+PA_FORCE_INLINE void rgb32_to_hsv32_row_Default(uint32_t* out, const uint32_t* in, size_t width){
+    for (size_t c = 0; c < width; c++){
+        out[c] = rgb32_to_hsv32_pixel_Default(in[c]);
+    }
+}
+
+
+//  Returns (2*dH^2 + 2*dS^2 + dV^2) if both pixels are opaque. Otherwise 0.
+PA_FORCE_INLINE uint32_t hsv32_distance2_pixel_Default(uint32_t pixel0, uint32_t pixel1){
+    if ((pixel0 & pixel1) < 0x80000000){
+        return 0;
+    }
+    int h = ((pixel0 >> 16) & 0xff) - ((pixel1 >> 16) & 0xff);
+    int s = ((pixel0 >>  8) & 0xff) - ((pixel1 >>  8) & 0xff);
+    int v = (pixel0 & 0xff) - (pixel1 & 0xff);
+    h = h < 0 ? -h : h;
+    h = h > 128 ? 256 - h : h;
+    return 2 * (h*h + s*s) + v*v;
+}
+PA_FORCE_INLINE void hsv32_distance_row_Default(
+    uint64_t& sum, uint64_t& count,
+    const uint32_t* row0, const uint32_t* row1, size_t width
+){
+    for (size_t c = 0; c < width; c++){
+        sum += hsv32_distance2_pixel_Default(row0[c], row1[c]);
+        count += (row0[c] & row1[c]) >> 31;
+    }
+}
+
+
+
+//  The SIMD runners accumulate in 32-bit lanes. Each pixel adds less than
+//  2^18, so rows are fed to them in blocks short enough to never overflow.
+const size_t HSV_DISTANCE_BLOCK = 4096;
+
+template <typename Runner>
+void convert_rgb32_to_hsv32(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+    for (size_t r = 0; r < height; r++){
+        Runner::convert_row(out, in, width);
+        in = (const uint32_t*)((const char*)in + in_bytes_per_row);
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+
+template <typename Runner>
+HsvDistanceSum compare_hsv32(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    HsvDistanceSum ret;
+    for (size_t r = 0; r < height; r++){
+        for (size_t c = 0; c < width; c += HSV_DISTANCE_BLOCK){
+            size_t block = width - c < HSV_DISTANCE_BLOCK ? width - c : HSV_DISTANCE_BLOCK;
+            Runner::distance_row(ret.sum, ret.count, image0 + c, image1 + c, block);
+        }
+        image0 = (const uint32_t*)((const char*)image0 + bytes_per_row0);
+        image1 = (const uint32_t*)((const char*)image1 + bytes_per_row1);
+    }
+    return ret;
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,121 @@
+/*  Image HSV (arm64 NEON)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_arm64_20_M1
+
+#include <stdint.h>
+#include <arm_neon.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageHSV_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageHSV_arm64_NEON{
+    static PA_FORCE_INLINE uint32x4_t convert_pixels(uint32x4_t pixels){
+        const uint32x4_t mask = vdupq_n_u32(0xff);
+        const uint32x4_t one = vdupq_n_u32(1);
+        uint32x4_t r = vandq_u32(vshrq_n_u32(pixels, 16), mask);
+        uint32x4_t g = vandq_u32(vshrq_n_u32(pixels, 8), mask);
+        uint32x4_t b = vandq_u32(pixels, mask);
+
+        uint32x4_t M = vmaxq_u32(vmaxq_u32(r, g), b);
+        uint32x4_t m = vminq_u32(vminq_u32(r, g), b);
+        uint32x4_t delta = vsubq_u32(M, m);
+
+        //  S = 255 - (255*m + M/2) / M
+        float32x4_t num = vcvtq_f32_u32(vmlaq_u32(vshrq_n_u32(M, 1), m, mask));
+        float32x4_t den = vcvtq_f32_u32(vmaxq_u32(M, one));
+        uint32x4_t S = vsubq_u32(mask, vcvtq_u32_f32(vdivq_f32(num, den)));
+        S = vandq_u32(S, vtstq_u32(M, M));
+
+        //  H = (256*X + 3d) / 6d
+        int32x4_t sr = vreinterpretq_s32_u32(r);
+        int32x4_t sg = vreinterpretq_s32_u32(g);
+        int32x4_t sb = vreinterpretq_s32_u32(b);
+        int32x4_t d = vreinterpretq_s32_u32(delta);
+        int32x4_t x = vmlaq_n_s32(vsubq_s32(sr, sg), d, 4);
+        x = vbslq_s32(vceqq_u32(M, g), vmlaq_n_s32(vsubq_s32(sb, sr), d, 2), x);
+        x = vbslq_s32(vceqq_u32(M, r), vsubq_s32(sg, sb), x);
+        int32x4_t d3 = vmulq_n_s32(d, 3);
+        float32x4_t hnum = vcvtq_f32_s32(vaddq_s32(vshlq_n_s32(x, 8), d3));
+        float32x4_t hden = vcvtq_f32_s32(vmaxq_s32(vaddq_s32(d3, d3), vdupq_n_s32(1)));
+        int32x4_t H = vmaxq_s32(vcvtq_s32_f32(vdivq_f32(hnum, hden)), vdupq_n_s32(0));
+
+        uint32x4_t out = vandq_u32(pixels, vdupq_n_u32(0xff000000));
+        out = vorrq_u32(out, vshlq_n_u32(vreinterpretq_u32_s32(H), 16));
+        out = vorrq_u32(out, vshlq_n_u32(S, 8));
+        return vorrq_u32(out, M);
+    }
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t width){
+        size_t c = 0;
+        for (; c + 4 <= width; c += 4){
+            vst1q_u32(out + c, convert_pixels(vld1q_u32(in + c)));
+        }
+        rgb32_to_hsv32_row_Default(out + c, in + c, width - c);
+    }
+
+    static PA_FORCE_INLINE void distance_row(
+        uint64_t& sum, uint64_t& count,
+        const uint32_t* row0, const uint32_t* row1, size_t width
+    ){
+        const uint8x16_t hue = vreinterpretq_u8_u32(vdupq_n_u32(0x00ff0000));
+        const uint8x16_t color = vreinterpretq_u8_u32(vdupq_n_u32(0x00ffffff));
+        const uint16_t weights_array[4] = {1, 2, 2, 0};
+        const uint16x4_t weights = vld1_u16(weights_array);
+
+        uint32x4_t sum4 = vdupq_n_u32(0);
+        uint32x4_t count4 = vdupq_n_u32(0);
+        size_t c = 0;
+        for (; c + 4 <= width; c += 4){
+            uint32x4_t a = vld1q_u32(row0 + c);
+            uint32x4_t b = vld1q_u32(row1 + c);
+            uint32x4_t opaque = vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(vandq_u32(a, b)), 31));
+
+            //  Per-byte |a - b|. Hue wraps around.
+            uint8x16_t d = vabdq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b));
+            d = vbslq_u8(hue, vminq_u8(d, vsubq_u8(vdupq_n_u8(0), d)), d);
+            d = vandq_u8(d, vandq_u8(color, vreinterpretq_u8_u32(opaque)));
+
+            uint16x8_t lo = vmull_u8(vget_low_u8(d), vget_low_u8(d));
+            uint16x8_t hi = vmull_u8(vget_high_u8(d), vget_high_u8(d));
+            sum4 = vmlal_u16(sum4, vget_low_u16(lo), weights);
+            sum4 = vmlal_u16(sum4, vget_high_u16(lo), weights);
+            sum4 = vmlal_u16(sum4, vget_low_u16(hi), weights);
+            sum4 = vmlal_u16(sum4, vget_high_u16(hi), weights);
+            count4 = vsubq_u32(count4, opaque);
+        }
+        sum += vaddlvq_u32(sum4);
+        count += vaddvq_u32(count4);
+
+        hsv32_distance_row_Default(sum, count, row0 + c, row1 + c, width - c);
+    }
+};
+
+
+
+void rgb32_to_hsv32_arm64_NEON(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+    convert_rgb32_to_hsv32<ImageHSV_arm64_NEON>(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+}
+HsvDistanceSum hsv32_distance_arm64_NEON(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    return compare_hsv32<ImageHSV_arm64_NEON>(image0, bytes_per_row0, image1, bytes_per_row1, width, height);
+}
+
+
+
+}
+}
+#endif
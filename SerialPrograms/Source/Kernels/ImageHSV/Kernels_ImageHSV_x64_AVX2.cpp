@@ -0,0 +1,137 @@
+/*  Image HSV (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <stdint.h>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageHSV_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageHSV_x64_AVX2{
+    static PA_FORCE_INLINE __m256i convert_pixels(__m256i pixels){
+        const __m256i mask = _mm256_set1_epi32(0xff);
+        const __m256i one = _mm256_set1_epi32(1);
+        __m256i r = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), mask);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), mask);
+        __m256i b = _mm256_and_si256(pixels, mask);
+
+        __m256i M = _mm256_max_epi32(_mm256_max_epi32(r, g), b);
+        __m256i m = _mm256_min_epi32(_mm256_min_epi32(r, g), b);
+        __m256i delta = _mm256_sub_epi32(M, m);
+
+        //  S = 255 - (255*m + M/2) / M
+        __m256 num = _mm256_cvtepi32_ps(_mm256_add_epi32(
+            _mm256_sub_epi32(_mm256_slli_epi32(m, 8), m),
+            _mm256_srli_epi32(M, 1)
+        ));
+        __m256 den = _mm256_cvtepi32_ps(_mm256_max_epi32(M, one));
+        __m256i S = _mm256_sub_epi32(mask, _mm256_cvttps_epi32(_mm256_div_ps(num, den)));
+        S = _mm256_andnot_si256(_mm256_cmpeq_epi32(M, _mm256_setzero_si256()), S);
+
+        //  H = (256*X + 3d) / 6d
+        __m256i delta2 = _mm256_add_epi32(delta, delta);
+        __m256i x = _mm256_add_epi32(_mm256_sub_epi32(r, g), _mm256_add_epi32(delta2, delta2));
+        x = _mm256_blendv_epi8(x, _mm256_add_epi32(_mm256_sub_epi32(b, r), delta2), _mm256_cmpeq_epi32(M, g));
+        x = _mm256_blendv_epi8(x, _mm256_sub_epi32(g, b), _mm256_cmpeq_epi32(M, r));
+        __m256i delta3 = _mm256_add_epi32(delta2, delta);
+        num = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_slli_epi32(x, 8), delta3));
+        den = _mm256_cvtepi32_ps(_mm256_max_epi32(_mm256_add_epi32(delta3, delta3), one));
+        __m256i H = _mm256_max_epi32(_mm256_cvttps_epi32(_mm256_div_ps(num, den)), _mm256_setzero_si256());
+
+        __m256i out = _mm256_and_si256(pixels, _mm256_set1_epi32(0xff000000));
+        out = _mm256_or_si256(out, _mm256_slli_epi32(H, 16));
+        out = _mm256_or_si256(out, _mm256_slli_epi32(S, 8));
+        return _mm256_or_si256(out, M);
+    }
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t width){
+        size_t c = 0;
+        for (; c + 8 <= width; c += 8){
+            __m256i x = _mm256_loadu_si256((const __m256i*)(in + c));
+            _mm256_storeu_si256((__m256i*)(out + c), convert_pixels(x));
+        }
+        if (c < width){
+            __m256i mask = _mm256_cmpgt_epi32(
+                _mm256_set1_epi32((int32_t)(width - c)),
+                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+            );
+            __m256i x = _mm256_maskload_epi32((const int*)(in + c), mask);
+            _mm256_maskstore_epi32((int*)(out + c), mask, convert_pixels(x));
+        }
+    }
+
+    static PA_FORCE_INLINE void distance_row(
+        uint64_t& sum, uint64_t& count,
+        const uint32_t* row0, const uint32_t* row1, size_t width
+    ){
+        const __m256i hue = _mm256_set1_epi32(0x00ff0000);
+        const __m256i weights = _mm256_setr_epi16(1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0);
+
+        __m256i sum8 = _mm256_setzero_si256();
+        __m256i count8 = _mm256_setzero_si256();
+        size_t c = 0;
+        for (; c + 8 <= width; c += 8){
+            __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + c));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + c));
+            __m256i opaque = _mm256_srai_epi32(_mm256_and_si256(a, b), 31);
+
+            //  Per-byte |a - b|. Hue wraps around.
+            __m256i d = _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+            __m256i h = _mm256_min_epu8(d, _mm256_sub_epi8(_mm256_setzero_si256(), d));
+            d = _mm256_blendv_epi8(d, h, hue);
+            d = _mm256_and_si256(d, opaque);
+
+            __m256i lo = _mm256_unpacklo_epi8(d, _mm256_setzero_si256());
+            __m256i hi = _mm256_unpackhi_epi8(d, _mm256_setzero_si256());
+            sum8 = _mm256_add_epi32(sum8, _mm256_madd_epi16(lo, _mm256_mullo_epi16(lo, weights)));
+            sum8 = _mm256_add_epi32(sum8, _mm256_madd_epi16(hi, _mm256_mullo_epi16(hi, weights)));
+            count8 = _mm256_sub_epi32(count8, opaque);
+        }
+
+        //  Widen to 64-bit before folding.
+        __m256i sum4 = _mm256_add_epi64(
+            _mm256_cvtepu32_epi64(_mm256_castsi256_si128(sum8)),
+            _mm256_cvtepu32_epi64(_mm256_extracti128_si256(sum8, 1))
+        );
+        __m128i sum2 = _mm_add_epi64(_mm256_castsi256_si128(sum4), _mm256_extracti128_si256(sum4, 1));
+        sum += (uint64_t)_mm_cvtsi128_si64(sum2) + (uint64_t)_mm_extract_epi64(sum2, 1);
+
+        __m128i count4 = _mm_add_epi32(_mm256_castsi256_si128(count8), _mm256_extracti128_si256(count8, 1));
+        count4 = _mm_add_epi32(count4, _mm_unpackhi_epi64(count4, count4));
+        count4 = _mm_add_epi32(count4, _mm_shuffle_epi32(count4, 1));
+        count += (uint32_t)_mm_cvtsi128_si32(count4);
+
+        hsv32_distance_row_Default(sum, count, row0 + c, row1 + c, width - c);
+    }
+};
+
+
+
+void rgb32_to_hsv32_x64_AVX2(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+    convert_rgb32_to_hsv32<ImageHSV_x64_AVX2>(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+}
+HsvDistanceSum hsv32_distance_x64_AVX2(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    return compare_hsv32<ImageHSV_x64_AVX2>(image0, bytes_per_row0, image1, bytes_per_row1, width, height);
+}
+
+
+
+}
+}
+#endif
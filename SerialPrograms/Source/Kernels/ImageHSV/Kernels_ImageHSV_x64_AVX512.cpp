@@ -0,0 +1,140 @@
+/*  Image HSV (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+
+#include <stdint.h>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageHSV_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageHSV_x64_AVX512{
+    static PA_FORCE_INLINE __m512i convert_pixels(__m512i pixels){
+        const __m512i mask = _mm512_set1_epi32(0xff);
+        const __m512i one = _mm512_set1_epi32(1);
+        __m512i r = _mm512_and_si512(_mm512_srli_epi32(pixels, 16), mask);
+        __m512i g = _mm512_and_si512(_mm512_srli_epi32(pixels, 8), mask);
+        __m512i b = _mm512_and_si512(pixels, mask);
+
+        __m512i M = _mm512_max_epi32(_mm512_max_epi32(r, g), b);
+        __m512i m = _mm512_min_epi32(_mm512_min_epi32(r, g), b);
+        __m512i delta = _mm512_sub_epi32(M, m);
+
+        //  S = 255 - (255*m + M/2) / M
+        __m512 num = _mm512_cvtepi32_ps(_mm512_add_epi32(
+            _mm512_sub_epi32(_mm512_slli_epi32(m, 8), m),
+            _mm512_srli_epi32(M, 1)
+        ));
+        __m512 den = _mm512_cvtepi32_ps(_mm512_max_epi32(M, one));
+        __m512i S = _mm512_maskz_sub_epi32(
+            _mm512_test_epi32_mask(M, M),
+            mask, _mm512_cvttps_epi32(_mm512_div_ps(num, den))
+        );
+
+        //  H = (256*X + 3d) / 6d
+        __m512i delta2 = _mm512_add_epi32(delta, delta);
+        __m512i x = _mm512_add_epi32(_mm512_sub_epi32(r, g), _mm512_add_epi32(delta2, delta2));
+        x = _mm512_mask_add_epi32(x, _mm512_cmpeq_epi32_mask(M, g), _mm512_sub_epi32(b, r), delta2);
+        x = _mm512_mask_sub_epi32(x, _mm512_cmpeq_epi32_mask(M, r), g, b);
+        __m512i delta3 = _mm512_add_epi32(delta2, delta);
+        num = _mm512_cvtepi32_ps(_mm512_add_epi32(_mm512_slli_epi32(x, 8), delta3));
+        den = _mm512_cvtepi32_ps(_mm512_max_epi32(_mm512_add_epi32(delta3, delta3), one));
+        __m512i H = _mm512_max_epi32(_mm512_cvttps_epi32(_mm512_div_ps(num, den)), _mm512_setzero_si512());
+
+        __m512i out = _mm512_and_si512(pixels, _mm512_set1_epi32(0xff000000));
+        out = _mm512_or_si512(out, _mm512_slli_epi32(H, 16));
+        out = _mm512_or_si512(out, _mm512_slli_epi32(S, 8));
+        return _mm512_or_si512(out, M);
+    }
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t width){
+        size_t c = 0;
+        for (; c + 16 <= width; c += 16){
+            __m512i x = _mm512_loadu_si512(in + c);
+            _mm512_storeu_si512(out + c, convert_pixels(x));
+        }
+        if (c < width){
+            __mmask16 mask = (__mmask16)(((uint32_t)1 << (width - c)) - 1);
+            __m512i x = _mm512_maskz_loadu_epi32(mask, in + c);
+            _mm512_mask_storeu_epi32(out + c, mask, convert_pixels(x));
+        }
+    }
+
+    static PA_FORCE_INLINE void accumulate(
+        __m512i& sum16, __m512i& count16, __m512i a, __m512i b
+    ){
+        const __m512i weights = _mm512_set4_epi32(0x00000002, 0x00020001, 0x00000002, 0x00020001);
+
+        __mmask16 opaque = _mm512_test_epi32_mask(_mm512_and_si512(a, b), _mm512_set1_epi32(0x80000000));
+
+        //  Per-byte |a - b|. Hue wraps around.
+        __m512i d = _mm512_or_si512(_mm512_subs_epu8(a, b), _mm512_subs_epu8(b, a));
+        __m512i h = _mm512_min_epu8(d, _mm512_sub_epi8(_mm512_setzero_si512(), d));
+        d = _mm512_mask_mov_epi8(d, 0x4444444444444444, h);
+        d = _mm512_maskz_mov_epi32(opaque, d);
+
+        __m512i lo = _mm512_unpacklo_epi8(d, _mm512_setzero_si512());
+        __m512i hi = _mm512_unpackhi_epi8(d, _mm512_setzero_si512());
+        sum16 = _mm512_add_epi32(sum16, _mm512_madd_epi16(lo, _mm512_mullo_epi16(lo, weights)));
+        sum16 = _mm512_add_epi32(sum16, _mm512_madd_epi16(hi, _mm512_mullo_epi16(hi, weights)));
+        count16 = _mm512_mask_add_epi32(count16, opaque, count16, _mm512_set1_epi32(1));
+    }
+    static PA_FORCE_INLINE void distance_row(
+        uint64_t& sum, uint64_t& count,
+        const uint32_t* row0, const uint32_t* row1, size_t width
+    ){
+        __m512i sum16 = _mm512_setzero_si512();
+        __m512i count16 = _mm512_setzero_si512();
+        size_t c = 0;
+        for (; c + 16 <= width; c += 16){
+            accumulate(sum16, count16, _mm512_loadu_si512(row0 + c), _mm512_loadu_si512(row1 + c));
+        }
+        if (c < width){
+            //  Masked-off pixels load as zero, which is transparent.
+            __mmask16 mask = (__mmask16)(((uint32_t)1 << (width - c)) - 1);
+            accumulate(
+                sum16, count16,
+                _mm512_maskz_loadu_epi32(mask, row0 + c),
+                _mm512_maskz_loadu_epi32(mask, row1 + c)
+            );
+        }
+
+        //  Widen to 64-bit before folding.
+        __m512i sum8 = _mm512_add_epi64(
+            _mm512_cvtepu32_epi64(_mm512_castsi512_si256(sum16)),
+            _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(sum16, 1))
+        );
+        sum += (uint64_t)_mm512_reduce_add_epi64(sum8);
+        count += (uint32_t)_mm512_reduce_add_epi32(count16);
+    }
+};
+
+
+
+void rgb32_to_hsv32_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+    convert_rgb32_to_hsv32<ImageHSV_x64_AVX512>(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+}
+HsvDistanceSum hsv32_distance_x64_AVX512(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    return compare_hsv32<ImageHSV_x64_AVX512>(image0, bytes_per_row0, image1, bytes_per_row1, width, height);
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,124 @@
+/*  Image HSV (x64 SSE4.1)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <stdint.h>
+#include <smmintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageHSV_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageHSV_x64_SSE41{
+    static PA_FORCE_INLINE __m128i convert_pixels(__m128i pixels){
+        const __m128i mask = _mm_set1_epi32(0xff);
+        __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), mask);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), mask);
+        __m128i b = _mm_and_si128(pixels, mask);
+
+        __m128i M = _mm_max_epi32(_mm_max_epi32(r, g), b);
+        __m128i m = _mm_min_epi32(_mm_min_epi32(r, g), b);
+        __m128i delta = _mm_sub_epi32(M, m);
+
+        //  S = 255 - (255*m + M/2) / M
+        __m128 num = _mm_cvtepi32_ps(_mm_add_epi32(
+            _mm_sub_epi32(_mm_slli_epi32(m, 8), m),
+            _mm_srli_epi32(M, 1)
+        ));
+        __m128 den = _mm_cvtepi32_ps(_mm_max_epi32(M, _mm_set1_epi32(1)));
+        __m128i S = _mm_sub_epi32(mask, _mm_cvttps_epi32(_mm_div_ps(num, den)));
+        S = _mm_andnot_si128(_mm_cmpeq_epi32(M, _mm_setzero_si128()), S);
+
+        //  H = (256*X + 3d) / 6d
+        __m128i delta2 = _mm_add_epi32(delta, delta);
+        __m128i x = _mm_add_epi32(_mm_sub_epi32(r, g), _mm_add_epi32(delta2, delta2));
+        x = _mm_blendv_epi8(x, _mm_add_epi32(_mm_sub_epi32(b, r), delta2), _mm_cmpeq_epi32(M, g));
+        x = _mm_blendv_epi8(x, _mm_sub_epi32(g, b), _mm_cmpeq_epi32(M, r));
+        __m128i delta3 = _mm_add_epi32(delta2, delta);
+        num = _mm_cvtepi32_ps(_mm_add_epi32(_mm_slli_epi32(x, 8), delta3));
+        den = _mm_cvtepi32_ps(_mm_max_epi32(_mm_add_epi32(delta3, delta3), _mm_set1_epi32(1)));
+        __m128i H = _mm_max_epi32(_mm_cvttps_epi32(_mm_div_ps(num, den)), _mm_setzero_si128());
+
+        __m128i out = _mm_and_si128(pixels, _mm_set1_epi32(0xff000000));
+        out = _mm_or_si128(out, _mm_slli_epi32(H, 16));
+        out = _mm_or_si128(out, _mm_slli_epi32(S, 8));
+        return _mm_or_si128(out, M);
+    }
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t width){
+        size_t c = 0;
+        for (; c + 4 <= width; c += 4){
+            __m128i x = _mm_loadu_si128((const __m128i*)(in + c));
+            _mm_storeu_si128((__m128i*)(out + c), convert_pixels(x));
+        }
+        rgb32_to_hsv32_row_Default(out + c, in + c, width - c);
+    }
+
+    static PA_FORCE_INLINE void distance_row(
+        uint64_t& sum, uint64_t& count,
+        const uint32_t* row0, const uint32_t* row1, size_t width
+    ){
+        const __m128i hue = _mm_set1_epi32(0x00ff0000);
+        const __m128i weights = _mm_setr_epi16(1, 2, 2, 0, 1, 2, 2, 0);
+
+        __m128i sum4 = _mm_setzero_si128();
+        __m128i count4 = _mm_setzero_si128();
+        size_t c = 0;
+        for (; c + 4 <= width; c += 4){
+            __m128i a = _mm_loadu_si128((const __m128i*)(row0 + c));
+            __m128i b = _mm_loadu_si128((const __m128i*)(row1 + c));
+            __m128i opaque = _mm_srai_epi32(_mm_and_si128(a, b), 31);
+
+            //  Per-byte |a - b|. Hue wraps around.
+            __m128i d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+            __m128i h = _mm_min_epu8(d, _mm_sub_epi8(_mm_setzero_si128(), d));
+            d = _mm_blendv_epi8(d, h, hue);
+            d = _mm_and_si128(d, opaque);
+
+            __m128i lo = _mm_cvtepu8_epi16(d);
+            __m128i hi = _mm_unpackhi_epi8(d, _mm_setzero_si128());
+            sum4 = _mm_add_epi32(sum4, _mm_madd_epi16(lo, _mm_mullo_epi16(lo, weights)));
+            sum4 = _mm_add_epi32(sum4, _mm_madd_epi16(hi, _mm_mullo_epi16(hi, weights)));
+            count4 = _mm_sub_epi32(count4, opaque);
+        }
+
+        sum += (uint64_t)(uint32_t)_mm_cvtsi128_si32(sum4);
+        sum += (uint64_t)(uint32_t)_mm_extract_epi32(sum4, 1);
+        sum += (uint64_t)(uint32_t)_mm_extract_epi32(sum4, 2);
+        sum += (uint64_t)(uint32_t)_mm_extract_epi32(sum4, 3);
+        count4 = _mm_add_epi32(count4, _mm_unpackhi_epi64(count4, count4));
+        count4 = _mm_add_epi32(count4, _mm_shuffle_epi32(count4, 1));
+        count += (uint32_t)_mm_cvtsi128_si32(count4);
+
+        hsv32_distance_row_Default(sum, count, row0 + c, row1 + c, width - c);
+    }
+};
+
+
+
+void rgb32_to_hsv32_x64_SSE41(
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    size_t width, size_t height
+){
+    convert_rgb32_to_hsv32<ImageHSV_x64_SSE41>(in, in_bytes_per_row, out, out_bytes_per_row, width, height);
+}
+HsvDistanceSum hsv32_distance_x64_SSE41(
+    const uint32_t* image0, size_t bytes_per_row0,
+    const uint32_t* image1, size_t bytes_per_row1,
+    size_t width, size_t height
+){
+    return compare_hsv32<ImageHSV_x64_SSE41>(image0, bytes_per_row0, image1, bytes_per_row1, width, height);
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,135 @@
+/*  Image Scale
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_ImageScale.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void scale_nearest_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+
+void scale_bilinear_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_bilinear_x64_SSE41(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_bilinear_x64_AVX2(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_bilinear_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_bilinear_arm64_NEON(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+
+void scale_area_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_area_x64_SSE41(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_area_x64_AVX2(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_area_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+void scale_area_arm64_NEON(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+
+
+
+//  Nearest is just a gather and a copy. There's nothing for SIMD to do.
+void scale_nearest(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    scale_nearest_Default(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+}
+void scale_bilinear(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        scale_bilinear_x64_AVX512(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        scale_bilinear_x64_AVX2(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        scale_bilinear_x64_SSE41(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        scale_bilinear_arm64_NEON(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+    scale_bilinear_Default(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+}
+void scale_area(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        scale_area_x64_AVX512(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        scale_area_x64_AVX2(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        scale_area_x64_SSE41(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        scale_area_arm64_NEON(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+        return;
+    }
+#endif
+    scale_area_Default(in, in_bytes_per_row, in_width, in_height, out, out_bytes_per_row, out_width, out_height);
+}
+
+
+
+
+}
+}
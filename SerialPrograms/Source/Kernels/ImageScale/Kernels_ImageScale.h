@@ -0,0 +1,48 @@
+/*  Image Scale
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Resample an ARGB32 image to a different size.
+ *
+ *  All channels (including alpha) are resampled independently. Nothing is
+ *  premultiplied.
+ *
+ *  "in" and "out" must not overlap.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageScale_H
+#define PokemonAutomation_Kernels_ImageScale_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Each output pixel takes the input pixel under its center.
+void scale_nearest(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+
+//  Each output pixel blends the 2x2 input pixels around its center.
+//  Good for upscaling and mild downscaling. Aliases when shrinking by more
+//  than 2x.
+void scale_bilinear(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+
+//  Each output pixel is the average of the box of input pixels it covers.
+//  Intended for downscaling. When upscaling, it degrades to nearest.
+void scale_area(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+);
+
+
+}
+}
+#endif
@@ -0,0 +1,107 @@
+/*  Image Scale (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "Common/Compiler.h"
+#include "Kernels_ImageScale_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+void scale_nearest_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    if (in_width == 0 || in_height == 0 || out_width == 0 || out_height == 0){
+        return;
+    }
+
+    std::vector<uint32_t> x_index(out_width);
+    for (size_t c = 0; c < out_width; c++){
+        x_index[c] = (uint32_t)((2 * (uint64_t)c + 1) * in_width / (2 * (uint64_t)out_width));
+    }
+
+    const uint32_t* previous_in = nullptr;
+    const uint32_t* previous_out = nullptr;
+    for (size_t r = 0; r < out_height; r++){
+        size_t y = (2 * (uint64_t)r + 1) * in_height / (2 * (uint64_t)out_height);
+        const uint32_t* row = (const uint32_t*)((const char*)in + y * in_bytes_per_row);
+
+        //  When upscaling, consecutive output rows come from the same input row.
+        if (row == previous_in){
+            memcpy(out, previous_out, out_width * sizeof(uint32_t));
+        }else{
+            for (size_t c = 0; c < out_width; c++){
+                out[c] = row[x_index[c]];
+            }
+            previous_in = row;
+        }
+        previous_out = out;
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+
+
+
+struct ImageScale_Default{
+    static PA_FORCE_INLINE void blend_rows(
+        uint16_t* out, const uint32_t* row0, const uint32_t* row1,
+        size_t width, uint32_t weight
+    ){
+        scale_blend_rows_Default(out, (const uint8_t*)row0, (const uint8_t*)row1, 4 * width, weight);
+    }
+    static PA_FORCE_INLINE void blend_columns(
+        uint32_t* out, const uint16_t* row,
+        const ScaleBilinearTap* taps, size_t width
+    ){
+        for (size_t c = 0; c < width; c++){
+            out[c] = scale_blend_columns_Default(row + 4 * taps[c].index, taps[c].weight);
+        }
+    }
+    static PA_FORCE_INLINE void accumulate_row(
+        uint16_t* columns, const uint32_t* row, size_t width
+    ){
+        scale_accumulate_row_Default(columns, (const uint8_t*)row, 4 * width);
+    }
+    static PA_FORCE_INLINE void accumulate_spans(
+        uint32_t* sums, const uint16_t* columns,
+        const ScaleAreaSpan* spans, size_t width
+    ){
+        for (size_t c = 0; c < width; c++){
+            scale_accumulate_span_Default(sums + 4 * c, columns + 4 * spans[c].begin, spans[c].count);
+        }
+    }
+};
+
+
+
+void scale_bilinear_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_bilinear<ImageScale_Default>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+void scale_area_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_area<ImageScale_Default>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+
+
+
+}
+}
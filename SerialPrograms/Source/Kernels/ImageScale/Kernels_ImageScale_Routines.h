@@ -0,0 +1,254 @@
+/*  Image Scale Routines
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      The parts of the resamplers that are the same for every instruction
+ *  set: computing the source coordinates and walking the rows. Each
+ *  instruction set only provides the inner row loops.
+ *
+ *  All arithmetic is integer so that every instruction set produces the
+ *  exact same output.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageScale_Routines_H
+#define PokemonAutomation_Kernels_ImageScale_Routines_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Bilinear weights are in units of 1/128. A vertical blend of two 8-bit
+//  values fits in 15 bits. So a horizontal blend of those can use signed
+//  16-bit multiply-add.
+static const uint32_t SCALE_BILINEAR_ONE = 128;
+static const uint32_t SCALE_BILINEAR_SHIFT = 14;   //  log2(128 * 128)
+
+
+struct ScaleBilinearTap{
+    uint32_t index;     //  Left/top source pixel. The other is index + 1.
+    uint32_t weight;    //  Weight of (index + 1) in units of 1/128.
+};
+struct ScaleAreaSpan{
+    uint32_t begin;
+    uint32_t count;
+};
+
+
+//  Sample at the centers of the output pixels:
+//      (c + 0.5) * in / out - 0.5
+//  This is computed exactly in units of 1 / (2 * out).
+inline std::vector<ScaleBilinearTap> make_bilinear_taps(size_t in, size_t out){
+    std::vector<ScaleBilinearTap> taps(out);
+    uint64_t denominator = 2 * (uint64_t)out;
+    for (size_t c = 0; c < out; c++){
+        uint64_t numerator = (2 * (uint64_t)c + 1) * in;
+        numerator = numerator < out ? 0 : numerator - out;
+        uint64_t index = numerator / denominator;
+        uint64_t weight = ((numerator % denominator) * SCALE_BILINEAR_ONE + out) / denominator;
+        if (weight == SCALE_BILINEAR_ONE){
+            index++;
+            weight = 0;
+        }
+        if (index >= in - 1){
+            index = in - 1;
+            weight = 0;
+        }
+        taps[c] = ScaleBilinearTap{(uint32_t)index, (uint32_t)weight};
+    }
+    return taps;
+}
+inline std::vector<ScaleAreaSpan> make_area_spans(size_t in, size_t out){
+    std::vector<ScaleAreaSpan> spans(out);
+    for (size_t c = 0; c < out; c++){
+        uint64_t begin = (uint64_t)c * in / out;
+        uint64_t end = ((uint64_t)c + 1) * in / out;
+        if (end <= begin){
+            end = begin + 1;
+        }
+        spans[c] = ScaleAreaSpan{(uint32_t)begin, (uint32_t)(end - begin)};
+    }
+    return spans;
+}
+
+
+
+//  Scalar row loops. Used by the default runner and for the tails of the
+//  vectorized ones.
+
+//  out[i] = row0[i] * (128 - weight) + row1[i] * weight    (per byte)
+PA_FORCE_INLINE void scale_blend_rows_Default(
+    uint16_t* out, const uint8_t* row0, const uint8_t* row1,
+    size_t bytes, uint32_t weight
+){
+    uint32_t weight0 = SCALE_BILINEAR_ONE - weight;
+    for (size_t c = 0; c < bytes; c++){
+        out[c] = (uint16_t)(row0[c] * weight0 + row1[c] * weight);
+    }
+}
+PA_FORCE_INLINE uint32_t scale_blend_columns_Default(const uint16_t* pixels, uint32_t weight){
+    uint32_t weight0 = SCALE_BILINEAR_ONE - weight;
+    const uint32_t ROUND = (uint32_t)1 << (SCALE_BILINEAR_SHIFT - 1);
+    uint32_t ret = 0;
+    for (size_t c = 0; c < 4; c++){
+        uint32_t x = pixels[c] * weight0 + pixels[c + 4] * weight;
+        ret |= ((x + ROUND) >> SCALE_BILINEAR_SHIFT) << (8 * c);
+    }
+    return ret;
+}
+//  Vertical sums of up to this many rows fit in 15 bits. So they can be
+//  summed horizontally with signed 16-bit multiply-add.
+static const size_t SCALE_AREA_MAX_ROWS = 32767 / 255;
+
+PA_FORCE_INLINE void scale_accumulate_row_Default(
+    uint16_t* sums, const uint8_t* row, size_t bytes
+){
+    for (size_t c = 0; c < bytes; c++){
+        sums[c] += row[c];
+    }
+}
+//  Add the 4 channels of "count" columns into sums[0..3].
+PA_FORCE_INLINE void scale_accumulate_span_Default(
+    uint32_t* sums, const uint16_t* columns, size_t count
+){
+    uint32_t s0 = sums[0], s1 = sums[1], s2 = sums[2], s3 = sums[3];
+    for (size_t c = 0; c < count; c++){
+        s0 += columns[0];
+        s1 += columns[1];
+        s2 += columns[2];
+        s3 += columns[3];
+        columns += 4;
+    }
+    sums[0] = s0;
+    sums[1] = s1;
+    sums[2] = s2;
+    sums[3] = s3;
+}
+
+
+
+//  Returns round(sum / count) with "inverse" = 1.0 / count.
+//
+//  Integer divides are slow enough to dominate a downscale. The extra 0.5
+//  keeps the true quotient at least 0.5 / count away from an integer. That's
+//  far more than the rounding error of the multiply. So the truncation is
+//  always exact.
+PA_FORCE_INLINE uint32_t scale_area_average(uint32_t sum, uint32_t count, double inverse){
+    return (uint32_t)(((double)sum + (double)(count / 2) + 0.5) * inverse);
+}
+
+
+
+// Runner interface:
+//  - Runner::blend_rows(uint16_t* out, const uint32_t* row0, const uint32_t* row1, size_t width, uint32_t weight)
+//      Vertical bilinear pass. Writes 4 * width uint16_t.
+//  - Runner::blend_columns(uint32_t* out, const uint16_t* row, const ScaleBilinearTap* taps, size_t width)
+//      Horizontal bilinear pass. For each output pixel, reads source pixels
+//      "index" and "index + 1" of "row".
+//  - Runner::accumulate_row(uint16_t* columns, const uint32_t* row, size_t width)
+//      Add each channel of each pixel of "row" into "columns".
+//  - Runner::accumulate_spans(uint32_t* sums, const uint16_t* columns, const ScaleAreaSpan* spans, size_t width)
+//      For each output pixel, add the 4 channels of the columns in its span
+//      into its 4 entries of "sums".
+
+template <typename Runner>
+void resample_bilinear(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    if (in_width == 0 || in_height == 0 || out_width == 0 || out_height == 0){
+        return;
+    }
+
+    std::vector<ScaleBilinearTap> x_taps = make_bilinear_taps(in_width, out_width);
+    std::vector<ScaleBilinearTap> y_taps = make_bilinear_taps(in_height, out_height);
+
+    //  The vertically blended source row. It has an extra pixel on the end
+    //  so that the last tap can always read (index + 1).
+    std::vector<uint16_t> row(4 * (in_width + 1));
+
+    ScaleBilinearTap current{(uint32_t)-1, 0};
+    for (size_t r = 0; r < out_height; r++){
+        const ScaleBilinearTap& tap = y_taps[r];
+
+        //  Adjacent output rows often share the same source rows.
+        if (tap.index != current.index || tap.weight != current.weight){
+            current = tap;
+            const uint32_t* row0 = (const uint32_t*)((const char*)in + tap.index * in_bytes_per_row);
+            const uint32_t* row1 = tap.weight == 0
+                ? row0
+                : (const uint32_t*)((const char*)row0 + in_bytes_per_row);
+            Runner::blend_rows(row.data(), row0, row1, in_width, tap.weight);
+            memcpy(&row[4 * in_width], &row[4 * (in_width - 1)], 4 * sizeof(uint16_t));
+        }
+
+        Runner::blend_columns(out, row.data(), x_taps.data(), out_width);
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+
+template <typename Runner>
+void resample_area(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    if (in_width == 0 || in_height == 0 || out_width == 0 || out_height == 0){
+        return;
+    }
+
+    std::vector<ScaleAreaSpan> x_spans = make_area_spans(in_width, out_width);
+    std::vector<ScaleAreaSpan> y_spans = make_area_spans(in_height, out_height);
+
+    //  Sum the rows of each output row vertically in 16 bits, then sum
+    //  those horizontally into 32 bits.
+    std::vector<uint16_t> column_sums(4 * in_width);
+    std::vector<uint32_t> box_sums(4 * out_width);
+
+    for (size_t r = 0; r < out_height; r++){
+        const ScaleAreaSpan& y_span = y_spans[r];
+
+        memset(box_sums.data(), 0, box_sums.size() * sizeof(uint32_t));
+        const uint32_t* row = (const uint32_t*)((const char*)in + y_span.begin * in_bytes_per_row);
+        size_t rows_left = y_span.count;
+        while (rows_left > 0){
+            size_t block = rows_left < SCALE_AREA_MAX_ROWS ? rows_left : SCALE_AREA_MAX_ROWS;
+            rows_left -= block;
+            memset(column_sums.data(), 0, column_sums.size() * sizeof(uint16_t));
+            do{
+                Runner::accumulate_row(column_sums.data(), row, in_width);
+                row = (const uint32_t*)((const char*)row + in_bytes_per_row);
+            }while (--block);
+            Runner::accumulate_spans(box_sums.data(), column_sums.data(), x_spans.data(), out_width);
+        }
+
+        uint32_t count = 0;
+        double inverse = 0;
+        for (size_t c = 0; c < out_width; c++){
+            //  There are at most 2 different counts across a row.
+            if (count != x_spans[c].count * y_span.count){
+                count = x_spans[c].count * y_span.count;
+                inverse = 1.0 / count;
+            }
+            const uint32_t* sums = &box_sums[4 * c];
+            uint32_t pixel = 0;
+            pixel |= scale_area_average(sums[0], count, inverse) <<  0;
+            pixel |= scale_area_average(sums[1], count, inverse) <<  8;
+            pixel |= scale_area_average(sums[2], count, inverse) << 16;
+            pixel |= scale_area_average(sums[3], count, inverse) << 24;
+            out[c] = pixel;
+        }
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,125 @@
+/*  Image Scale (arm64 NEON)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_arm64_20_M1
+
+#include <stdint.h>
+#include <arm_neon.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageScale_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageScale_arm64_NEON{
+    static PA_FORCE_INLINE void blend_rows(
+        uint16_t* out, const uint32_t* row0, const uint32_t* row1,
+        size_t width, uint32_t weight
+    ){
+        const uint8x8_t w0 = vdup_n_u8((uint8_t)(SCALE_BILINEAR_ONE - weight));
+        const uint8x8_t w1 = vdup_n_u8((uint8_t)weight);
+
+        const uint8_t* in0 = (const uint8_t*)row0;
+        const uint8_t* in1 = (const uint8_t*)row1;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 16 <= bytes; c += 16){
+            uint8x16_t a = vld1q_u8(in0 + c);
+            uint8x16_t b = vld1q_u8(in1 + c);
+            uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), w0), vget_low_u8(b), w1);
+            uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), w0), vget_high_u8(b), w1);
+            vst1q_u16(out + c + 0, lo);
+            vst1q_u16(out + c + 8, hi);
+        }
+        scale_blend_rows_Default(out + c, in0 + c, in1 + c, bytes - c, weight);
+    }
+
+    static PA_FORCE_INLINE uint16x4_t blend_pixel(const uint16_t* pixels, uint32_t weight){
+        uint32x4_t x = vmull_n_u16(vld1_u16(pixels), (uint16_t)(SCALE_BILINEAR_ONE - weight));
+        x = vmlal_n_u16(x, vld1_u16(pixels + 4), (uint16_t)weight);
+        return vrshrn_n_u32(x, SCALE_BILINEAR_SHIFT);
+    }
+    static PA_FORCE_INLINE void blend_columns(
+        uint32_t* out, const uint16_t* row,
+        const ScaleBilinearTap* taps, size_t width
+    ){
+        size_t c = 0;
+        for (; c + 2 <= width; c += 2){
+            uint16x8_t x = vcombine_u16(
+                blend_pixel(row + 4 * taps[c + 0].index, taps[c + 0].weight),
+                blend_pixel(row + 4 * taps[c + 1].index, taps[c + 1].weight)
+            );
+            vst1_u8((uint8_t*)(out + c), vmovn_u16(x));
+        }
+        if (c < width){
+            out[c] = scale_blend_columns_Default(row + 4 * taps[c].index, taps[c].weight);
+        }
+    }
+
+    static PA_FORCE_INLINE void accumulate_row(
+        uint16_t* columns, const uint32_t* row, size_t width
+    ){
+        const uint8_t* in = (const uint8_t*)row;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 16 <= bytes; c += 16){
+            uint8x16_t x = vld1q_u8(in + c);
+            vst1q_u16(columns + c + 0, vaddw_u8(vld1q_u16(columns + c + 0), vget_low_u8(x)));
+            vst1q_u16(columns + c + 8, vaddw_u8(vld1q_u16(columns + c + 8), vget_high_u8(x)));
+        }
+        scale_accumulate_row_Default(columns + c, in + c, bytes - c);
+    }
+    static PA_FORCE_INLINE void accumulate_spans(
+        uint32_t* sums, const uint16_t* columns,
+        const ScaleAreaSpan* spans, size_t width
+    ){
+        for (size_t c = 0; c < width; c++){
+            const uint16_t* s = columns + 4 * spans[c].begin;
+            size_t count = spans[c].count;
+
+            uint32x4_t acc = vld1q_u32(sums + 4 * c);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2){
+                uint16x8_t x = vld1q_u16(s + 4 * i);
+                acc = vaddw_u16(acc, vget_low_u16(x));
+                acc = vaddw_u16(acc, vget_high_u16(x));
+            }
+            if (i < count){
+                acc = vaddw_u16(acc, vld1_u16(s + 4 * i));
+            }
+            vst1q_u32(sums + 4 * c, acc);
+        }
+    }
+};
+
+
+
+void scale_bilinear_arm64_NEON(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_bilinear<ImageScale_arm64_NEON>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+void scale_area_arm64_NEON(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_area<ImageScale_arm64_NEON>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+
+
+
+}
+}
+#endif
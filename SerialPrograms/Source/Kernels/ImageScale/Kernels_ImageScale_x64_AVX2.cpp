@@ -0,0 +1,152 @@
+/*  Image Scale (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <stdint.h>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageScale_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageScale_x64_AVX2{
+    static PA_FORCE_INLINE void blend_rows(
+        uint16_t* out, const uint32_t* row0, const uint32_t* row1,
+        size_t width, uint32_t weight
+    ){
+        const __m256i w0 = _mm256_set1_epi16((int16_t)(SCALE_BILINEAR_ONE - weight));
+        const __m256i w1 = _mm256_set1_epi16((int16_t)weight);
+
+        const uint8_t* in0 = (const uint8_t*)row0;
+        const uint8_t* in1 = (const uint8_t*)row1;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 32 <= bytes; c += 32){
+            __m256i aL = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in0 + c +  0)));
+            __m256i aH = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in0 + c + 16)));
+            __m256i bL = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in1 + c +  0)));
+            __m256i bH = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in1 + c + 16)));
+            aL = _mm256_add_epi16(_mm256_mullo_epi16(aL, w0), _mm256_mullo_epi16(bL, w1));
+            aH = _mm256_add_epi16(_mm256_mullo_epi16(aH, w0), _mm256_mullo_epi16(bH, w1));
+            _mm256_storeu_si256((__m256i*)(out + c +  0), aL);
+            _mm256_storeu_si256((__m256i*)(out + c + 16), aH);
+        }
+        scale_blend_rows_Default(out + c, in0 + c, in1 + c, bytes - c, weight);
+    }
+
+    static PA_FORCE_INLINE __m256i weights(uint32_t weight){
+        return _mm256_set1_epi32((int32_t)((weight << 16) | (SCALE_BILINEAR_ONE - weight)));
+    }
+    static PA_FORCE_INLINE void blend_columns(
+        uint32_t* out, const uint16_t* row,
+        const ScaleBilinearTap* taps, size_t width
+    ){
+        //  Two output pixels per iteration. One in each 128-bit lane.
+        //  [B0 G0 R0 A0 B1 G1 R1 A1] -> [B0 B1 G0 G1 R0 R1 A0 A1]
+        const __m256i shuffle = _mm256_setr_epi8(
+            0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+            0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15
+        );
+        const __m256i round = _mm256_set1_epi32(1 << (SCALE_BILINEAR_SHIFT - 1));
+
+        size_t c = 0;
+        for (; c + 2 <= width; c += 2){
+            __m256i x = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(row + 4 * taps[c + 0].index))),
+                _mm_loadu_si128((const __m128i*)(row + 4 * taps[c + 1].index)),
+                1
+            );
+            __m256i w = _mm256_blend_epi32(weights(taps[c + 0].weight), weights(taps[c + 1].weight), 0xf0);
+            x = _mm256_shuffle_epi8(x, shuffle);
+            x = _mm256_madd_epi16(x, w);
+            x = _mm256_add_epi32(x, round);
+            x = _mm256_srli_epi32(x, SCALE_BILINEAR_SHIFT);
+            x = _mm256_packus_epi32(x, x);
+            x = _mm256_packus_epi16(x, x);
+            out[c + 0] = _mm256_cvtsi256_si32(x);
+            out[c + 1] = _mm256_extract_epi32(x, 4);
+        }
+        if (c < width){
+            out[c] = scale_blend_columns_Default(row + 4 * taps[c].index, taps[c].weight);
+        }
+    }
+
+    static PA_FORCE_INLINE void accumulate_row(
+        uint16_t* columns, const uint32_t* row, size_t width
+    ){
+        const uint8_t* in = (const uint8_t*)row;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 32 <= bytes; c += 32){
+            __m256i* s = (__m256i*)(columns + c);
+            __m256i x0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in + c +  0)));
+            __m256i x1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in + c + 16)));
+            _mm256_storeu_si256(s + 0, _mm256_add_epi16(_mm256_loadu_si256(s + 0), x0));
+            _mm256_storeu_si256(s + 1, _mm256_add_epi16(_mm256_loadu_si256(s + 1), x1));
+        }
+        scale_accumulate_row_Default(columns + c, in + c, bytes - c);
+    }
+    static PA_FORCE_INLINE void accumulate_spans(
+        uint32_t* sums, const uint16_t* columns,
+        const ScaleAreaSpan* spans, size_t width
+    ){
+        for (size_t c = 0; c < width; c++){
+            const uint16_t* s = columns + 4 * spans[c].begin;
+            size_t count = spans[c].count;
+
+            //  Four columns at a time, then fold.
+            __m256i acc4 = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4){
+                __m256i x = _mm256_loadu_si256((const __m256i*)(s + 4 * i));
+                acc4 = _mm256_add_epi32(acc4, _mm256_madd_epi16(
+                    _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                        0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+                        0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15
+                    )),
+                    _mm256_set1_epi16(1)
+                ));
+            }
+            __m128i acc = _mm_add_epi32(_mm256_castsi256_si128(acc4), _mm256_extracti128_si256(acc4, 1));
+            for (; i < count; i++){
+                acc = _mm_add_epi32(acc, _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(s + 4 * i))));
+            }
+            acc = _mm_add_epi32(acc, _mm_loadu_si128((const __m128i*)(sums + 4 * c)));
+            _mm_storeu_si128((__m128i*)(sums + 4 * c), acc);
+        }
+    }
+};
+
+
+
+void scale_bilinear_x64_AVX2(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_bilinear<ImageScale_x64_AVX2>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+void scale_area_x64_AVX2(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_area<ImageScale_x64_AVX2>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+
+
+
+}
+}
+#endif
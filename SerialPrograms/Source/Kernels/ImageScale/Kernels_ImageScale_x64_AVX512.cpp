@@ -0,0 +1,160 @@
+/*  Image Scale (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+
+#include <stdint.h>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageScale_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageScale_x64_AVX512{
+    static PA_FORCE_INLINE void blend_rows(
+        uint16_t* out, const uint32_t* row0, const uint32_t* row1,
+        size_t width, uint32_t weight
+    ){
+        const __m512i w0 = _mm512_set1_epi16((int16_t)(SCALE_BILINEAR_ONE - weight));
+        const __m512i w1 = _mm512_set1_epi16((int16_t)weight);
+
+        const uint8_t* in0 = (const uint8_t*)row0;
+        const uint8_t* in1 = (const uint8_t*)row1;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 64 <= bytes; c += 64){
+            __m512i aL = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in0 + c +  0)));
+            __m512i aH = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in0 + c + 32)));
+            __m512i bL = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in1 + c +  0)));
+            __m512i bH = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in1 + c + 32)));
+            aL = _mm512_add_epi16(_mm512_mullo_epi16(aL, w0), _mm512_mullo_epi16(bL, w1));
+            aH = _mm512_add_epi16(_mm512_mullo_epi16(aH, w0), _mm512_mullo_epi16(bH, w1));
+            _mm512_storeu_si512((__m512i*)(out + c +  0), aL);
+            _mm512_storeu_si512((__m512i*)(out + c + 32), aH);
+        }
+        scale_blend_rows_Default(out + c, in0 + c, in1 + c, bytes - c, weight);
+    }
+
+    static PA_FORCE_INLINE __m128i load_pixels(const uint16_t* row, const ScaleBilinearTap& tap){
+        return _mm_loadu_si128((const __m128i*)(row + 4 * tap.index));
+    }
+    static PA_FORCE_INLINE __m128i weights(const ScaleBilinearTap& tap){
+        return _mm_set1_epi32((int32_t)((tap.weight << 16) | (SCALE_BILINEAR_ONE - tap.weight)));
+    }
+    static PA_FORCE_INLINE void blend_columns(
+        uint32_t* out, const uint16_t* row,
+        const ScaleBilinearTap* taps, size_t width
+    ){
+        //  Four output pixels per iteration. One in each 128-bit lane.
+        //  [B0 G0 R0 A0 B1 G1 R1 A1] -> [B0 B1 G0 G1 R0 R1 A0 A1]
+        const __m512i shuffle = _mm512_broadcast_i32x4(
+            _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15)
+        );
+        const __m512i round = _mm512_set1_epi32(1 << (SCALE_BILINEAR_SHIFT - 1));
+
+        size_t c = 0;
+        for (; c + 4 <= width; c += 4){
+            __m512i x = _mm512_castsi128_si512(load_pixels(row, taps[c + 0]));
+            x = _mm512_inserti32x4(x, load_pixels(row, taps[c + 1]), 1);
+            x = _mm512_inserti32x4(x, load_pixels(row, taps[c + 2]), 2);
+            x = _mm512_inserti32x4(x, load_pixels(row, taps[c + 3]), 3);
+            __m512i w = _mm512_castsi128_si512(weights(taps[c + 0]));
+            w = _mm512_inserti32x4(w, weights(taps[c + 1]), 1);
+            w = _mm512_inserti32x4(w, weights(taps[c + 2]), 2);
+            w = _mm512_inserti32x4(w, weights(taps[c + 3]), 3);
+
+            x = _mm512_shuffle_epi8(x, shuffle);
+            x = _mm512_madd_epi16(x, w);
+            x = _mm512_add_epi32(x, round);
+            x = _mm512_srli_epi32(x, SCALE_BILINEAR_SHIFT);
+
+            //  Each 32-bit lane is now one channel. In order, so they narrow
+            //  straight into 4 packed pixels.
+            _mm_storeu_si128((__m128i*)(out + c), _mm512_cvtepi32_epi8(x));
+        }
+        for (; c < width; c++){
+            out[c] = scale_blend_columns_Default(row + 4 * taps[c].index, taps[c].weight);
+        }
+    }
+
+    static PA_FORCE_INLINE void accumulate_row(
+        uint16_t* columns, const uint32_t* row, size_t width
+    ){
+        const uint8_t* in = (const uint8_t*)row;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 64 <= bytes; c += 64){
+            __m512i* s = (__m512i*)(columns + c);
+            __m512i x0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in + c +  0)));
+            __m512i x1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in + c + 32)));
+            _mm512_storeu_si512(s + 0, _mm512_add_epi16(_mm512_loadu_si512(s + 0), x0));
+            _mm512_storeu_si512(s + 1, _mm512_add_epi16(_mm512_loadu_si512(s + 1), x1));
+        }
+        scale_accumulate_row_Default(columns + c, in + c, bytes - c);
+    }
+    static PA_FORCE_INLINE void accumulate_spans(
+        uint32_t* sums, const uint16_t* columns,
+        const ScaleAreaSpan* spans, size_t width
+    ){
+        //  [B0 G0 R0 A0 B1 G1 R1 A1] -> [B0 B1 G0 G1 R0 R1 A0 A1]
+        const __m512i shuffle = _mm512_broadcast_i32x4(
+            _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15)
+        );
+        const __m512i ones = _mm512_set1_epi16(1);
+
+        for (size_t c = 0; c < width; c++){
+            const uint16_t* s = columns + 4 * spans[c].begin;
+            size_t count = spans[c].count;
+
+            //  Eight columns at a time, then fold.
+            __m512i acc8 = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8){
+                __m512i x = _mm512_loadu_si512(s + 4 * i);
+                acc8 = _mm512_add_epi32(acc8, _mm512_madd_epi16(_mm512_shuffle_epi8(x, shuffle), ones));
+            }
+            if (i < count){
+                __mmask32 mask = (__mmask32)(((uint64_t)1 << (4 * (count - i))) - 1);
+                __m512i x = _mm512_maskz_loadu_epi16(mask, s + 4 * i);
+                acc8 = _mm512_add_epi32(acc8, _mm512_madd_epi16(_mm512_shuffle_epi8(x, shuffle), ones));
+            }
+            __m256i acc4 = _mm256_add_epi32(_mm512_castsi512_si256(acc8), _mm512_extracti64x4_epi64(acc8, 1));
+            __m128i acc = _mm_add_epi32(_mm256_castsi256_si128(acc4), _mm256_extracti128_si256(acc4, 1));
+            acc = _mm_add_epi32(acc, _mm_loadu_si128((const __m128i*)(sums + 4 * c)));
+            _mm_storeu_si128((__m128i*)(sums + 4 * c), acc);
+        }
+    }
+};
+
+
+
+void scale_bilinear_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_bilinear<ImageScale_x64_AVX512>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+void scale_area_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_area<ImageScale_x64_AVX512>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,132 @@
+/*  Image Scale (x64 SSE4.1)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <stdint.h>
+#include <smmintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels_ImageScale_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct ImageScale_x64_SSE41{
+    static PA_FORCE_INLINE void blend_rows(
+        uint16_t* out, const uint32_t* row0, const uint32_t* row1,
+        size_t width, uint32_t weight
+    ){
+        const __m128i w0 = _mm_set1_epi16((int16_t)(SCALE_BILINEAR_ONE - weight));
+        const __m128i w1 = _mm_set1_epi16((int16_t)weight);
+
+        const uint8_t* in0 = (const uint8_t*)row0;
+        const uint8_t* in1 = (const uint8_t*)row1;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 16 <= bytes; c += 16){
+            __m128i a = _mm_loadu_si128((const __m128i*)(in0 + c));
+            __m128i b = _mm_loadu_si128((const __m128i*)(in1 + c));
+            __m128i aL = _mm_cvtepu8_epi16(a);
+            __m128i bL = _mm_cvtepu8_epi16(b);
+            __m128i aH = _mm_unpackhi_epi8(a, _mm_setzero_si128());
+            __m128i bH = _mm_unpackhi_epi8(b, _mm_setzero_si128());
+            aL = _mm_add_epi16(_mm_mullo_epi16(aL, w0), _mm_mullo_epi16(bL, w1));
+            aH = _mm_add_epi16(_mm_mullo_epi16(aH, w0), _mm_mullo_epi16(bH, w1));
+            _mm_storeu_si128((__m128i*)(out + c + 0), aL);
+            _mm_storeu_si128((__m128i*)(out + c + 8), aH);
+        }
+        scale_blend_rows_Default(out + c, in0 + c, in1 + c, bytes - c, weight);
+    }
+
+    static PA_FORCE_INLINE uint32_t blend_pixel(const uint16_t* pixels, uint32_t weight){
+        //  [B0 G0 R0 A0 B1 G1 R1 A1] -> [B0 B1 G0 G1 R0 R1 A0 A1]
+        __m128i x = _mm_loadu_si128((const __m128i*)pixels);
+        x = _mm_shuffle_epi8(x, _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15));
+        x = _mm_madd_epi16(x, _mm_set1_epi32((int32_t)((weight << 16) | (SCALE_BILINEAR_ONE - weight))));
+        x = _mm_add_epi32(x, _mm_set1_epi32(1 << (SCALE_BILINEAR_SHIFT - 1)));
+        x = _mm_srli_epi32(x, SCALE_BILINEAR_SHIFT);
+        x = _mm_packus_epi32(x, x);
+        x = _mm_packus_epi16(x, x);
+        return _mm_cvtsi128_si32(x);
+    }
+    static PA_FORCE_INLINE void blend_columns(
+        uint32_t* out, const uint16_t* row,
+        const ScaleBilinearTap* taps, size_t width
+    ){
+        for (size_t c = 0; c < width; c++){
+            out[c] = blend_pixel(row + 4 * taps[c].index, taps[c].weight);
+        }
+    }
+
+    static PA_FORCE_INLINE void accumulate_row(
+        uint16_t* columns, const uint32_t* row, size_t width
+    ){
+        const uint8_t* in = (const uint8_t*)row;
+        size_t bytes = 4 * width;
+        size_t c = 0;
+        for (; c + 16 <= bytes; c += 16){
+            __m128i x = _mm_loadu_si128((const __m128i*)(in + c));
+            __m128i* s = (__m128i*)(columns + c);
+            _mm_storeu_si128(s + 0, _mm_add_epi16(_mm_loadu_si128(s + 0), _mm_cvtepu8_epi16(x)));
+            _mm_storeu_si128(s + 1, _mm_add_epi16(_mm_loadu_si128(s + 1), _mm_unpackhi_epi8(x, _mm_setzero_si128())));
+        }
+        scale_accumulate_row_Default(columns + c, in + c, bytes - c);
+    }
+    static PA_FORCE_INLINE void accumulate_spans(
+        uint32_t* sums, const uint16_t* columns,
+        const ScaleAreaSpan* spans, size_t width
+    ){
+        for (size_t c = 0; c < width; c++){
+            const uint16_t* s = columns + 4 * spans[c].begin;
+            size_t count = spans[c].count;
+
+            //  Two columns at a time, then fold.
+            __m128i acc2 = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2){
+                __m128i x = _mm_loadu_si128((const __m128i*)(s + 4 * i));
+                acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(
+                    _mm_shuffle_epi8(x, _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15)),
+                    _mm_set1_epi16(1)
+                ));
+            }
+            if (i < count){
+                acc2 = _mm_add_epi32(acc2, _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(s + 4 * i))));
+            }
+            acc2 = _mm_add_epi32(acc2, _mm_loadu_si128((const __m128i*)(sums + 4 * c)));
+            _mm_storeu_si128((__m128i*)(sums + 4 * c), acc2);
+        }
+    }
+};
+
+
+
+void scale_bilinear_x64_SSE41(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_bilinear<ImageScale_x64_SSE41>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+void scale_area_x64_SSE41(
+    const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+    uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+){
+    resample_area<ImageScale_x64_SSE41>(
+        in, in_bytes_per_row, in_width, in_height,
+        out, out_bytes_per_row, out_width, out_height
+    );
+}
+
+
+
+}
+}
+#endif
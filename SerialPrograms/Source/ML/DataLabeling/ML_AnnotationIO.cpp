@@ -5,6 +5,7 @@
  *  Functions for IO of annotation related files
  */
 
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -19,6 +20,7 @@
 #include "Common/Cpp/Json/JsonValue.h"
 #include "Common/Cpp/StringTools.h"
 #include "Common/Cpp/PrettyPrint.h"
+#include "CommonFramework/Globals.h"
 #include "ML_AnnotationIO.h"
 #include "ML_SegmentAnythingModelConstants.h"
 #include "ML_ObjectAnnotation.h"
@@ -42,6 +44,54 @@ void save_image_embedding_to_disk(const std::string& image_filepath, const std::
     std::cout << "Saved image embedding as " << embedding_path << std::endl;
 }
 
+namespace{
+
+std::string image_embedding_cache_path(const std::string& model_hash, const std::string& image_hash){
+    return ML_MODEL_CACHE_PATH() + "SAMEmbeddingCache/" + model_hash + "/" + image_hash + ".embedding";
+}
+
+// Hard link if possible so the cache doesn't take up extra space. Otherwise copy.
+bool link_or_copy_file(const std::string& from, const std::string& to){
+    std::error_code ec;
+    fs::create_hard_link(from, to, ec);
+    if (!ec){
+        return true;
+    }
+    ec.clear();
+    fs::copy_file(from, to, fs::copy_options::skip_existing, ec);
+    return !ec;
+}
+
+}
+
+bool restore_image_embedding_from_cache(
+    const std::string& image_filepath, const std::string& model_hash, const std::string& image_hash
+){
+    if (model_hash.empty() || image_hash.empty()){
+        return false;
+    }
+    const std::string cache_path = image_embedding_cache_path(model_hash, image_hash);
+    if (!fs::exists(cache_path)){
+        return false;
+    }
+    return link_or_copy_file(cache_path, image_filepath + ".embedding");
+}
+
+void add_image_embedding_to_cache(
+    const std::string& image_filepath, const std::string& model_hash, const std::string& image_hash
+){
+    if (model_hash.empty() || image_hash.empty()){
+        return;
+    }
+    const std::string cache_path = image_embedding_cache_path(model_hash, image_hash);
+    if (fs::exists(cache_path)){
+        return;
+    }
+    std::error_code ec;
+    fs::create_directories(fs::path(cache_path).parent_path(), ec);
+    link_or_copy_file(image_filepath + ".embedding", cache_path);
+}
+
 
 bool load_image_embedding(const std::string& image_filepath, std::vector<float>& image_embedding){
     std::string emebdding_path = image_filepath + ".embedding";
@@ -22,6 +22,20 @@ bool load_image_embedding(const std::string& image_filepath, std::vector<float>&
 // Save the image embedding as a file with path <image_filepath>.embedding.
 void save_image_embedding_to_disk(const std::string& image_filepath, const std::vector<float>& embedding);
 
+// Embeddings are also kept in a cache keyed by the hash of the embedder model file and the hash of
+// the image file content, so renamed or duplicated images don't need their embeddings computed again,
+// and a new model never reuses embeddings from an old one. The cache is skipped if either hash is empty.
+// If the cache has the embedding of an image whose file content hash is `image_hash`, computed by the
+// model whose file hash is `model_hash`, place it at <image_filepath>.embedding and return true.
+bool restore_image_embedding_from_cache(
+    const std::string& image_filepath, const std::string& model_hash, const std::string& image_hash
+);
+// Add <image_filepath>.embedding to the cache under `model_hash` and `image_hash`.
+// Only call this for an embedding that was just computed from that image content with that model.
+void add_image_embedding_to_cache(
+    const std::string& image_filepath, const std::string& model_hash, const std::string& image_hash
+);
+
 // Find image paths stored in a folder. The search can be recursive into child folders or not.
 std::vector<std::string> find_images_in_folder(const std::string& folder_path, bool recursive);
 
@@ -7,13 +7,21 @@
 
 #include <QDir>
 #include <QDirIterator>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <QMessageBox>
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 #include "3rdParty/ONNX/OnnxToolsPA.h"
+#include "Common/Cpp/Concurrency/Thread.h"
 #include "CommonFramework/Globals.h"
 #include "ML/Models/ML_ONNXRuntimeHelpers.h"
 #include "ML_SegmentAnythingModelConstants.h"
@@ -24,9 +32,22 @@ namespace PokemonAutomation{
 namespace ML{
 
 
-SAMEmbedderSession::SAMEmbedderSession(const std::string& model_path, bool use_gpu)
+namespace{
+
+Ort::SessionOptions create_embedder_session_options(bool use_gpu, int intra_op_threads, int inter_op_threads){
+    Ort::SessionOptions so = create_session_options(ML_MODEL_CACHE_PATH() + "SAMEmbedder/", use_gpu);
+    // 0 lets ONNX Runtime decide.
+    so.SetIntraOpNumThreads(intra_op_threads);
+    so.SetInterOpNumThreads(inter_op_threads);
+    return so;
+}
+
+}
+
+
+SAMEmbedderSession::SAMEmbedderSession(const std::string& model_path, bool use_gpu, int intra_op_threads, int inter_op_threads)
     : m_env{create_ORT_env()}
-    , m_session_options{create_session_options(ML_MODEL_CACHE_PATH() + "SAMEmbedder/", use_gpu)}
+    , m_session_options{create_embedder_session_options(use_gpu, intra_op_threads, inter_op_threads)}
     , session{create_session(m_env, m_session_options, model_path, ML_MODEL_CACHE_PATH() + "SAMEmbedder/")}
     , memory_info{Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU)}
     , input_names{session.GetInputNames()}
@@ -46,13 +67,10 @@ void SAMEmbedderSession::run(cv::Mat& input_image, std::vector<float>& model_out
     auto input_tensor = create_tensor<uint8_t>(memory_info, model_input, input_shape);
     auto output_tensor = create_tensor<float>(memory_info, model_output, output_shape);
 
-    for (int row = 0, p_loc=0; row < SAM_EMBEDDER_INPUT_IMAGE_HEIGHT; row++){
-        for(int col = 0; col < SAM_EMBEDDER_INPUT_IMAGE_WIDTH; col++){
-            cv::Vec3b p = input_image.at<cv::Vec3b>(row, col);
-            model_input[p_loc++] = p[0];
-            model_input[p_loc++] = p[1];
-            model_input[p_loc++] = p[2];
-        }
+    // The model takes HWC uint8, same layout as the image. Copy row by row in case the image isn't continuous.
+    const size_t row_bytes = (size_t)SAM_EMBEDDER_INPUT_IMAGE_WIDTH * 3;
+    for (int row = 0; row < SAM_EMBEDDER_INPUT_IMAGE_HEIGHT; row++){
+        memcpy(model_input.data() + row * row_bytes, input_image.ptr<uint8_t>(row), row_bytes);
     }
 
     const char* input_name_c = input_names[0].data();
@@ -178,7 +196,146 @@ void SAMSession::run(
 }
 
 
-void compute_embeddings_for_folder(const std::string& embedding_model_path, const std::string& image_folder_path, bool use_gpu_for_embedder_session){
+namespace{
+
+// An image from the folder, ready for the embedder.
+struct PreparedImage{
+    std::string path;
+    std::string hash;       // Hash of the image file content. Empty if the file couldn't be read or wasn't hashed.
+    cv::Mat image;          // Resized RGB image for the embedder. Empty if no embedding needs to be computed.
+    std::string skip_reason;
+    std::string error_title;
+    std::string error;
+};
+
+PreparedImage prepare_image(const std::string& image_path, const std::string& model_hash){
+    PreparedImage ret;
+    ret.path = image_path;
+
+    // An existing embedding file may be from an older version of the image or from another model.
+    // There is no way to tell, so it is used as is but not added to the cache.
+    const std::string embedding_path = image_path + ".embedding";
+    if (std::filesystem::exists(embedding_path)){
+        ret.skip_reason = "skip already computed embedding " + embedding_path + ".";
+        return ret;
+    }
+
+    ret.hash = create_file_hash(image_path);
+    if (restore_image_embedding_from_cache(image_path, model_hash, ret.hash)){
+        ret.skip_reason = "reuse cached embedding of identical image content for " + image_path + ".";
+        return ret;
+    }
+
+    cv::Mat image_bgr = cv::imread(image_path);
+    if (image_bgr.empty()){
+        ret.error_title = "Unable To Open Image";
+        ret.error = "Cannot open image file " + image_path + ". Probably not an actual image?";
+        return ret;
+    }
+    cv::Mat image;
+    if (image_bgr.channels() == 4){
+        cv::cvtColor(image_bgr, image, cv::COLOR_BGRA2RGB);
+    } else if (image_bgr.channels() == 3){
+        cv::cvtColor(image_bgr, image, cv::COLOR_BGR2RGB);
+    } else{
+        ret.error_title = "Wrong Image Channels";
+        ret.error = "Image has " + std::to_string(image_bgr.channels()) + " channels. Only support 3 or 4 channels.";
+        return ret;
+    }
+
+    // resize to the shape for the ML model input
+    cv::resize(image, ret.image, cv::Size(SAM_EMBEDDER_INPUT_IMAGE_WIDTH, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT));
+    return ret;
+}
+
+
+// Hashes, decodes and resizes the images on worker threads so that the embedder never waits on them.
+// At most `max_queued` prepared images are held in memory at once.
+class ImagePreparer{
+public:
+    ImagePreparer(
+        const std::vector<std::string>& image_paths, const std::string& model_hash,
+        size_t threads, size_t max_queued
+    )
+        : m_image_paths(image_paths)
+        , m_model_hash(model_hash)
+        , m_max_queued(max_queued)
+        , m_stopping(false)
+        , m_next(0)
+        , m_popped(0)
+    {
+        for (size_t c = 0; c < threads; c++){
+            m_threads.emplace_back([this]{ thread_loop(); });
+        }
+    }
+    ~ImagePreparer(){
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        for (Thread& thread : m_threads){
+            thread.join();
+        }
+    }
+
+    // Returns false once every image has been handed out.
+    bool pop(PreparedImage& image){
+        std::unique_lock<std::mutex> lg(m_lock);
+        if (m_popped == m_image_paths.size()){
+            return false;
+        }
+        m_cv.wait(lg, [this]{ return !m_queue.empty(); });
+        image = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_popped++;
+        m_cv.notify_all();
+        return true;
+    }
+
+private:
+    void thread_loop(){
+        while (true){
+            size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= m_image_paths.size()){
+                return;
+            }
+
+            PreparedImage image = prepare_image(m_image_paths[index], m_model_hash);
+
+            std::unique_lock<std::mutex> lg(m_lock);
+            m_cv.wait(lg, [this]{ return m_stopping || m_queue.size() < m_max_queued; });
+            if (m_stopping){
+                return;
+            }
+            m_queue.emplace_back(std::move(image));
+            m_cv.notify_all();
+        }
+    }
+
+private:
+    const std::vector<std::string>& m_image_paths;
+    const std::string m_model_hash;
+    const size_t m_max_queued;
+
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    bool m_stopping;
+    std::deque<PreparedImage> m_queue;
+
+    std::atomic<size_t> m_next;
+    size_t m_popped;
+
+    std::vector<Thread> m_threads;
+};
+
+}
+
+
+void compute_embeddings_for_folder(
+    const std::string& embedding_model_path, const std::string& image_folder_path, bool use_gpu_for_embedder_session,
+    int intra_op_threads, int inter_op_threads
+){
     const bool recursive_search = true;
     std::vector<std::string> all_image_paths = find_images_in_folder(image_folder_path, recursive_search);
     if (all_image_paths.size() == 0){
@@ -203,40 +360,37 @@ void compute_embeddings_for_folder(const std::string& embedding_model_path, cons
     }
 
     bool use_gpu = use_gpu_for_embedder_session;
-    std::unique_ptr<SAMEmbedderSession> embedding_session = make_unique<SAMEmbedderSession>(embedding_model_path, use_gpu);
+    std::unique_ptr<SAMEmbedderSession> embedding_session = make_unique<SAMEmbedderSession>(
+        embedding_model_path, use_gpu, intra_op_threads, inter_op_threads
+    );
+
+    // Decoding is much faster than the embedder, so a few threads are enough to keep it busy.
+    const size_t prepare_threads = std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+    // Cached embeddings are only reused for the same model.
+    const std::string model_hash = create_file_hash(embedding_model_path);
+    ImagePreparer preparer(all_image_paths, model_hash, prepare_threads, 2 * prepare_threads);
+
     std::vector<float> output_image_embedding;
-    for (size_t i = 0; i < all_image_paths.size(); i++){
-        const auto& image_path = all_image_paths[i];
+    PreparedImage prepared;
+    for (size_t i = 0; preparer.pop(prepared); i++){
+        const auto& image_path = prepared.path;
         std::cout << (i+1) << "/" << all_image_paths.size() << ": ";
-        const std::string embedding_path = image_path + ".embedding";
-        if (std::filesystem::exists(embedding_path)){
-            std::cout << "skip already computed embedding " << embedding_path << "." << std::endl;
-            continue;
-        }
-        std::cout << "computing embedding for " << image_path << "..." << std::endl;
-        cv::Mat image_bgr = cv::imread(image_path);
-        if (image_bgr.empty()){
-            std::cerr << "Error: image empty. Probably the file is not an image?" << std::endl;
+        if (!prepared.error.empty()){
+            std::cerr << "Error: " << prepared.error << std::endl;
             QMessageBox box;
-            box.warning(nullptr, "Unable To Open Image",
-                QString::fromStdString("Cannot open image file " + image_path + ". Probably not an actual image?"));
+            box.warning(nullptr, QString::fromStdString(prepared.error_title), QString::fromStdString(prepared.error));
             return;
         }
-        cv::Mat image;
-        if (image_bgr.channels() == 4){
-            cv::cvtColor(image_bgr, image, cv::COLOR_BGRA2RGB);
-        } else if (image_bgr.channels() == 3){
-            cv::cvtColor(image_bgr, image, cv::COLOR_BGR2RGB);
-        } else{
-            std::cerr << "Error: wrong image channels. Only work with RGB or RGBA images." << std::endl;
-            QMessageBox box;
-            box.warning(nullptr, "Wrong Image Channels",
-                QString::fromStdString("Image has " + std::to_string(image_bgr.channels()) + " channels. Only support 3 or 4 channels."));
-            return;
+        if (!prepared.skip_reason.empty()){
+            std::cout << prepared.skip_reason << std::endl;
+            continue;
         }
-
-        cv::Mat resized_mat;  // resize to the shape for the ML model input
-        cv::resize(image, resized_mat, cv::Size(SAM_EMBEDDER_INPUT_IMAGE_WIDTH, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT));
+        // An identical image earlier in this run may have just been computed.
+        if (restore_image_embedding_from_cache(image_path, model_hash, prepared.hash)){
+            std::cout << "reuse cached embedding of identical image content for " << image_path << "." << std::endl;
+            continue;
+        }
+        std::cout << "computing embedding for " << image_path << "..." << std::endl;
 
         output_image_embedding.clear();
 
@@ -245,13 +399,15 @@ void compute_embeddings_for_folder(const std::string& embedding_model_path, cons
             try{
                 // If fails with GPU, fall back to CPU.
                 // throw Ort::Exception("Testing.", ORT_FAIL);  // to simulate GPU/CPU failure
-                embedding_session->run(resized_mat, output_image_embedding);
+                embedding_session->run(prepared.image, output_image_embedding);
                 break;
             }catch(Ort::Exception& e){
                 if (use_gpu){
                     std::cerr << "Warning: Embedding session failed using the GPU. Will reattempt with the CPU.\n" << e.what() << std::endl;
                     use_gpu = false;
-                    embedding_session = make_unique<SAMEmbedderSession>(embedding_model_path, use_gpu);
+                    embedding_session = make_unique<SAMEmbedderSession>(
+                        embedding_model_path, use_gpu, intra_op_threads, inter_op_threads
+                    );
                 }else{
                     std::cerr << "Error: Embedding session failed even when using the CPU.\n" << e.what() << std::endl;
                     QMessageBox box;
@@ -277,6 +433,7 @@ void compute_embeddings_for_folder(const std::string& embedding_model_path, cons
             }
         }
         save_image_embedding_to_disk(image_path, output_image_embedding);
+        add_image_embedding_to_cache(image_path, model_hash, prepared.hash);
     }
     std::cout << "Done computing embeddings for images in folder " << image_folder_path << "." << std::endl;
 
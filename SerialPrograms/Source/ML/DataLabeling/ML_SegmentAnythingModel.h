@@ -22,13 +22,19 @@ namespace ML{
 
 
 // Compute embeddings for all images in a folder. Only support .png, .jpg and .jpeg filename extensions so far.
+// Images are hashed, decoded and resized on worker threads while the embedder runs. Images whose content
+// already has an embedding in the embedding cache are not computed again.
+// intra_op_threads, inter_op_threads: ONNX Runtime thread counts for the embedder. 0 lets ONNX Runtime decide.
 // This can be very slow!
-void compute_embeddings_for_folder(const std::string& embedding_model_path, const std::string& image_folder_path, bool use_gpu_for_embedder_session);
+void compute_embeddings_for_folder(
+    const std::string& embedding_model_path, const std::string& image_folder_path, bool use_gpu_for_embedder_session,
+    int intra_op_threads = 0, int inter_op_threads = 0
+);
 
 
 class SAMEmbedderSession{
 public:
-    SAMEmbedderSession(const std::string& model_path, bool use_gpu);
+    SAMEmbedderSession(const std::string& model_path, bool use_gpu, int intra_op_threads = 0, int inter_op_threads = 0);
 
     // Given an image of shape SAM_EMBEDDER_INPUT_IMAGE_WIDTH x SAM_EMBEDDER_INPUT_IMAGE_HEIGHT, RGB channel order,
     // compute its image embedding as a vector<float> of size [SAM_EMBEDDER_OUTPUT_SIZE]
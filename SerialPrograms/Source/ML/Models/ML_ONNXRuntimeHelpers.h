@@ -16,6 +16,9 @@
 namespace PokemonAutomation{
 namespace ML{
 
+// Computes the SHA-256 hash of a file as a hex string. Returns "" if the file cannot be read.
+std::string create_file_hash(const std::string& filepath);
+
 // Create an ONNX SessionOptions
 // If on macOS, will use CoreML as the backend.
 // If on Windows, will try CUDA first (NVIDIA GPUs), then DirectML (all GPU vendors).
@@ -67,6 +67,14 @@ LabelImages::LabelImages(const LabelImages_Descriptor& descriptor)
     , CUSTOM_SET_LABEL(CUSTOM_LABEL_DATABASE, LockMode::UNLOCK_WHILE_RUNNING, 0)
     , MANUAL_LABEL(false, LockMode::UNLOCK_WHILE_RUNNING, "", "Custom Label", true)
     , USE_GPU_FOR_EMBEDDER_SESSION("<b>Enable GPU for Embedder session:</b>", LockMode::LOCK_WHILE_RUNNING, true) 
+    , EMBEDDER_INTRA_OP_THREADS(
+        "<b>Embedder Intra-Op Threads:</b><br>Threads used within each embedder operation. 0 lets ONNX Runtime decide.",
+        LockMode::LOCK_WHILE_RUNNING, 0, 0
+    )
+    , EMBEDDER_INTER_OP_THREADS(
+        "<b>Embedder Inter-Op Threads:</b><br>Threads used to run independent embedder operations. 0 lets ONNX Runtime decide.",
+        LockMode::LOCK_WHILE_RUNNING, 0, 0
+    )
     , SELECTED_ANNO_COLOR(
         "<b>Color of selected annotation:",
         {
@@ -121,6 +129,8 @@ LabelImages::LabelImages(const LabelImages_Descriptor& descriptor)
     ADD_OPTION(CUSTOM_SET_LABEL);
     ADD_OPTION(MANUAL_LABEL);
     ADD_OPTION(USE_GPU_FOR_EMBEDDER_SESSION);
+    ADD_OPTION(EMBEDDER_INTRA_OP_THREADS);
+    ADD_OPTION(EMBEDDER_INTER_OP_THREADS);
     ADD_OPTION(SELECTED_ANNO_COLOR);
     ADD_OPTION(UNSELECTED_ANNO_COLOR);
  
@@ -510,7 +520,10 @@ void LabelImages::remove_segmentation_exclusion_point(double x, double y){
 void LabelImages::compute_embeddings_for_folder(const std::string& image_folder_path){
     std::string embedding_model_path = RESOURCE_PATH() + "ML/sam_embedder_cpu.onnx";
     std::cout << "Use SAM Embedding model " << embedding_model_path << std::endl;
-    ML::compute_embeddings_for_folder(embedding_model_path, image_folder_path, USE_GPU_FOR_EMBEDDER_SESSION);
+    ML::compute_embeddings_for_folder(
+        embedding_model_path, image_folder_path, USE_GPU_FOR_EMBEDDER_SESSION,
+        EMBEDDER_INTRA_OP_THREADS, EMBEDDER_INTER_OP_THREADS
+    );
 }
 
 void LabelImages::delete_selected_annotation(){
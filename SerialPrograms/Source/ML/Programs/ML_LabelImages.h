@@ -14,6 +14,7 @@
 #include "Common/Cpp/Options/EnumDropdownDatabase.h"
 #include "Common/Cpp/Options/StringOption.h"
 #include "Common/Cpp/Options/BooleanCheckBoxOption.h"
+#include "Common/Cpp/Options/SimpleIntegerOption.h"
 #include "Common/Cpp/Color.h"
 #include "CommonFramework/Panels/PanelInstance.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
@@ -179,6 +180,8 @@ private:
     StringCell MANUAL_LABEL;
 
     BooleanCheckBoxOption USE_GPU_FOR_EMBEDDER_SESSION;
+    SimpleIntegerOption<uint8_t> EMBEDDER_INTRA_OP_THREADS;
+    SimpleIntegerOption<uint8_t> EMBEDDER_INTER_OP_THREADS;
 
  
     EnumDropdownOption<ColorChoice> SELECTED_ANNO_COLOR;
@@ -4,6 +4,7 @@
  *
  */
 
+#include <string.h>
 #include "Common/Cpp/Exceptions.h"
 //#include "Common/Cpp/Concurrency/ReverseLockGuard.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
@@ -50,6 +51,10 @@ void ProController_SysbotBase3::cancel_all_commands(){
     uint64_t queued = m_next_seqnum - m_next_expected_seqnum_ack;
     m_next_expected_seqnum_ack = m_next_seqnum;
 
+    //  Anything not sent yet is cancelled along with the rest.
+    m_send_buffer.clear();
+    m_command_times.clear();
+
     m_connection.write_data("cqCancel\r\n");
     if (GlobalSettings::instance().LOG_EVERYTHING){
         m_logger.log("sys-botbase3: cqCancel");
@@ -125,6 +130,7 @@ void ProController_SysbotBase3::on_message(const std::string& message){
     ptr += pos;
     ptr += TOKEN.size();
     uint64_t parsed;
+    WallClock now = current_time();
     while (true){
         char ch = *ptr;
         switch (ch){
@@ -139,7 +145,7 @@ void ProController_SysbotBase3::on_message(const std::string& message){
         break;
     }
 
-    std::lock_guard<std::mutex> lg(m_state_lock);
+    std::unique_lock<std::mutex> lg(m_state_lock);
 
 //    cout << "parsed = " << parsed << endl;
 //    cout << "m_next_seqnum = " << m_next_seqnum << endl;
@@ -174,6 +180,52 @@ void ProController_SysbotBase3::on_message(const std::string& message){
 
     m_next_expected_seqnum_ack = parsed + 1;
     m_cv.notify_all();
+
+    //  Commands finish in order. Anything before this one was either acked
+    //  already or its ack got lost.
+    WallClock queued = WallClock::min();
+    while (!m_command_times.empty() && m_command_times.begin()->first <= parsed){
+        if (m_command_times.begin()->first == parsed){
+            queued = m_command_times.begin()->second;
+        }
+        m_command_times.erase(m_command_times.begin());
+    }
+    lg.unlock();
+
+    if (queued != WallClock::min()){
+        m_connection.report_command_latency(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - queued)
+        );
+    }
+}
+
+void ProController_SysbotBase3::flush_commands(){
+    //  Write while holding the lock so that "cancel_all_commands()" can't
+    //  slip a cqCancel in ahead of a batch that's already been taken.
+    std::lock_guard<std::mutex> lg(m_state_lock);
+    if (m_send_buffer.empty()){
+        return;
+    }
+    m_connection.write_data(m_send_buffer);
+    m_send_buffer.clear();
+}
+void ProController_SysbotBase3::execute_schedule(
+    Cancellable* cancellable,
+    const SuperscalarScheduler::Schedule& schedule
+){
+    //  Everything in one schedule was issued together. Coalesce them into a
+    //  single write instead of one per command.
+    try{
+        for (const SuperscalarScheduler::ScheduleEntry& entry : schedule){
+            execute_state(cancellable, entry);
+        }
+    }catch (...){
+        //  Commands that were already assigned a seqnum still need to go out
+        //  or "wait_for_all()" will wait forever for their acks.
+        flush_commands();
+        throw;
+    }
+    flush_commands();
 }
 
 void ProController_SysbotBase3::execute_state(
@@ -248,15 +300,21 @@ void ProController_SysbotBase3::execute_state(
         right_y = JoystickTools::linear_float_to_s16(fy);
     }
 
-    std::string message;
+    std::unique_lock<std::mutex> lg(m_state_lock);
     if (m_pending_replace){
         m_pending_replace = false;
         m_next_expected_seqnum_ack = m_next_seqnum;
-        message += "cqReplaceOnNext\r\n";
+        m_command_times.clear();
+        m_send_buffer += "cqReplaceOnNext\r\n";
     }
 
     //  Wait until there is space.
-    std::unique_lock<std::mutex> lg(m_state_lock);
+    if (m_next_seqnum - m_next_expected_seqnum_ack >= QUEUE_SIZE && !m_send_buffer.empty()){
+        //  The queue can't drain until sys-botbase gets what we're holding.
+        lg.unlock();
+        flush_commands();
+        lg.lock();
+    }
     m_cv.wait(lg, [this, cancellable]{
         if (cancellable && cancellable->cancelled()){
             return true;
@@ -277,20 +335,27 @@ void ProController_SysbotBase3::execute_state(
     command.state.right_joystick_x = right_x;
     command.state.right_joystick_y = right_y;
 
+    //  Format straight into the send buffer.
     {
-        std::string command_message;
-        command_message.resize(64);
-        command.write_to_hex(command_message.data());
-        message += "cqControllerState " + command_message + "\r\n";
+        const char PREFIX[] = "cqControllerState ";
+        size_t start = m_send_buffer.size();
+        m_send_buffer.resize(start + sizeof(PREFIX) - 1 + 64 + 2);
+        char* ptr = m_send_buffer.data() + start;
+        memcpy(ptr, PREFIX, sizeof(PREFIX) - 1);
+        ptr += sizeof(PREFIX) - 1;
+        command.write_to_hex(ptr);
+        ptr += 64;
+        ptr[0] = '\r';
+        ptr[1] = '\n';
     }
 
-    m_connection.write_data(message);
+    m_command_times[command.seqnum] = current_time();
 
     //  Do not log the contents of the command due to privacy concerns.
     //  (people entering passwords)
 #if 0
     if (GlobalSettings::instance().LOG_EVERYTHING){
-        m_logger.log("sys-botbase3: " + message);
+        m_logger.log("sys-botbase3: " + m_send_buffer);
     }
 #endif
 }
@@ -8,6 +8,7 @@
 #ifndef PokemonAutomation_NintendoSwitch_ProController_SysbotBase3_H
 #define PokemonAutomation_NintendoSwitch_ProController_SysbotBase3_H
 
+#include <map>
 #include "NintendoSwitch/NintendoSwitch_Settings.h"
 //#include "NintendoSwitch/Controllers/NintendoSwitch_VirtualControllerState.h"
 #include "NintendoSwitch/Controllers/Procon/NintendoSwitch_ProController.h"
@@ -220,6 +221,13 @@ private:
         Cancellable* cancellable,
         const SuperscalarScheduler::ScheduleEntry& entry
     ) override;
+    virtual void execute_schedule(
+        Cancellable* cancellable,
+        const SuperscalarScheduler::Schedule& schedule
+    ) override;
+
+    //  Send everything in "m_send_buffer" as a single write.
+    void flush_commands();
 
 
 private:
@@ -230,6 +238,13 @@ private:
     uint64_t m_next_seqnum;
     uint64_t m_next_expected_seqnum_ack;
 
+    //  Commands from the same schedule accumulate here and go out together.
+    //  Reused to avoid allocating per command. Protected by "m_state_lock".
+    std::string m_send_buffer;
+
+    //  When each in-flight command was queued. (by seqnum)
+    std::map<uint64_t, WallClock> m_command_times;
+
     std::condition_variable m_cv;
 };
 
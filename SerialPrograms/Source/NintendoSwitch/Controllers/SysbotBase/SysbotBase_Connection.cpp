@@ -53,6 +53,7 @@ TcpSysbotBase_Connection::TcpSysbotBase_Connection(
     , m_supports_command_queue(false)
     , m_last_ping_send(WallClock::min())
     , m_last_ping_receive(WallClock::min())
+    , m_last_latency_report(current_time())
 {
     m_controller_list.emplace_back(ControllerType::NintendoSwitch_WiredProController);
     m_current_controller = ControllerType::NintendoSwitch_WiredProController;
@@ -102,6 +103,10 @@ void TcpSysbotBase_Connection::write_data(const std::string& data){
 //    cout << "Sending: " << data << endl;
     m_socket.send(data.data(), data.size());
 }
+void TcpSysbotBase_Connection::report_command_latency(std::chrono::microseconds latency){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_command_latency.add(latency);
+}
 
 
 std::string pretty_print(uint64_t x){
@@ -130,6 +135,16 @@ void TcpSysbotBase_Connection::thread_loop(){
             set_status_line1(str, COLOR_RED);
         }
 
+        if (now - m_last_latency_report >= std::chrono::seconds(60)){
+            m_last_latency_report = now;
+            if (m_ping_latency.count() > 0 || m_command_latency.count() > 0){
+                m_logger.log("sys-botbase Ping Latency: " + m_ping_latency.to_str());
+                m_logger.log("sys-botbase Command Latency (queue to ack): " + m_command_latency.to_str());
+                m_ping_latency.clear();
+                m_command_latency.clear();
+            }
+        }
+
         m_last_ping_send = current_time();
         if (supports_command_queue() && NintendoSwitch::ConsoleSettings::instance().ENABLE_SBB3_PINGS){
             //  If we're more than 60 pings behind, just start clearing them.
@@ -193,6 +208,16 @@ void TcpSysbotBase_Connection::on_receive_data(const void* data, size_t bytes){
 
     }catch (...){}
 }
+void TcpSysbotBase_Connection::on_disconnect(const std::string& error_message){
+    try{
+        m_logger.log("sys-botbase: Disconnected. " + error_message, COLOR_RED);
+        set_status_line0("sys-botbase: Disconnected.", COLOR_RED);
+
+        //  Wake the ping thread so it sees the socket is no longer running.
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_cv.notify_all();
+    }catch (...){}
+}
 void TcpSysbotBase_Connection::process_message(const std::string& message, WallClock timestamp){
     if (GlobalSettings::instance().LOG_EVERYTHING){
         m_logger.log("Received: " + message, COLOR_DARKGREEN);
@@ -259,6 +284,7 @@ void TcpSysbotBase_Connection::process_message(const std::string& message, WallC
             set_status_line1(text, COLOR_ORANGE);
         }
 
+        m_ping_latency.add(latency);
         m_active_pings.erase(iter);
     }
 
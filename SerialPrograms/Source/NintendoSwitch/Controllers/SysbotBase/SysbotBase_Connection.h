@@ -17,6 +17,7 @@
 #include "Common/Cpp/Concurrency/Thread.h"
 #include "Common/Cpp/Sockets/ClientSocket.h"
 #include "Controllers/ControllerConnection.h"
+#include "SysbotBase_LatencyHistogram.h"
 
 namespace PokemonAutomation{
 namespace SysbotBase{
@@ -48,11 +49,16 @@ public:
 
     void write_data(const std::string& data);
 
+    //  Time from a command being queued to its ack from sys-botbase.
+    //  Summarized in the log alongside the ping round trips.
+    void report_command_latency(std::chrono::microseconds latency);
+
 private:
     void thread_loop();
 
     virtual void on_connect_finished(const std::string& error_message) override;
     virtual void on_receive_data(const void* data, size_t bytes) override;
+    virtual void on_disconnect(const std::string& error_message) override;
 
     void process_message(const std::string& message, WallClock timestamp);
     void set_mode(const std::string& sbb_version);
@@ -71,6 +77,10 @@ private:
     uint64_t m_ping_seqnum = 0;
     std::map<uint64_t, WallClock> m_active_pings;
 
+    WallClock m_last_latency_report;
+    LatencyHistogram m_ping_latency;
+    LatencyHistogram m_command_latency;
+
     std::deque<char> m_receive_buffer;
 
     SpinLock m_send_lock;
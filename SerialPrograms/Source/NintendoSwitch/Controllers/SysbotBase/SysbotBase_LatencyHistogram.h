@@ -0,0 +1,103 @@
+/*  sys-botbase Latency Histogram
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Power-of-two histogram of round-trip times. Cheap enough to update on
+ *  every ack. Percentiles are reported as the upper bound of their bucket.
+ *
+ */
+
+#ifndef PokemonAutomation_Controllers_SysbotBase_LatencyHistogram_H
+#define PokemonAutomation_Controllers_SysbotBase_LatencyHistogram_H
+
+#include <stdint.h>
+#include <bit>
+#include <algorithm>
+#include <string>
+#include <chrono>
+
+namespace PokemonAutomation{
+namespace SysbotBase{
+
+
+
+class LatencyHistogram{
+public:
+    //  Bucket 0 is < 1us. Bucket i is [2^(i-1), 2^i) us. The last bucket
+    //  takes everything beyond.
+    static constexpr size_t BUCKETS = 32;
+
+public:
+    void clear(){
+        *this = LatencyHistogram();
+    }
+
+    void add(std::chrono::microseconds latency){
+        uint64_t us = latency.count() < 0 ? 0 : (uint64_t)latency.count();
+        size_t index = std::bit_width(us);
+        if (index >= BUCKETS){
+            index = BUCKETS - 1;
+        }
+        m_buckets[index]++;
+        m_count++;
+        m_total_us += us;
+        if (m_max_us < us){
+            m_max_us = us;
+        }
+    }
+
+    uint64_t count() const{
+        return m_count;
+    }
+
+    //  Upper bound (in us) of the bucket containing the "quantile" sample.
+    uint64_t percentile(double quantile) const{
+        if (m_count == 0){
+            return 0;
+        }
+        uint64_t target = (uint64_t)(quantile * (double)m_count);
+        if (target >= m_count){
+            target = m_count - 1;
+        }
+        uint64_t seen = 0;
+        for (size_t c = 0; c < BUCKETS; c++){
+            seen += m_buckets[c];
+            if (seen > target){
+                return std::min<uint64_t>((uint64_t)1 << c, m_max_us);
+            }
+        }
+        return m_max_us;
+    }
+
+    std::string to_str() const{
+        if (m_count == 0){
+            return "no samples";
+        }
+        return "n = " + std::to_string(m_count) +
+            ", mean = " + ms_str(m_total_us / m_count) +
+            ", p50 <= " + ms_str(percentile(0.50)) +
+            ", p90 <= " + ms_str(percentile(0.90)) +
+            ", p99 <= " + ms_str(percentile(0.99)) +
+            ", max = " + ms_str(m_max_us);
+    }
+
+
+private:
+    static std::string ms_str(uint64_t us){
+        std::string frac = std::to_string(us % 1000);
+        return std::to_string(us / 1000) + "." + std::string(3 - frac.size(), '0') + frac + " ms";
+    }
+
+
+private:
+    uint64_t m_buckets[BUCKETS] = {};
+    uint64_t m_count = 0;
+    uint64_t m_total_us = 0;
+    uint64_t m_max_us = 0;
+};
+
+
+
+}
+}
+#endif
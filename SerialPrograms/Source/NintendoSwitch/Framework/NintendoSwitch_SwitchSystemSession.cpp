@@ -25,7 +25,7 @@ bool SwitchSystemSession::try_shutdown(){
     bool success = true;
 
     m_video.remove_state_listener(m_history);
-    m_video.add_frame_listener(m_history);
+    m_video.remove_frame_listener(m_history);
     m_audio.remove_stream_listener(m_history);
     m_audio.remove_state_listener(m_history);
 
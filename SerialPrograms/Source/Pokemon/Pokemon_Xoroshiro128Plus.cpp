@@ -5,6 +5,10 @@
  */
 
 #include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
 #include "Pokemon_Xoroshiro128Plus.h"
 
 namespace PokemonAutomation{
@@ -76,21 +80,174 @@ std::vector<bool> Xoroshiro128Plus::generate_last_bit_sequence(size_t max_advanc
 
     return sequence;
 }
+std::vector<uint64_t> Xoroshiro128Plus::generate_last_bit_words(size_t max_advances){
+    std::vector<uint64_t> words((max_advances + 63) / 64);
+    Xoroshiro128Plus temp_rng(Xoroshiro128PlusState(state.s0, state.s1));
+
+    size_t i = 0;
+    for (uint64_t& word : words){
+        size_t bits = std::min<size_t>(64, max_advances - i);
+        uint64_t x = 0;
+        for (size_t b = 0; b < bits; b++){
+            x |= (temp_rng.next() & 1) << b;
+        }
+        word = x;
+        i += bits;
+    }
+
+    return words;
+}
+
+
+
+namespace{
+
+//  The state update of next() is linear over GF(2). So advancing N times is
+//  multiplying the 128-bit state by the N'th power of a 128x128 bit matrix.
+//  Column c is what basis bit c of the state becomes. (s0 bits first)
+struct Xoroshiro128PlusMatrix{
+    uint64_t columns[128][2];
+
+    Xoroshiro128PlusState operator*(Xoroshiro128PlusState x) const{
+        uint64_t r0 = 0;
+        uint64_t r1 = 0;
+        for (size_t c = 0; c < 64; c++){
+            uint64_t mask = 0 - ((x.s0 >> c) & 1);
+            r0 ^= columns[c][0] & mask;
+            r1 ^= columns[c][1] & mask;
+        }
+        for (size_t c = 0; c < 64; c++){
+            uint64_t mask = 0 - ((x.s1 >> c) & 1);
+            r0 ^= columns[c + 64][0] & mask;
+            r1 ^= columns[c + 64][1] & mask;
+        }
+        return Xoroshiro128PlusState(r0, r1);
+    }
+    Xoroshiro128PlusMatrix operator*(const Xoroshiro128PlusMatrix& x) const{
+        Xoroshiro128PlusMatrix ret;
+        for (size_t c = 0; c < 128; c++){
+            Xoroshiro128PlusState column = *this * Xoroshiro128PlusState(x.columns[c][0], x.columns[c][1]);
+            ret.columns[c][0] = column.s0;
+            ret.columns[c][1] = column.s1;
+        }
+        return ret;
+    }
+};
+
+//  Element k is the transition matrix raised to 2^k.
+const std::vector<Xoroshiro128PlusMatrix>& xoroshiro128plus_jump_matrices(){
+    static const std::vector<Xoroshiro128PlusMatrix> matrices = []{
+        std::vector<Xoroshiro128PlusMatrix> ret(64);
+        for (size_t c = 0; c < 128; c++){
+            Xoroshiro128Plus rng(
+                c <  64 ? (uint64_t)1 << c : 0,
+                c >= 64 ? (uint64_t)1 << (c - 64) : 0
+            );
+            rng.next();
+            ret[0].columns[c][0] = rng.state.s0;
+            ret[0].columns[c][1] = rng.state.s1;
+        }
+        for (size_t k = 1; k < 64; k++){
+            ret[k] = ret[k - 1] * ret[k - 1];
+        }
+        return ret;
+    }();
+    return matrices;
+}
+
+Xoroshiro128PlusMatrix xoroshiro128plus_jump_matrix(uint64_t advances){
+    const std::vector<Xoroshiro128PlusMatrix>& matrices = xoroshiro128plus_jump_matrices();
+    Xoroshiro128PlusMatrix ret{};
+    bool empty = true;
+    for (size_t k = 0; k < 64; k++){
+        if ((advances >> k) & 1){
+            ret = empty ? matrices[k] : matrices[k] * ret;
+            empty = false;
+        }
+    }
+    if (empty){
+        for (size_t c = 0; c < 64; c++){
+            ret.columns[c][0] = (uint64_t)1 << c;
+            ret.columns[c + 64][1] = (uint64_t)1 << c;
+        }
+    }
+    return ret;
+}
+
+}
+
+void Xoroshiro128Plus::jump(uint64_t advances){
+    //  A matrix multiply costs about as much as 100 calls to next().
+    if (advances < 256){
+        for (uint64_t c = 0; c < advances; c++){
+            next();
+        }
+        return;
+    }
+    const std::vector<Xoroshiro128PlusMatrix>& matrices = xoroshiro128plus_jump_matrices();
+    for (size_t k = 0; k < 64; k++){
+        if ((advances >> k) & 1){
+            state = matrices[k] * state;
+        }
+    }
+}
 
 
 std::pair<bool, uint64_t> Xoroshiro128Plus::advances_to_state(Xoroshiro128PlusState other_state, uint64_t max_advances) {
-    Xoroshiro128Plus temp_rng(get_state());
-    uint64_t advances = 0;
+    if (max_advances < 4096){
+        Xoroshiro128Plus temp_rng(get_state());
+        uint64_t advances = 0;
 
-    while (advances <= max_advances) {
-        Xoroshiro128PlusState temp_state = temp_rng.get_state();
-        if (temp_state.s0 == other_state.s0 && temp_state.s1 == other_state.s1) {
-            return { true, advances };
+        while (advances <= max_advances) {
+            Xoroshiro128PlusState temp_state = temp_rng.get_state();
+            if (temp_state.s0 == other_state.s0 && temp_state.s1 == other_state.s1) {
+                return { true, advances };
+            }
+            temp_rng.next();
+            advances++;
+        }
+        return { false, advances };
+    }
+
+    if (state.s0 == other_state.s0 && state.s1 == other_state.s1){
+        return { true, 0 };
+    }
+
+    //  Baby-step giant-step. Find the smallest n = i*m - j with 0 <= j < m
+    //  such that the state after i*m advances equals the target after j.
+    //  A giant step is a matrix multiply, so the steps are sized to balance
+    //  that against the cheaper baby steps.
+    uint64_t m = (uint64_t)std::sqrt((double)max_advances * 128);
+    m = std::min(m, max_advances);
+
+    struct StateHash{
+        size_t operator()(const std::pair<uint64_t, uint64_t>& x) const{
+            return (size_t)(x.first ^ (x.second * 0x9e3779b97f4a7c15));
         }
+    };
+    std::unordered_map<std::pair<uint64_t, uint64_t>, uint64_t, StateHash> baby_steps;
+    baby_steps.reserve((size_t)m);
+    Xoroshiro128Plus temp_rng(other_state);
+    for (uint64_t j = 0; j < m; j++){
+        baby_steps.emplace(std::pair<uint64_t, uint64_t>(temp_rng.state.s0, temp_rng.state.s1), j);
         temp_rng.next();
-        advances++;
     }
-    return { false, advances };
+
+    Xoroshiro128PlusMatrix giant_step = xoroshiro128plus_jump_matrix(m);
+    Xoroshiro128PlusState current = state;
+    for (uint64_t i = 1; (i - 1) * m < max_advances; i++){
+        current = giant_step * current;
+        auto iter = baby_steps.find(std::pair<uint64_t, uint64_t>(current.s0, current.s1));
+        if (iter == baby_steps.end()){
+            continue;
+        }
+        uint64_t advances = i * m - iter->second;
+        if (advances <= max_advances){
+            return { true, advances };
+        }
+        break;
+    }
+    return { false, max_advances + 1 };
 }
 
 // The generic solution to the system of equations to calculate the initial state from the last bits of 128 consecutive Xoroshiro128+ results.
@@ -266,5 +423,66 @@ Xoroshiro128Plus Xoroshiro128Plus::xoroshiro128plus_from_last_bits(std::pair<uin
 }
 
 
+
+Xoroshiro128PlusLastBitLocator::Xoroshiro128PlusLastBitLocator(std::vector<uint64_t> stream, size_t length)
+    : m_stream(std::move(stream))
+    , m_length(length)
+    , m_pushed(0)
+    , m_candidates((length + 63) / 64, (uint64_t)-1)
+    , m_matches(length)
+{
+    if (length % 64 != 0){
+        m_candidates.back() = ((uint64_t)1 << (length % 64)) - 1;
+    }
+}
+void Xoroshiro128PlusLastBitLocator::push(bool bit){
+    size_t offset = m_pushed / 64;
+    size_t shift = m_pushed % 64;
+    m_pushed++;
+
+    //  Pad so the shifted reads below never go out of bounds.
+    size_t words = m_candidates.size();
+    if (m_stream.size() < words + offset + 1){
+        m_stream.resize(words + offset + 1, 0);
+    }
+
+    //  Position p survives if stream bit (p + pushed - 1) equals "bit".
+    const uint64_t* stream = m_stream.data() + offset;
+    uint64_t flip = bit ? 0 : (uint64_t)-1;
+    if (shift == 0){
+        for (size_t c = 0; c < words; c++){
+            m_candidates[c] &= stream[c] ^ flip;
+        }
+    }else{
+        for (size_t c = 0; c < words; c++){
+            uint64_t x = (stream[c] >> shift) | (stream[c + 1] << (64 - shift));
+            m_candidates[c] &= x ^ flip;
+        }
+    }
+
+    //  The sequence must also fit inside the stream.
+    size_t limit = m_length >= m_pushed ? m_length - m_pushed + 1 : 0;
+    for (size_t c = limit / 64; c < words; c++){
+        size_t bits = limit - std::min(limit, c * 64);
+        m_candidates[c] &= bits >= 64 ? (uint64_t)-1 : ((uint64_t)1 << bits) - 1;
+    }
+
+    size_t matches = 0;
+    for (uint64_t x : m_candidates){
+        matches += std::popcount(x);
+    }
+    m_matches = matches;
+}
+size_t Xoroshiro128PlusLastBitLocator::last_match() const{
+    for (size_t c = m_candidates.size(); c > 0; c--){
+        uint64_t x = m_candidates[c - 1];
+        if (x != 0){
+            return (c - 1) * 64 + 63 - std::countl_zero(x);
+        }
+    }
+    return SIZE_MAX;
+}
+
+
 }
 }
@@ -8,6 +8,7 @@
 #define PokemonAutomation_PokemonSwSh_Xoroshiro128Plus_H
 
 #include <stdint.h>
+#include <cstddef>
 #include <utility>
 #include <vector>
 
@@ -31,11 +32,21 @@ public:
     Xoroshiro128PlusState get_state();
     std::vector<bool> generate_last_bit_sequence(size_t max_advances);
 
+    // Same as generate_last_bit_sequence(), but packed 64 bits to a word.
+    // Advance i is bit (i % 64) of word (i / 64).
+    std::vector<uint64_t> generate_last_bit_words(size_t max_advances);
+
+    // Advance the state as if next() was called "advances" times.
+    // Uses precomputed powers of the transition matrix so this is O(log(advances)).
+    void jump(uint64_t advances);
+
     // Calculates how many advances are required to reach the given state.
     // The given state must be reachable within max_advances advances.
     // Returns a pair:
     // first: true if the state is reachable within max_advances, false otherwise
     // second: the number of advances required (if first is true)
+    // Large ranges are searched with baby-step giant-step so this is roughly
+    // O(sqrt(max_advances)) rather than O(max_advances).
     std::pair<bool, uint64_t> advances_to_state(Xoroshiro128PlusState other_state, uint64_t max_advances = 100000);
 
     static Xoroshiro128Plus xoroshiro128plus_from_last_bits(std::pair<uint64_t, uint64_t> last_bits);
@@ -47,6 +58,38 @@ private:
     uint64_t rotl(const uint64_t x, int k);
 };
 
+
+
+// Finds where an observed sequence of last bits occurs in a stream from
+// generate_last_bit_words(). Bits are pushed one at a time as they are
+// observed.
+//
+// Every possible starting position is tracked at once as a bitmask over the
+// stream. Each push updates 64 positions per word operation.
+class Xoroshiro128PlusLastBitLocator{
+public:
+    Xoroshiro128PlusLastBitLocator(std::vector<uint64_t> stream, size_t length);
+
+    void push(bool bit);
+
+    // Number of bits pushed so far.
+    size_t sequence_length() const{ return m_pushed; }
+
+    // Number of positions where the pushed sequence occurs.
+    size_t matches() const{ return m_matches; }
+
+    // The last position where the pushed sequence occurs.
+    // Returns SIZE_MAX if there are none.
+    size_t last_match() const;
+
+private:
+    std::vector<uint64_t> m_stream;
+    size_t m_length;
+    size_t m_pushed;
+    std::vector<uint64_t> m_candidates;
+    size_t m_matches;
+};
+
 }
 }
 #endif
@@ -27,6 +27,7 @@
 #include "CommonFramework/Tools/DebugDumper.h"
 #include "CommonTools/Resources/SpriteDatabase.h"
 #include "CommonTools/Images/ImageFilter.h"
+#include "Kernels/ImageHSV/Kernels_ImageHSV.h"
 #include "PokemonLA_PokemonMapSpriteReader.h"
 #include "PokemonLA/Resources/PokemonLA_AvailablePokemon.h"
 
@@ -730,57 +731,35 @@ double compute_MMO_sprite_gradient_distance(const ImageViewRGB32& gradient_templ
     return score;
 }
 
-double compute_hsv_dist2(uint32_t template_color, uint32_t color){
-    int t_h = (uint32_t(0xff) & (template_color >> 16));
-    int t_s = (uint32_t(0xff) & (template_color >> 8));
-    int t_v = (uint32_t(0xff) & template_color);
-
-    int h = (uint32_t(0xff) & (color >> 16));
-    int s = (uint32_t(0xff) & (color >> 8));
-    int v = (uint32_t(0xff) & color);
-
-    int h_dif = std::abs(t_h - h);
-    if (h_dif > 255 - h_dif){
-        h_dif = 256 - h_dif;
-    }
-
-    return h_dif * h_dif + (t_s - s) * (t_s - s) + 0.5 * (t_v - v) * (t_v - v);
+//  RMS of "dH^2 + dS^2 + 0.5*dV^2" over the pixels that are opaque in both.
+//  NaN if there are none.
+double hsv_distance_score(const Kernels::HsvDistanceSum& distance){
+    return std::sqrt(0.5 * (double)distance.sum / (double)distance.count);
 }
 
-double compute_MMO_sprite_hsv_distance(const ImageViewHSV32& image_template, const ImageViewHSV32& query_image){
-    size_t tempt_width = image_template.width();
-    size_t tempt_height = image_template.height();
-
-    // cout << tempt_width << " " << tempt_height << " " << query_image.width() << " " << query_image.height() << endl;
-    double score = 0.0;
-    int num_pixels = 0;
-    for (size_t y = 0; y < query_image.height(); y++){
-        for (size_t x = 0; x < query_image.width(); x++){
-            uint32_t p = query_image.pixel(x, y);
-            if (is_transparent(p)){
-                // cout << "Skip query pixel " << x << " " << y << endl;
-                continue;
-            }
-            if (x >= tempt_width || y >= tempt_height){
-                continue;
-            }
-
-            uint32_t t_p = image_template.pixel(x, y);
-            if (is_transparent(t_p)){
-                // cout << "Skip template pixel " << x << " " << y << endl;
-                continue;
-            }
-
-            num_pixels++;
-
-            double pixel_score = compute_hsv_dist2(t_p, p);
-            score += pixel_score;
+//  Slide the query window over every (ox, oy) in [0, 4] x [0, 4] of
+//  "sprite_hsv" and return the best score against "image_template".
+double compute_MMO_sprite_hsv_distance(
+    const ImageViewHSV32& image_template,
+    const ImageViewHSV32& sprite_hsv,
+    size_t window_width, size_t window_height
+){
+    const size_t offsets = IMAGE_COLOR_MATCH_EXTRA_SIDE_EXT * 2 + 1;
+    Kernels::HsvDistanceSum distances[offsets * offsets];
+    Kernels::hsv32_distance_offsets(
+        image_template.data(), image_template.bytes_per_row(), image_template.width(), image_template.height(),
+        sprite_hsv.data(), sprite_hsv.bytes_per_row(), sprite_hsv.width(), sprite_hsv.height(),
+        window_width, window_height,
+        distances, offsets, offsets
+    );
+
+    double score = FLT_MAX;
+    for (size_t ox = 0; ox < offsets; ox++){
+        for (size_t oy = 0; oy < offsets; oy++){
+            double match_score = hsv_distance_score(distances[oy * offsets + ox]);
+            score = std::min(match_score, score);
         }
     }
-
-    score = std::sqrt(score / num_pixels);
-    // cout << "score " << score << " " << num_pixels << endl;
-    // exit(0);
     return score;
 }
 
@@ -842,17 +821,10 @@ MapSpriteMatchResult match_sprite_on_map(Logger& logger, const ImageViewRGB32& s
         
         for(const auto& slug: result.candidates){
             const ImageHSV32& candidate_template = sprite_map.find(slug)->second.hsv_image;
-            double score = FLT_MAX;
-            for(size_t ox = 0; ox <= 4; ox++){
-                for(size_t oy = 0; oy <= 4; oy++){
-                    ImagePixelBox shifted_box(ox, oy, box.width(), box.height());
-                    double match_score = compute_MMO_sprite_hsv_distance(
-                        candidate_template,
-                        extract_box_reference(sprite_hsv, shifted_box)
-                    );
-                    score = std::min(match_score, score);
-                }
-            }
+            double score = compute_MMO_sprite_hsv_distance(
+                candidate_template, sprite_hsv,
+                box.width(), box.height()
+            );
 
             result.color_match_results.emplace(score, slug);
         }
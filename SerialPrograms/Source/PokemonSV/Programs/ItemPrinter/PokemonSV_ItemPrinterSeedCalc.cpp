@@ -11,11 +11,13 @@
 
 #include <vector>
 #include <map>
+#include <bit>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Json/JsonValue.h"
 #include "Common/Cpp/Json/JsonArray.h"
 #include "Common/Cpp/Json/JsonObject.h"
 #include "CommonFramework/Globals.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "Pokemon/Pokemon_Xoroshiro128Plus.h"
 #include "PokemonSV_ItemPrinterSeedCalc.h"
 
@@ -236,6 +238,7 @@ const char* item_id_to_slug(int item_id){
 }
 
 struct ItemPrinterItemData{
+    uint16_t item_id;
     const char* slug;
     uint16_t weight;
     uint8_t min_quantity;
@@ -265,6 +268,7 @@ std::vector<ItemPrinterItemData> make_item_prize_list(){
             throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Unknown Item ID: " + std::to_string(item_id));
         }
         ret.emplace_back(ItemPrinterItemData{
+            (uint16_t)item_id,
             slug,
             (uint16_t)entry.get_integer_throw("EmergePercent", path),
             (uint8_t)entry.get_integer_throw("LotteryItemNumMin", path),
@@ -298,6 +302,7 @@ std::vector<ItemPrinterItemData> make_ball_prize_list(){
             throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Unknown Item ID: " + std::to_string(item_id));
         }
         ret.emplace_back(ItemPrinterItemData{
+            (uint16_t)item_id,
             slug,
             (uint16_t)entry.get_integer_throw("EmergePercent", path),
             (uint8_t)entry.get_integer_throw("LotteryItemNumMin", path),
@@ -349,25 +354,23 @@ std::vector<const ItemPrinterItemData*> make_ball_prize_table(){
 }
 
 
-enum class PrintMode{
-    Regular = 0,
-    ItemBonus = 1,
-    BallBonus = 2,
-};
-
+const uint64_t ITEM_PRINTER_SEED_S1 = 0x82A2B175229D6A5B;
 
-std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
+const std::vector<const ItemPrinterItemData*>& prize_table(PrintMode mode){
     static const std::vector<const ItemPrinterItemData*> ITEM_TABLE = make_item_prize_table();
     static const std::vector<const ItemPrinterItemData*> BALL_TABLE = make_ball_prize_table();
-
-    const std::vector<const ItemPrinterItemData*>& table = mode == PrintMode::BallBonus
+    return mode == PrintMode::BallBonus
         ? BALL_TABLE
         : ITEM_TABLE;
+}
 
-    Pokemon::Xoroshiro128Plus rand(seed, 0x82A2B175229D6A5B);
-
+//  "Random" is anything with Xoroshiro128Plus's next() and nextInt().
+template <typename Random>
+PA_FORCE_INLINE void roll_prizes(
+    PrizeRolls& rolls, Random& rand,
+    const std::vector<const ItemPrinterItemData*>& table, PrintMode mode
+){
     PrintMode return_mode = PrintMode::Regular;
-    std::array<std::string, 10> ret;
     for (size_t c = 0; c < 10; c++){
         //  Always check for next bonus mode, even if not possible.
         uint64_t roll = rand.nextInt(1000);
@@ -376,11 +379,12 @@ std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
         //  Determine the item to print.
         uint64_t item_roll = rand.nextInt(table.size());
         const ItemPrinterItemData& item = *table[item_roll];
-        ret[c] = item.slug;
+        rolls[c].item_id = item.item_id;
 
         //  Determine quantity.
+        rolls[c].quantity = item.min_quantity;
         if (item.min_quantity != item.max_quantity){
-            rand.nextInt(item.max_quantity - item.min_quantity + 1);
+            rolls[c].quantity += (uint8_t)rand.nextInt(item.max_quantity - item.min_quantity + 1);
         }
 
         //  If we're lucky enough to get a bonus mode, pick one.
@@ -391,9 +395,169 @@ std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
         }
 
     }
+}
+
 
+PrizeRolls calculate_prize_rolls(int64_t seed, PrintMode mode){
+    Pokemon::Xoroshiro128Plus rand(seed, ITEM_PRINTER_SEED_S1);
+    PrizeRolls ret;
+    roll_prizes(ret, rand, prize_table(mode), mode);
     return ret;
 }
+uint32_t count_item(const PrizeRolls& rolls, uint16_t item_id){
+    uint32_t ret = 0;
+    for (const PrizeRoll& roll : rolls){
+        if (roll.item_id == item_id){
+            ret += roll.quantity;
+        }
+    }
+    return ret;
+}
+
+std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
+    PrizeRolls rolls = calculate_prize_rolls(seed, mode);
+    std::array<std::string, 10> ret;
+    for (size_t c = 0; c < 10; c++){
+        ret[c] = item_id_to_slug(rolls[c].item_id);
+    }
+    return ret;
+}
+
+
+
+//  The first STREAM_LENGTH outputs of SEED_LANES consecutive seeds. All the
+//  lanes are stepped together so the compiler can vectorize across them.
+//  A print job rarely needs more than this. If one does, it continues from
+//  the saved state of its lane.
+const size_t SEED_LANES = 8;
+const size_t STREAM_LENGTH = 64;
+
+struct SeedStreams{
+    uint64_t values[STREAM_LENGTH][SEED_LANES];
+    uint64_t s0[SEED_LANES];
+    uint64_t s1[SEED_LANES];
+
+    void generate(int64_t first_seed){
+        for (size_t l = 0; l < SEED_LANES; l++){
+            s0[l] = (uint64_t)(first_seed + (int64_t)l);
+            s1[l] = ITEM_PRINTER_SEED_S1;
+        }
+        for (size_t c = 0; c < STREAM_LENGTH; c++){
+            for (size_t l = 0; l < SEED_LANES; l++){
+                uint64_t x0 = s0[l];
+                uint64_t x1 = s1[l];
+                values[c][l] = x0 + x1;
+                x1 ^= x0;
+                s0[l] = std::rotl(x0, 24) ^ x1 ^ (x1 << 16);
+                s1[l] = std::rotl(x1, 37);
+            }
+        }
+    }
+};
+
+//  One lane of SeedStreams with the same interface as Xoroshiro128Plus.
+class SeedStreamLane{
+public:
+    SeedStreamLane(const SeedStreams& streams, size_t lane)
+        : m_streams(streams)
+        , m_lane(lane)
+        , m_index(0)
+        , m_tail(streams.s0[lane], streams.s1[lane])
+    {}
+
+    PA_FORCE_INLINE uint64_t next(){
+        if (m_index < STREAM_LENGTH){
+            return m_streams.values[m_index++][m_lane];
+        }
+        return m_tail.next();
+    }
+    PA_FORCE_INLINE uint64_t nextInt(uint64_t bound){
+        uint64_t mask = std::bit_ceil(bound) - 1;
+        uint64_t result = next() & mask;
+        while (result >= bound){
+            result = next() & mask;
+        }
+        return result;
+    }
+
+private:
+    const SeedStreams& m_streams;
+    size_t m_lane;
+    size_t m_index;
+    Pokemon::Xoroshiro128Plus m_tail;
+};
+
+
+std::vector<int64_t> search_seeds(
+    int64_t start, int64_t end,
+    PrintMode mode,
+    const std::function<bool(const PrizeRolls& rolls)>& predicate,
+    size_t max_results
+){
+    if (end <= start || max_results == 0){
+        return {};
+    }
+
+    const std::vector<const ItemPrinterItemData*>& table = prize_table(mode);
+
+    const uint64_t BLOCK_SIZE = 64 * 1024;
+    uint64_t total = (uint64_t)(end - start);
+    size_t blocks = (size_t)((total + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    std::vector<std::vector<int64_t>> results(blocks);
+
+    GlobalThreadPools::normal_inference().run_in_parallel(
+        [&](size_t index){
+            int64_t block_start = start + (int64_t)(index * BLOCK_SIZE);
+            int64_t block_end = std::min(end, block_start + (int64_t)BLOCK_SIZE);
+            std::vector<int64_t>& found = results[index];
+
+            SeedStreams streams;
+            PrizeRolls rolls;
+            for (int64_t seed = block_start; seed < block_end; seed += SEED_LANES){
+                streams.generate(seed);
+                size_t lanes = (size_t)std::min<int64_t>(SEED_LANES, block_end - seed);
+                for (size_t l = 0; l < lanes; l++){
+                    SeedStreamLane rand(streams, l);
+                    roll_prizes(rolls, rand, table, mode);
+                    if (predicate(rolls)){
+                        found.emplace_back(seed + (int64_t)l);
+                    }
+                }
+
+                //  Later blocks can't contribute anything earlier than this.
+                if (found.size() >= max_results){
+                    break;
+                }
+            }
+        },
+        0, blocks, 1
+    );
+
+    std::vector<int64_t> ret;
+    for (std::vector<int64_t>& block : results){
+        for (int64_t seed : block){
+            if (ret.size() >= max_results){
+                return ret;
+            }
+            ret.emplace_back(seed);
+        }
+    }
+    return ret;
+}
+std::vector<int64_t> search_seeds_for_item(
+    int64_t start, int64_t end,
+    PrintMode mode,
+    uint16_t item_id, uint32_t min_quantity,
+    size_t max_results
+){
+    return search_seeds(
+        start, end, mode,
+        [=](const PrizeRolls& rolls){
+            return count_item(rolls, item_id) >= min_quantity;
+        },
+        max_results
+    );
+}
 
 
 
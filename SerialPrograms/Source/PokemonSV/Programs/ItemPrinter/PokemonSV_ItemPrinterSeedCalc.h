@@ -12,6 +12,7 @@
 #ifndef PokemonAutomation_PokemonSV_ItemPrinterSeedCalc_H
 #define PokemonAutomation_PokemonSV_ItemPrinterSeedCalc_H
 
+#include <functional>
 #include "PokemonSV_ItemPrinterDatabase.h"
 
 namespace PokemonAutomation{
@@ -20,9 +21,54 @@ namespace PokemonSV{
 namespace ItemPrinter{
 
 
+enum class PrintMode{
+    Regular = 0,
+    ItemBonus = 1,
+    BallBonus = 2,
+};
+
+//  Returns nullptr if the ID isn't a known prize.
+const char* item_id_to_slug(int item_id);
+
+
 DateSeed calculate_seed_prizes(int64_t seed);
 
 
+//  The prizes of one 10-print job using game item IDs instead of slugs.
+struct PrizeRoll{
+    uint16_t item_id;
+    uint8_t quantity;
+};
+using PrizeRolls = std::array<PrizeRoll, 10>;
+
+PrizeRolls calculate_prize_rolls(int64_t seed, PrintMode mode);
+
+//  Total quantity of "item_id" over all 10 prints.
+uint32_t count_item(const PrizeRolls& rolls, uint16_t item_id);
+
+
+//  Find the seeds in [start, end) whose prizes in "mode" satisfy "predicate".
+//  Returns up to "max_results" seeds in increasing order.
+//
+//  The range is split across the computation thread pool. Within a block,
+//  seeds are simulated several at a time with their random streams stepped
+//  in lockstep.
+std::vector<int64_t> search_seeds(
+    int64_t start, int64_t end,
+    PrintMode mode,
+    const std::function<bool(const PrizeRolls& rolls)>& predicate,
+    size_t max_results = 1000
+);
+
+//  Find seeds that give at least "min_quantity" of "item_id" in "mode".
+std::vector<int64_t> search_seeds_for_item(
+    int64_t start, int64_t end,
+    PrintMode mode,
+    uint16_t item_id, uint32_t min_quantity,
+    size_t max_results = 1000
+);
+
+
 }
 }
 }
@@ -5,6 +5,8 @@
  */
 
 #include <map>
+#include <vector>
+#include <limits>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Json/JsonValue.h"
 #include "Common/Cpp/Json/JsonArray.h"
@@ -20,15 +22,53 @@ namespace PokemonSwSh{
 namespace MaxLairInternal{
 
 
+//  Number of real types. Type columns are indexed by (size_t)type - 1.
+const size_t TYPE_COUNT = (size_t)PokemonType::FAIRY;
+
 struct PathMatchDatabase{
     std::map<PokemonType, std::set<std::string>> rentals_by_type;
-    std::map<std::string, std::map<PokemonType, double>> type_vs_boss;
+
+    //  Row per boss, column per type. NaN if the type is missing.
+    std::map<std::string, uint16_t> bosses;
+    std::vector<float> type_vs_boss;
+
+    //  Row per boss type (including NONE for "any boss"), column per type.
+    //  Averaged over every boss of that type. NaN if any of them is missing
+    //  the type or there are no bosses of that type.
+    std::vector<float> type_vs_boss_type;
 
     static const PathMatchDatabase& instance(){
         static PathMatchDatabase database;
         return database;
     }
 
+    static size_t type_index(PokemonType type){
+        if (type == PokemonType::NONE || type > PokemonType::FAIRY){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid Type: " + std::to_string((int)type));
+        }
+        return (size_t)type - 1;
+    }
+    static double get(const float* row, PokemonType type){
+        float ret = row[type_index(type)];
+        if (ret != ret){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid Type: " + std::to_string((int)type));
+        }
+        return ret;
+    }
+    const float* boss_row(const std::string& boss_slug) const{
+        auto iter = bosses.find(boss_slug);
+        if (iter == bosses.end()){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid Boss: " + boss_slug);
+        }
+        return type_vs_boss.data() + (size_t)iter->second * TYPE_COUNT;
+    }
+    const float* boss_type_row(PokemonType boss_type) const{
+        if (boss_type > PokemonType::FAIRY){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid Type: " + std::to_string((int)boss_type));
+        }
+        return type_vs_boss_type.data() + (size_t)boss_type * TYPE_COUNT;
+    }
+
 private:
     PathMatchDatabase(){
         std::string path = RESOURCE_PATH() + "PokemonSwSh/MaxLair/path_tree.json";
@@ -52,7 +92,10 @@ private:
 
         JsonObject& node = root.get_object_throw("base_node", path).get_object_throw("hash_table");
         for (auto& item : node){
-            std::map<PokemonType, double>& boss = type_vs_boss[item.first];
+            uint16_t index = (uint16_t)bosses.size();
+            bosses.emplace(item.first, index);
+            type_vs_boss.resize(type_vs_boss.size() + TYPE_COUNT, std::numeric_limits<float>::quiet_NaN());
+            float* row = type_vs_boss.data() + (size_t)index * TYPE_COUNT;
 
             JsonObject& obj = item.second.to_object_throw(path).get_object_throw("hash_table", path);
 
@@ -60,12 +103,42 @@ private:
                 if (type.first == PokemonType::NONE){
                     continue;
                 }
-                boss[type.first] = obj.get_double_throw(type.second, path);
+                row[type_index(type.first)] = (float)obj.get_double_throw(type.second, path);
             }
         }
+
+        build_boss_type_table();
     }
 
+    void build_boss_type_table(){
+        using namespace papkmnlib;
 
+        std::vector<double> sums((TYPE_COUNT + 1) * TYPE_COUNT, 0);
+        std::vector<size_t> counts(TYPE_COUNT + 1, 0);
+
+        for (const auto& item : all_bosses_by_dex()){
+            const Pokemon& boss = get_pokemon(item.second);
+            const float* row = boss_row(boss.name());
+            for (size_t t = 0; t <= TYPE_COUNT; t++){
+                PokemonType boss_type = (PokemonType)t;
+                if (boss_type != PokemonType::NONE && !boss.has_type(serial_type_to_pkmnlib(boss_type))){
+                    continue;
+                }
+                double* sum = sums.data() + t * TYPE_COUNT;
+                for (size_t c = 0; c < TYPE_COUNT; c++){
+                    sum[c] += row[c];
+                }
+                counts[t]++;
+            }
+        }
+
+        type_vs_boss_type.resize(sums.size());
+        for (size_t t = 0; t <= TYPE_COUNT; t++){
+            for (size_t c = 0; c < TYPE_COUNT; c++){
+                type_vs_boss_type[t * TYPE_COUNT + c] = (float)(sums[t * TYPE_COUNT + c] / (double)counts[t]);
+            }
+        }
+    }
 };
 
 
@@ -80,35 +153,11 @@ const std::set<std::string>& rentals_by_type(PokemonType type){
 
 double type_vs_boss(PokemonType type, const std::string& boss_slug){
     const PathMatchDatabase& database = PathMatchDatabase::instance();
-
-    auto iter0 = database.type_vs_boss.find(boss_slug);
-    if (iter0 == database.type_vs_boss.end()){
-        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid Boss: " + boss_slug);
-    }
-
-    auto iter1 = iter0->second.find(type);
-    if (iter1 == iter0->second.end()){
-        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid Type: " + std::to_string((int)type));
-    }
-
-    return iter1->second;
+    return PathMatchDatabase::get(database.boss_row(boss_slug), type);
 }
 double type_vs_boss(PokemonType type, PokemonType boss_type){
-    using namespace papkmnlib;
-
-    Type pkmnlib_type = serial_type_to_pkmnlib(boss_type);
-
-    double weight = 0;
-    size_t count = 0;
-    for (const auto& item : all_bosses_by_dex()){
-        const Pokemon& boss = get_pokemon(item.second);
-        if (boss_type == PokemonType::NONE || boss.has_type(pkmnlib_type)){
-            weight += type_vs_boss(type, boss.name());
-            count++;
-        }
-    }
-
-    return weight / (double)count;
+    const PathMatchDatabase& database = PathMatchDatabase::instance();
+    return PathMatchDatabase::get(database.boss_type_row(boss_type), type);
 }
 
 
@@ -227,8 +276,9 @@ std::vector<std::vector<PathNode>> generate_paths(
 }
 
 
-template <typename Boss>
-double evaluate_path(const Boss& boss, const std::vector<PathNode>& path){
+//  "row" is the boss's row of type matchups. Either a specific boss or the
+//  average for a boss type.
+double evaluate_path(const float* row, const std::vector<PathNode>& path){
     if (path.size() > 3){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Path is longer than 3: " + std::to_string(path.size()));
     }
@@ -238,10 +288,26 @@ double evaluate_path(const Boss& boss, const std::vector<PathNode>& path){
     size_t battle_index = 3 - path.size();
     size_t node_index = 0;
     for (; battle_index < 3; node_index++, battle_index++){
-        weight += type_vs_boss(path[node_index].type, boss) * weights[battle_index];
+        weight += PathMatchDatabase::get(row, path[node_index].type) * weights[battle_index];
     }
     return weight;
 }
+std::vector<double> evaluate_paths(
+    const std::string& boss, PokemonType boss_type,
+    const std::vector<std::vector<PathNode>>& paths
+){
+    const PathMatchDatabase& database = PathMatchDatabase::instance();
+    const float* row = boss.empty()
+        ? database.boss_type_row(boss_type)
+        : database.boss_row(boss);
+
+    std::vector<double> ret;
+    ret.reserve(paths.size());
+    for (const std::vector<PathNode>& path : paths){
+        ret.emplace_back(evaluate_path(row, path));
+    }
+    return ret;
+}
 
 
 std::vector<PathNode> select_path(
@@ -262,15 +328,10 @@ std::vector<PathNode> select_path(
         return {};
     }
 
+    std::vector<double> scores = evaluate_paths(boss, pathmap.boss, paths);
     std::multimap<double, std::vector<PathNode>, std::greater<double>> rank;
-    if (boss.empty()){
-        for (const std::vector<PathNode>& path : paths){
-            rank.emplace(evaluate_path(pathmap.boss, path), path);
-        }
-    }else{
-        for (const std::vector<PathNode>& path : paths){
-            rank.emplace(evaluate_path(boss, path), path);
-        }
+    for (size_t c = 0; c < paths.size(); c++){
+        rank.emplace(scores[c], std::move(paths[c]));
     }
     std::string str = "Available Paths:\n";
     for (const auto& path : rank){
@@ -31,6 +31,14 @@ std::vector<std::vector<PathNode>> generate_paths(
 );
 
 
+//  Score every path against "boss". If "boss" is empty, score against the
+//  average of all bosses of type "boss_type" instead.
+std::vector<double> evaluate_paths(
+    const std::string& boss, PokemonType boss_type,
+    const std::vector<std::vector<PathNode>>& paths
+);
+
+
 std::vector<PathNode> select_path(
     Logger* logger,
     const std::string& boss,
@@ -5,6 +5,7 @@
  */
 
 #include <map>
+#include <limits>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Json/JsonValue.h"
 #include "Common/Cpp/Json/JsonObject.h"
@@ -20,23 +21,44 @@ namespace MaxLairInternal{
 
 
 struct MatchupDatabase{
-    std::map<std::string, std::map<std::string, double>> map;
+    std::map<std::string, uint16_t> rentals;
+    std::map<std::string, uint16_t> bosses;
+
+    //  Row per rental, column per boss. NaN if the pair is missing.
+    std::vector<float> table;
+
+    //  Per boss, the average over every rental Pokemon.
+    std::vector<float> any_rental;
 
     static const MatchupDatabase& instance(){
         static MatchupDatabase database;
         return database;
     }
 
-    double get(const std::string& rental, const std::string& boss) const{
-        auto iter0 = map.find(rental);
-        if (iter0 == map.end()){
+    uint16_t rental_index(const std::string& rental) const{
+        auto iter = rentals.find(rental);
+        if (iter == rentals.end()){
             throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Rental not found: " + rental);
         }
-        auto iter1 = iter0->second.find(boss);
-        if (iter1 == iter0->second.end()){
-            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Boss not found: " + rental);
+        return iter->second;
+    }
+    uint16_t boss_index(const std::string& boss) const{
+        auto iter = bosses.find(boss);
+        if (iter == bosses.end()){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Boss not found: " + boss);
         }
-        return iter1->second;
+        return iter->second;
+    }
+    const float* row(uint16_t rental) const{
+        return table.data() + (size_t)rental * bosses.size();
+    }
+
+    double get(uint16_t rental, uint16_t boss) const{
+        float ret = row(rental)[boss];
+        if (ret != ret){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Matchup not found: " + std::to_string(rental) + ", " + std::to_string(boss));
+        }
+        return ret;
     }
 
 private:
@@ -44,32 +66,106 @@ private:
         std::string path = RESOURCE_PATH() + "PokemonSwSh/MaxLair/boss_matchup_LUT.json";
         JsonValue json = load_json_file(path);
         JsonObject& root = json.to_object_throw(path);
+
+        for (auto& item0 : root){
+            rentals.emplace(item0.first, (uint16_t)rentals.size());
+            JsonObject& obj = item0.second.to_object_throw(path);
+            for (auto& item1 : obj){
+                bosses.emplace(item1.first, (uint16_t)bosses.size());
+            }
+        }
+
+        table.resize(rentals.size() * bosses.size(), std::numeric_limits<float>::quiet_NaN());
         for (auto& item0 : root){
-            std::map<std::string, double>& sub = map[item0.first];
+            float* sub = table.data() + (size_t)rentals[item0.first] * bosses.size();
             JsonObject& obj = item0.second.to_object_throw(path);
             for (auto& item1 : obj){
-                sub[item1.first] = item1.second.to_double_throw(path);
+                sub[bosses[item1.first]] = (float)item1.second.to_double_throw(path);
             }
         }
+
+        //  Rentals that aren't in the table get a NaN average for every boss
+        //  and throw when used. Same as looking them up one by one would.
+        std::vector<double> sums(bosses.size(), 0);
+        const auto& all_rentals = papkmnlib::all_rental_pokemon();
+        for (const auto& item : all_rentals){
+            auto iter = rentals.find(item.first);
+            const float* sub = iter == rentals.end() ? nullptr : row(iter->second);
+            for (size_t c = 0; c < bosses.size(); c++){
+                sums[c] += sub == nullptr ? std::numeric_limits<double>::quiet_NaN() : sub[c];
+            }
+        }
+        any_rental.resize(bosses.size());
+        for (size_t c = 0; c < bosses.size(); c++){
+            any_rental[c] = (float)(sums[c] / (double)all_rentals.size());
+        }
     }
 };
 
+
+uint16_t rental_matchup_index(const std::string& rental){
+    return MatchupDatabase::instance().rental_index(rental);
+}
+uint16_t boss_matchup_index(const std::string& boss){
+    return MatchupDatabase::instance().boss_index(boss);
+}
+
+double rental_vs_boss_matchup(uint16_t rental, const std::vector<uint16_t>& bosses){
+    const MatchupDatabase& database = MatchupDatabase::instance();
+    const float* row = database.row(rental);
+    double score = 0;
+    for (uint16_t boss : bosses){
+        score += row[boss];
+    }
+    if (score != score){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Matchup not found for rental: " + std::to_string(rental));
+    }
+    return score / bosses.size();
+}
+std::vector<double> rental_vs_boss_matchup(
+    const std::vector<uint16_t>& rentals,
+    const std::vector<uint16_t>& bosses
+){
+    std::vector<double> ret;
+    ret.reserve(rentals.size());
+    for (uint16_t rental : rentals){
+        ret.emplace_back(rental_vs_boss_matchup(rental, bosses));
+    }
+    return ret;
+}
+double any_rental_vs_boss_matchup(const std::vector<uint16_t>& bosses){
+    const MatchupDatabase& database = MatchupDatabase::instance();
+    double score = 0;
+    for (uint16_t boss : bosses){
+        score += database.any_rental[boss];
+    }
+    if (score != score){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Rental table is missing rental Pokemon.");
+    }
+    return score / bosses.size();
+}
+
+
 double rental_vs_boss_matchup(const std::string& rental, const std::string& boss){
-    return MatchupDatabase::instance().get(rental, boss);
+    const MatchupDatabase& database = MatchupDatabase::instance();
+    return database.get(database.rental_index(rental), database.boss_index(boss));
 }
 double rental_vs_boss_matchup(const std::string& rental, const std::vector<std::string>& bosses){
     using namespace papkmnlib;
 
+    const MatchupDatabase& database = MatchupDatabase::instance();
+    uint16_t rental_index = database.rental_index(rental);
+
     double score = 0;
     if (bosses.empty()){
         const auto& all_bosses = all_boss_pokemon();
         for (const auto& boss : all_bosses){
-            score += rental_vs_boss_matchup(rental, boss.second.name());
+            score += database.get(rental_index, database.boss_index(boss.second.name()));
         }
         score /= bosses.size();
     }else{
         for (const std::string& boss : bosses){
-            score += rental_vs_boss_matchup(rental, boss);
+            score += database.get(rental_index, database.boss_index(boss));
         }
         score /= bosses.size();
     }
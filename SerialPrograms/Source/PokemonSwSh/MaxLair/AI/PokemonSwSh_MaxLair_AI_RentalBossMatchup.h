@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_PokemonSwSh_MaxLair_AI_RentalBossMatchup_H
 #define PokemonAutomation_PokemonSwSh_MaxLair_AI_RentalBossMatchup_H
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,26 @@ double rental_vs_boss_matchup(const std::string& rental, const std::string& boss
 double rental_vs_boss_matchup(const std::string& rental, const std::vector<std::string>& bosses);
 
 
+//  The matchup table is stored densely with the rental and boss slugs
+//  interned to indices when it is loaded. Look up the indices once and use
+//  the index versions below in loops.
+//  These throw if the slug isn't in the table.
+uint16_t rental_matchup_index(const std::string& rental);
+uint16_t boss_matchup_index(const std::string& boss);
+
+//  Average matchup of "rental" against "bosses".
+double rental_vs_boss_matchup(uint16_t rental, const std::vector<uint16_t>& bosses);
+
+//  Average matchup of each of "rentals" against "bosses".
+std::vector<double> rental_vs_boss_matchup(
+    const std::vector<uint16_t>& rentals,
+    const std::vector<uint16_t>& bosses
+);
+
+//  Average matchup of all rentals against "bosses".
+double any_rental_vs_boss_matchup(const std::vector<uint16_t>& bosses);
+
+
 
 }
 }
@@ -38,18 +38,17 @@ int8_t select_starter(
         return 0;
     }
 
+    std::vector<uint16_t> boss_indices;
+    for (const Pokemon* boss : bosses){
+        boss_indices.emplace_back(boss_matchup_index(boss->name()));
+    }
+
     std::multimap<double, uint8_t, std::greater<double>> rank;
     for (uint8_t c = 0; c < 3; c++){
         if (options[c].empty()){
             continue;
         }
-//        const Pokemon& rental = get_pokemon(options[c]);
-        double score = 0;
-        for (const Pokemon* boss : bosses){
-//            score += evaluate_matchup(rental, *boss, {}, 4);
-            score += rental_vs_boss_matchup(options[c], boss->name());
-        }
-        score /= bosses.size();
+        double score = rental_vs_boss_matchup(rental_matchup_index(options[c]), boss_indices);
         rank.emplace(score, c);
     }
     if (rank.empty()){
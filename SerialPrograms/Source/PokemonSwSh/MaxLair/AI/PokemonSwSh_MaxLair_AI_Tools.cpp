@@ -91,30 +91,24 @@ std::vector<const papkmnlib::Pokemon*> get_boss_candidates(const GlobalState& st
 
 
 
-double rental_vs_boss_matchup(const std::string& rental, const std::vector<const papkmnlib::Pokemon*>& bosses){
-    using namespace papkmnlib;
-
+std::vector<uint16_t> boss_matchup_indices(const std::vector<const papkmnlib::Pokemon*>& bosses){
     if (bosses.empty()){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Boss list cannot be empty.");
     }
-    double score = 0;
-    if (rental.empty()){
-        for (const Pokemon* boss : bosses){
-            for (const auto& candidate : all_rental_pokemon()){
-                score += rental_vs_boss_matchup(candidate.first, boss->name());
-            }
-        }
-        score /= bosses.size() * all_rental_pokemon().size();
-    }else{
-        for (const Pokemon* boss : bosses){
-            score += rental_vs_boss_matchup(rental, boss->name());
-        }
-        score /= bosses.size();
+    std::vector<uint16_t> ret;
+    ret.reserve(bosses.size());
+    for (const papkmnlib::Pokemon* boss : bosses){
+        ret.emplace_back(boss_matchup_index(boss->name()));
     }
-    return score;
+    return ret;
 }
-double rental_vs_boss_matchup(const papkmnlib::Pokemon* rental, const std::vector<const papkmnlib::Pokemon*>& bosses){
-    return rental_vs_boss_matchup(rental == nullptr ? "" : rental->name(), bosses);
+
+//  A null rental is the average over all rental Pokemon.
+double rental_vs_boss_matchup(const papkmnlib::Pokemon* rental, const std::vector<uint16_t>& bosses){
+    if (rental == nullptr){
+        return any_rental_vs_boss_matchup(bosses);
+    }
+    return rental_vs_boss_matchup(rental_matchup_index(rental->name()), bosses);
 }
 
 
@@ -129,9 +123,11 @@ double evaluate_hypothetical_team(
 
     uint8_t lives = 4;
 
+    std::vector<uint16_t> bosses = boss_matchup_indices(boss_candidates_on_path);
+
     double total = 0;
     for (size_t c = 0; c < 4; c++){
-        double score = rental_vs_boss_matchup(team[c], boss_candidates_on_path);
+        double score = rental_vs_boss_matchup(team[c], bosses);
 
         //  Adjust for HP.
         if (team[c] != nullptr){
@@ -89,14 +89,11 @@ std::pair<Xoroshiro128PlusState, uint64_t> refind_rng_state_and_animations(
 )
 {
     Xoroshiro128Plus rng(last_known_state.s0, last_known_state.s1);
-    for (size_t i = 0; i < min_advances; i++){
-        rng.next();
-    }
+    rng.jump(min_advances);
     OrbeetleAttackAnimationDetector detector(stream, context);
     size_t possible_indices = SIZE_MAX;
-    std::vector<bool> sequence = {};
-    std::vector<bool> last_bit_sequence = rng.generate_last_bit_sequence(max_advances - min_advances);
-    size_t distance = 0;
+    size_t window = max_advances - min_advances;
+    Xoroshiro128PlusLastBitLocator locator(rng.generate_last_bit_words(window), window);
 
     size_t i = 0;
     while (possible_indices > 1){
@@ -113,26 +110,17 @@ std::pair<Xoroshiro128PlusState, uint64_t> refind_rng_state_and_animations(
             );
         case OrbeetleAttackAnimationDetector::SPECIAL:
             text += " : Special";
-            sequence.emplace_back(true);
+            locator.push(true);
             break;
         case OrbeetleAttackAnimationDetector::PHYSICAL:
             text += " : Physical";
-            sequence.emplace_back(false);
+            locator.push(false);
             break;
         }
         stream.overlay().add_log(text, COLOR_BLUE);
         pbf_wait(context, 180);
 
-        std::vector<bool>::iterator last_bit_start = std::search(last_bit_sequence.begin(), last_bit_sequence.end(), sequence.begin(), sequence.end());
-        possible_indices = 0;
-        distance = 0;
-        while (last_bit_start != last_bit_sequence.end()){
-            possible_indices++;
-            distance = std::distance(last_bit_sequence.begin(), last_bit_start);
-
-            last_bit_start++;
-            last_bit_start = std::search(last_bit_start, last_bit_sequence.end(), sequence.begin(), sequence.end());
-        }
+        possible_indices = locator.matches();
     }
     if (possible_indices == 0){
         OperationFailedException::fire(
@@ -142,16 +130,14 @@ std::pair<Xoroshiro128PlusState, uint64_t> refind_rng_state_and_animations(
         );
     }
 
-    distance += sequence.size();
-    stream.log("RNG: needed " + std::to_string(sequence.size()) + " animations.");
+    size_t distance = locator.last_match() + locator.sequence_length();
+    stream.log("RNG: needed " + std::to_string(locator.sequence_length()) + " animations.");
     stream.log("RNG: new state is " + std::to_string(distance + min_advances) + " advances from last known state.");
-    for (size_t advance = 0; advance < distance; advance++){
-        rng.next();
-    }
+    rng.jump(distance);
     stream.log("RNG: state[0] = " + tostr_hex(rng.get_state().s0));
     stream.log("RNG: state[1] = " + tostr_hex(rng.get_state().s1));
 
-    return { rng.get_state(), sequence.size() };
+    return { rng.get_state(), locator.sequence_length() };
 }
 
 
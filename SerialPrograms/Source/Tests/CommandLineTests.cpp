@@ -7,15 +7,26 @@
 
 #include "CommandLineTests.h"
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "PokemonLA_Tests.h"
 #include "TestMap.h"
+#include "TestReports.h"
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
 
 #include <iostream>
 #include <list>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
 #include <functional>
 using std::cout;
 using std::cerr;
@@ -43,26 +54,24 @@ void print_equals(){
         } \
     } while (0)
 
-#define RETURN_IF_TEST_FAILED(test_func, file_path, num_passed) \
-    do { \
-        int _ret = 0; \
-        try{ \
-            _ret = test_func(file_path); \
-        } catch (const std::exception& e) { \
-            cout << "Test: " << (file_path) << " threw exception: " << e.what() << endl; \
-            _ret = 1; \
-        } catch (const Exception& e) {\
-           cout << "Test: " << (file_path) << " threw " << e.name() << ": <<<" << e.message() << ">>>" << endl; \
-           _ret = 1; \
-        } \
-        if (_ret > 0) {\
-            print_equals(); \
-            cout << "Test: " << (file_path) << " failed." << endl; \
-            return _ret; \
-        }else if (_ret == 0){ \
-            num_passed++; \
-        } \
-    } while (0)
+
+// One test file to run against one test object.
+struct TestJob{
+    std::string test_key;       // e.g. "PokemonLA_BattleMenuDetector"
+    TestFunction test_func;
+    std::string file_path;
+};
+
+struct TestResult{
+    int ret = 0;                // Same as TestFunction: < 0 skipped, 0 passed, > 0 failed.
+    std::string error;
+    double milliseconds = 0;
+};
+
+// A latency regression must also be at least this large, so that timer
+// noise on tiny detectors doesn't show up.
+const double REGRESSION_MIN_MILLIS = 1.0;
+
 
 bool skip_ignored_path(const QString& file_path, const std::vector<QString>& ignore_list){
     for(const auto& path_prefix : ignore_list){
@@ -74,16 +83,14 @@ bool skip_ignored_path(const QString& file_path, const std::vector<QString>& ign
     return false;
 }
 
-int run_test_obj_dir(TestFunction test_func, const QString& directory_path, size_t& num_passed, const std::vector<QString>& ignore_list){
+void collect_test_obj_dir(
+    std::vector<TestJob>& jobs,
+    const std::string& test_key, const TestFunction& test_func,
+    const QString& directory_path, const std::vector<QString>& ignore_list
+){
     QDirIterator file_iter(directory_path, QDir::Filter::Files, QDirIterator::IteratorFlag::Subdirectories);
 
-    bool first_test_file = true;
     while (file_iter.hasNext()){
-        if (first_test_file == false){
-            cout << "-------------------------------------------" << endl;
-        }
-        first_test_file = false;
-
         const QString next_file = file_iter.next();
         
         // If filename or folder name starts with _, its considered a "hidden" file so skip it.
@@ -91,30 +98,28 @@ int run_test_obj_dir(TestFunction test_func, const QString& directory_path, size
         if (file_info.fileName().startsWith('_') || file_info.dir().dirName().startsWith("_")){
             continue;
         }
-        const std::string file_path = next_file.toStdString();
 
         // Check ignore list to determine whether to skip the test
         if (skip_ignored_path(next_file, ignore_list)){
             continue;
         }
 
-        // Call the function to do the actual test:
-        cout << file_path << endl;
-        RETURN_IF_TEST_FAILED(test_func, file_path, num_passed);
+        jobs.emplace_back(TestJob{test_key, test_func, next_file.toStdString()});
     }
-
-    return 0;
 }
 
-// Run the tests inside a folder representing a "test object".
+// Collect the tests inside a folder representing a "test object".
 // It is usually defined as one detector, e.g. CommandLineTests/PokemonLA/BattleMenuDetector/
-int run_test_obj(const std::string& test_space, const QFileInfo& obj_info, size_t& num_passed, const std::vector<QString>& ignore_list){
+int collect_test_obj(
+    std::vector<TestJob>& jobs,
+    const std::string& test_space, const QFileInfo& obj_info,
+    const std::vector<QString>& ignore_list
+){
     const std::string test_name = obj_info.fileName().toStdString();
     if (test_name == "." || test_name == ".."){
         return 0;
     }
 
-    print_equals();
     const TestFunction test_func = find_test_function(test_space, test_name);
     if (test_func == nullptr){
         // No corresponding test code, skip the folder.
@@ -125,16 +130,15 @@ int run_test_obj(const std::string& test_space, const QFileInfo& obj_info, size_
         return 0;
     }
 
-    cout << "Testing " << test_name << ":" << endl;
-
     // Recursively get test filenames, like:
     // ./CommandLineTests/PokemonLA/BattleMenuDetector/IngoBattleMenuDayTime_True.png
-    return run_test_obj_dir(test_func, obj_info.filePath(), num_passed, ignore_list);
+    collect_test_obj_dir(jobs, test_space + "_" + test_name, test_func, obj_info.filePath(), ignore_list);
+    return 0;
 }
 
-// Run the tests inside a folder representing a "test space".
+// Collect the tests inside a folder representing a "test space".
 // It is usually defined as one pokemon game, e.g. CommandLineTests/PokemonLA/
-int run_test_space(const QFileInfo& space_info, size_t& num_passed, const std::vector<QString>& ignore_list){
+int collect_test_space(std::vector<TestJob>& jobs, const QFileInfo& space_info, const std::vector<QString>& ignore_list){
     QDir sub_dir(space_info.filePath());
     if (!sub_dir.exists()){
         cerr << "Error: cannot access " << space_info.filePath().toStdString() << endl;
@@ -156,12 +160,341 @@ int run_test_space(const QFileInfo& space_info, size_t& num_passed, const std::v
     // ./CommandLineTests/PokemonLA/BattleMenuDetector/
     const QFileInfoList obj_list = sub_dir.entryInfoList();
     for(const QFileInfo& obj_info : obj_list){
-        RETURN_IF_NOT_ZERO(run_test_obj(test_space, obj_info, num_passed, ignore_list));
+        RETURN_IF_NOT_ZERO(collect_test_obj(jobs, test_space, obj_info, ignore_list));
     }
 
     return 0;
 }
 
+// Collect the self-contained tests under "path". It can be empty (all of
+// them), a test space ("CommonFramework") or a test object
+// ("CommonFramework/SuperscalarScheduler"). They have no test files, so the
+// job's file path just names the test object under the root test folder.
+// Returns the number of tests collected.
+size_t collect_self_contained_tests(
+    std::vector<TestJob>& jobs,
+    const std::string& root_folder_name, const std::string& path,
+    const std::vector<QString>& ignore_list
+){
+    size_t count = 0;
+    for (const auto& item : self_contained_tests()){
+        // "CommonFramework_SuperscalarScheduler" -> "CommonFramework/SuperscalarScheduler"
+        std::string test_path = item.first;
+        test_path[test_path.find('_')] = '/';
+        if (!path.empty() && test_path != path && test_path.rfind(path + "/", 0) != 0){
+            continue;
+        }
+
+        const QString file_path = QDir::cleanPath(QString::fromStdString(root_folder_name + "/" + test_path));
+        if (skip_ignored_path(file_path, ignore_list)){
+            continue;
+        }
+
+        const SelfContainedTestFunction test_func = item.second;
+        jobs.emplace_back(TestJob{
+            item.first,
+            [test_func](const std::string&){ return test_func(); },
+            file_path.toStdString()
+        });
+        count++;
+    }
+    return count;
+}
+
+// Collect the tests selected by COMMAND_LINE_TEST_LIST.
+int collect_selected_tests(
+    std::vector<TestJob>& jobs,
+    const std::string& root_folder_name,
+    const std::vector<std::string>& selected_test_list,
+    const std::vector<QString>& ignore_list
+){
+    const QFileInfo test_root_info(root_folder_name.c_str());
+
+    for(const std::string& test_path : selected_test_list){
+        const std::string full_path = root_folder_name + "/" + test_path;
+        const QString full_path_cleaned = QDir::cleanPath(QString::fromStdString(full_path));
+
+        if (full_path_cleaned.size() == 0){
+            cerr << "Error: empty path found in TEST_LIST" << endl;
+            return 1;
+        }
+
+        if (skip_ignored_path(full_path_cleaned, ignore_list)){
+            continue;
+        }
+
+        // Self-contained tests don't have a folder. So a path that doesn't
+        // exist is fine as long as it selected some of them.
+        const size_t self_contained = collect_self_contained_tests(
+            jobs, root_folder_name,
+            QDir::cleanPath(QString::fromStdString(test_path)).toStdString(),
+            ignore_list
+        );
+
+        QFileInfo selected_path_info(full_path_cleaned);
+
+        if (selected_path_info.exists() == false){
+            if (self_contained > 0){
+                continue;
+            }
+            cerr << "Error: path " << full_path << " in TEST_LIST does not exist." << endl;
+            return 1;
+        }
+
+        std::list<QString> path_components;
+        {
+            QString path = full_path_cleaned;
+            QFileInfo cur_info(path);
+            while(cur_info != test_root_info){
+                path_components.push_front(cur_info.fileName());
+                // Go upper one level of folder:
+                path = cur_info.path();
+                cur_info = QFileInfo(path);
+            }
+        }
+        // If full_path is "CommandLineTest/PokemonLA/DialogueEllipseDetector/macOS_bright/WendyNight_True.png", then
+        // path_components contains:
+        // - PokemonLA
+        // - DialogueEllipseDetector
+        // - macOS_bright
+        // - WendyNight_True.png
+        if (path_components.size() == 0){
+            cerr << "Error: cannot parse " << full_path << ". Empty path in TEST_LIST?" << endl;
+            return 1;
+        }
+
+        QDir cur_dir(root_folder_name.c_str());
+
+        auto it = path_components.begin();
+        std::string test_space = it->toStdString();
+        QFileInfo test_space_info(cur_dir.filePath(*it));
+        cur_dir = QDir(test_space_info.filePath());
+        if (path_components.size() == 1){
+            RETURN_IF_NOT_ZERO(collect_test_space(jobs, test_space_info, ignore_list));
+            continue;
+        }
+
+        it++;
+        std::string test_name = it->toStdString();
+        QFileInfo test_obj_info(cur_dir.filePath(*it));
+        if (path_components.size() == 2){
+            RETURN_IF_NOT_ZERO(collect_test_obj(jobs, test_space, test_obj_info, ignore_list));
+            continue;
+        }
+
+        const auto test_func = find_test_function(test_space, test_name);
+        if (test_func == nullptr){
+            return 2;
+        }
+
+        const std::string test_key = test_space + "_" + test_name;
+        if (selected_path_info.isFile()){
+            jobs.emplace_back(TestJob{test_key, test_func, full_path_cleaned.toStdString()});
+        }else{
+            // selected_path_info is a directory, go through each file recursively in the directory
+            collect_test_obj_dir(jobs, test_key, test_func, full_path_cleaned, ignore_list);
+        }
+    }
+
+    return 0;
+}
+
+
+TestResult run_test_job(const TestJob& job){
+    TestResult result;
+    auto start = std::chrono::steady_clock::now();
+    try{
+        result.ret = job.test_func(job.file_path);
+    }catch (const std::exception& e){
+        result.error = std::string("threw exception: ") + e.what();
+        result.ret = 1;
+    }catch (const Exception& e){
+        result.error = std::string("threw ") + e.name() + ": <<<" + e.message() + ">>>";
+        result.ret = 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+// Run every job, "threads" at a time. Each worker pulls the next unclaimed
+// file so that slow detectors don't hold up a whole shard.
+// A failed test doesn't stop the others.
+void run_test_jobs(const std::vector<TestJob>& jobs, std::vector<TestResult>& results, size_t threads){
+    results.resize(jobs.size());
+    threads = std::max<size_t>(std::min(threads, jobs.size()), 1);
+
+    //  With a single thread the test output can't interleave, so keep
+    //  announcing each file before its output like the serial runner did.
+    const bool print_each_file = threads == 1;
+
+    std::mutex print_lock;
+    std::atomic<size_t> next_job(0);
+    auto worker = [&]{
+        while (true){
+            size_t index = next_job.fetch_add(1, std::memory_order_relaxed);
+            if (index >= jobs.size()){
+                return;
+            }
+            if (print_each_file){
+                cout << jobs[index].file_path << endl;
+            }
+            results[index] = run_test_job(jobs[index]);
+
+            const TestResult& result = results[index];
+            if (result.ret > 0){
+                std::lock_guard<std::mutex> lg(print_lock);
+                cout << "Test: " << jobs[index].file_path << " failed";
+                if (!result.error.empty()){
+                    cout << ", " << result.error;
+                }
+                cout << endl;
+            }
+        }
+    };
+
+    std::vector<Thread> workers;
+    for (size_t c = 1; c < threads; c++){
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (Thread& thread : workers){
+        thread.join();
+    }
+}
+
+
+struct LatencyProfile{
+    size_t count = 0;
+    double total = 0;
+    double p50 = 0;
+    double p99 = 0;
+};
+
+// Per test object latencies of all the tests that actually ran. (not skipped)
+std::map<std::string, LatencyProfile> build_latency_profiles(
+    const std::vector<TestJob>& jobs,
+    const std::vector<TestResult>& results
+){
+    std::map<std::string, std::vector<double>> samples;
+    for (size_t c = 0; c < jobs.size(); c++){
+        if (results[c].ret >= 0){
+            samples[jobs[c].test_key].emplace_back(results[c].milliseconds);
+        }
+    }
+
+    std::map<std::string, LatencyProfile> ret;
+    for (auto& item : samples){
+        std::vector<double>& times = item.second;
+        std::sort(times.begin(), times.end());
+        LatencyProfile& profile = ret[item.first];
+        profile.count = times.size();
+        for (double x : times){
+            profile.total += x;
+        }
+        profile.p50 = times[(times.size() - 1) * 50 / 100];
+        profile.p99 = times[(times.size() - 1) * 99 / 100];
+    }
+    return ret;
+}
+
+const char* result_string(int ret){
+    if (ret < 0){
+        return "Skip";
+    }
+    return ret == 0 ? "Pass" : "Fail";
+}
+
+JsonObject make_report(
+    const std::string& root_folder_name,
+    size_t threads, double wall_milliseconds,
+    const std::vector<TestJob>& jobs,
+    const std::vector<TestResult>& results,
+    const std::map<std::string, LatencyProfile>& profiles
+){
+    // Paths are stored relative to the root test folder so that reports from
+    // different machines can be compared.
+    const QDir root_dir(root_folder_name.c_str());
+
+    JsonObject tests;
+    for (size_t c = 0; c < jobs.size(); c++){
+        JsonObject test;
+        test["Test"] = jobs[c].test_key;
+        test["Result"] = result_string(results[c].ret);
+        test["Milliseconds"] = results[c].milliseconds;
+        if (!results[c].error.empty()){
+            test["Error"] = results[c].error;
+        }
+        tests[root_dir.relativeFilePath(QString::fromStdString(jobs[c].file_path)).toStdString()] = std::move(test);
+    }
+
+    JsonObject detectors;
+    for (const auto& item : profiles){
+        JsonObject profile;
+        profile["Count"] = (int64_t)item.second.count;
+        profile["TotalMilliseconds"] = item.second.total;
+        profile["P50"] = item.second.p50;
+        profile["P99"] = item.second.p99;
+        detectors[item.first] = std::move(profile);
+    }
+
+    JsonObject report;
+    report["Threads"] = (int64_t)threads;
+    report["WallMilliseconds"] = wall_milliseconds;
+    report["Tests"] = std::move(tests);
+    report["Detectors"] = std::move(detectors);
+    return report;
+}
+
+// Compare this run against a report from an earlier run.
+// Returns the number of regressions found.
+size_t compare_tests_and_latencies(const JsonObject& baseline, const JsonObject& report){
+    size_t regressions = 0;
+
+    // Tests that passed in the baseline, but fail now.
+    const JsonObject* old_tests = baseline.get_object("Tests");
+    const JsonObject& new_tests = report.get_object_throw("Tests");
+    if (old_tests != nullptr){
+        for (const auto& item : new_tests){
+            const JsonObject* old_test = old_tests->get_object(item.first);
+            if (old_test == nullptr){
+                continue;
+            }
+            std::string old_result, new_result;
+            old_test->read_string(old_result, "Result");
+            item.second.to_object_throw().read_string(new_result, "Result");
+            if (old_result == "Pass" && new_result == "Fail"){
+                cout << "Regression: " << item.first << " passed in baseline, now fails." << endl;
+                regressions++;
+            }
+        }
+    }
+
+    // Detectors that got slower.
+    const JsonObject* old_detectors = baseline.get_object("Detectors");
+    const JsonObject& new_detectors = report.get_object_throw("Detectors");
+    if (old_detectors != nullptr){
+        for (const auto& item : new_detectors){
+            const JsonObject* old_profile = old_detectors->get_object(item.first);
+            if (old_profile == nullptr){
+                continue;
+            }
+            const JsonObject& new_profile = item.second.to_object_throw();
+            for (const char* percentile : {"P50", "P99"}){
+                double old_time = old_profile->get_double_default(percentile);
+                double new_time = new_profile.get_double_default(percentile);
+                if (is_regression(old_time, new_time, REGRESSION_MIN_MILLIS)){
+                    cout << "Regression: " << item.first << " " << percentile << " latency "
+                         << old_time << " ms -> " << new_time << " ms" << endl;
+                    regressions++;
+                }
+            }
+        }
+    }
+
+    return regressions;
+}
+
 
 
 
@@ -170,7 +503,8 @@ int run_test_space(const QFileInfo& space_info, size_t& num_passed, const std::v
 
 
 int run_command_line_tests(){
-    const auto& root_folder_name = GlobalSettings::instance().COMMAND_LINE_TEST_FOLDER;
+    const GlobalSettings& settings = GlobalSettings::instance();
+    const auto& root_folder_name = settings.COMMAND_LINE_TEST_FOLDER;
 
     QDir test_root_dir(root_folder_name.c_str());
     if (!test_root_dir.exists()){
@@ -178,17 +512,14 @@ int run_command_line_tests(){
         return 1;
     }
 
-    QFileInfo test_root_info(root_folder_name.c_str());
     cout << "Looking for tests under test root folder: " << root_folder_name << endl;
 
-    size_t num_passed = 0;
-
-    const auto& selected_test_list = GlobalSettings::instance().COMMAND_LINE_TEST_LIST;
+    const auto& selected_test_list = settings.COMMAND_LINE_TEST_LIST;
 
     // The ignore list will be used to skip path.
     // The ignore list functions as path prefixes when determining which path to skip.
     std::vector<QString> ignore_list;
-    for(const std::string& ignore_path : GlobalSettings::instance().COMMAND_LINE_IGNORE_LIST){
+    for(const std::string& ignore_path : settings.COMMAND_LINE_IGNORE_LIST){
         QString path_cleaned = QDir::cleanPath(QString::fromStdString(root_folder_name + "/" + ignore_path));
         // Remove the trailing '/' or '\\' to make sure it can match the input path
         // without the trailing '/' or '\\'.
@@ -198,7 +529,8 @@ int run_command_line_tests(){
         ignore_list.emplace_back(std::move(path_cleaned));
     }
 
-    // Run all tests
+    // Gather every test file first, then run them all.
+    std::vector<TestJob> jobs;
     if (selected_test_list.size() == 0){
         // Look for sub-folders, e.g.
         // ./CommandLineTests/PokemonLA/
@@ -206,90 +538,73 @@ int run_command_line_tests(){
         test_root_dir.setFilter(QDir::Filter::Dirs);
         const QFileInfoList sub_dir_list = test_root_dir.entryInfoList();
         for(const QFileInfo& sub_dir_info : sub_dir_list){
-            RETURN_IF_NOT_ZERO(run_test_space(sub_dir_info, num_passed, ignore_list));
+            RETURN_IF_NOT_ZERO(collect_test_space(jobs, sub_dir_info, ignore_list));
         }
+        collect_self_contained_tests(jobs, root_folder_name, "", ignore_list);
     }else{
         // Only run on selected tests
-        for(const std::string& test_path : selected_test_list){
-            const std::string full_path = root_folder_name + "/" + test_path;
-            const QString full_path_cleaned = QDir::cleanPath(QString::fromStdString(full_path));
-
-            if (full_path_cleaned.size() == 0){
-                cerr << "Error: empty path found in TEST_LIST" << endl;
-                return 1;
-            }
-
-            if (skip_ignored_path(full_path_cleaned, ignore_list)){
-                continue;
-            }
+        RETURN_IF_NOT_ZERO(collect_selected_tests(jobs, root_folder_name, selected_test_list, ignore_list));
+    }
 
-            QFileInfo selected_path_info(full_path_cleaned);
+    // Tests run one at a time unless asked otherwise. Running in parallel
+    // interleaves the output and times the detectors under contention.
+    size_t threads = settings.COMMAND_LINE_TEST_THREADS;
+    if (threads == 0){
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
 
-            if (selected_path_info.exists() == false){
-                cerr << "Error: path " << full_path << " in TEST_LIST does not exist." << endl;
-                return 1;
-            }
+    print_equals();
+    cout << "Running " << jobs.size() << " test file" << (jobs.size() != 1 ? "s" : "")
+         << " on " << threads << " thread" << (threads != 1 ? "s" : "") << "." << endl;
 
-            std::list<QString> path_components;
-            {
-                QString path = full_path_cleaned;
-                QFileInfo cur_info(path);
-                while(cur_info != test_root_info){
-                    path_components.push_front(cur_info.fileName());
-                    // Go upper one level of folder:
-                    path = cur_info.path();
-                    cur_info = QFileInfo(path);
-                }
-            }
-            // If full_path is "CommandLineTest/PokemonLA/DialogueEllipseDetector/macOS_bright/WendyNight_True.png", then
-            // path_components contains:
-            // - PokemonLA
-            // - DialogueEllipseDetector
-            // - macOS_bright
-            // - WendyNight_True.png
-            if (path_components.size() == 0){
-                cerr << "Error: cannot parse " << full_path << ". Empty path in TEST_LIST?" << endl;
-                return 1;
-            }
+    std::vector<TestResult> results;
+    auto start = std::chrono::steady_clock::now();
+    run_test_jobs(jobs, results, threads);
+    auto end = std::chrono::steady_clock::now();
+    double wall_milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
 
-            QDir cur_dir(root_folder_name.c_str());
+    size_t num_passed = 0;
+    size_t num_failed = 0;
+    for (const TestResult& result : results){
+        if (result.ret == 0){
+            num_passed++;
+        }else if (result.ret > 0){
+            num_failed++;
+        }
+    }
 
-            auto it = path_components.begin();
-            std::string test_space = it->toStdString();
-            QFileInfo test_space_info(cur_dir.filePath(*it));
-            cur_dir = QDir(test_space_info.filePath());
-            if (path_components.size() == 1){
-                RETURN_IF_NOT_ZERO(run_test_space(test_space_info, num_passed, ignore_list));
-                continue;
-            }
+    const std::map<std::string, LatencyProfile> profiles = build_latency_profiles(jobs, results);
 
-            it++;
-            std::string test_name = it->toStdString();
-            QFileInfo test_obj_info(cur_dir.filePath(*it));
-            if (path_components.size() == 2){
-                RETURN_IF_NOT_ZERO(run_test_obj(test_space, test_obj_info, num_passed, ignore_list));
-                continue;
-            }
+    print_equals();
+    cout << "Detector latencies (ms):" << endl;
+    for (const auto& item : profiles){
+        cout << "- " << item.first << ": n = " << item.second.count
+             << ", p50 = " << item.second.p50
+             << ", p99 = " << item.second.p99 << endl;
+    }
 
-            const auto test_func = find_test_function(test_space, test_name);
-            if (test_func == nullptr){
-                return 2;
+    if (num_failed > 0){
+        print_equals();
+        cout << "Failed tests:" << endl;
+        for (size_t c = 0; c < jobs.size(); c++){
+            if (results[c].ret > 0){
+                cout << "- " << jobs[c].file_path << endl;
             }
+        }
+    }
 
-            print_equals();
-            if (selected_path_info.isFile()){
-                // Call the function to do the actual test:
-                RETURN_IF_TEST_FAILED(test_func, full_path_cleaned.toStdString(), num_passed);
-            }else{
-                // selected_path_info is a directory, go through each file recursively in the directory
-                RETURN_IF_NOT_ZERO(run_test_obj_dir(test_func, full_path_cleaned, num_passed, ignore_list));
-            }
-        } // end selected_test_list
+    const JsonObject report = make_report(root_folder_name, threads, wall_milliseconds, jobs, results, profiles);
+    write_report(report, settings.COMMAND_LINE_TEST_REPORT);
+    size_t regressions = 0;
+    if (!settings.COMMAND_LINE_TEST_BASELINE.empty()){
+        print_equals();
+        regressions = compare_with_baseline(report, settings.COMMAND_LINE_TEST_BASELINE, compare_tests_and_latencies);
     }
 
     print_equals();
-    cout << num_passed << " test" << (num_passed > 1 ? "s" : "") << " passed" << std::endl;
-    return 0;
+    cout << num_passed << " test" << (num_passed > 1 ? "s" : "") << " passed, "
+         << num_failed << " failed, in " << wall_milliseconds / 1000 << " s" << std::endl;
+    return num_failed == 0 && regressions == 0 ? 0 : 1;
 }
 
 
@@ -49,6 +49,24 @@
  * or serving as an extra file in case some tests need more than one test files. Files whose parent directory name starts with "_"
  * are skipped as well.
  * 
+ *  Some tests generate their own input and need no test files, e.g. checking an optimized routine against a simple reference
+ *  implementation. They are listed in TestMap.cpp:SELF_CONTAINED_TEST_MAP and run along with the file based tests. They can be
+ *  selected and ignored by their test space and test object name, e.g. "CommonFramework/SuperscalarScheduler", as if they were folders.
+ * 
+ *  How tests are run:
+ * 
+ *  All the test files are collected first and then run on a pool of threads, one file at a time per thread. A failed test does not
+ *  stop the run. All failures are listed at the end and the run returns non-zero if there was any.
+ *  "20-GlobalSettings": "COMMAND_LINE_TESTS": "THREADS" sets the number of threads. The default is 1. 0 means one per core. Only
+ *  run in parallel if the tests you select are thread safe. The output is interleaved and the latencies are measured under contention.
+ * 
+ *  Every test file is timed. The run prints the p50/p99 latency of each test object (detector) and writes a JSON report to
+ *  "20-GlobalSettings": "COMMAND_LINE_TESTS": "REPORT" (default: CommandLineTestReport.json, empty to disable). The report holds the
+ *  result and time of each test file (relative to the test folder) and the latency profile of each detector.
+ *  To catch regressions, save a report from a known good build and point
+ *  "20-GlobalSettings": "COMMAND_LINE_TESTS": "BASELINE" to it. Tests that passed in the baseline but fail now, and detectors whose
+ *  p50 or p99 got noticeably slower, are listed as regressions. Regressions make the run return non-zero, the same as failures.
+ * 
  *  How to add new test code:
  * 
  *  The test framework calls TestMap.h: find_test_function(test_space, test_obj_name) to find the test function related to a test path.
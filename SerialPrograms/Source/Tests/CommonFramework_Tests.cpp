@@ -5,16 +5,25 @@
  */
 
 
+#include <fstream>
+#include <QDir>
+#include <QFile>
+#include "Common/Cpp/Time.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Recording/Mp4Concatenator.h"
+#include "CommonFramework/Recording/Mp4Concatenator_Debugging.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTools/ImageStatsTable.h"
+#include "Controllers/Schedulers/SuperscalarScheduler.h"
 #include "CommonTools/VisualDetectors/BlackBorderDetector.h"
 #include "CommonFramework_Tests.h"
 #include "TestUtils.h"
 
 
-//#include <iostream>
+#include <iostream>
 //using std::cout;
-//using std::cerr;
-//using std::endl;
+using std::cerr;
+using std::endl;
 
 namespace PokemonAutomation{
 
@@ -29,4 +38,432 @@ int test_CommonFramework_BlackBorderDetector(const ImageViewRGB32& image, bool t
 }
 
 
+int test_CommonFramework_ImageStatsTable(const ImageViewRGB32& image){
+    if (image.width() == 0 || image.height() == 0){
+        return 0;
+    }
+    ImageStatsTable table(image);
+
+    uint32_t state = 0x12345678;
+    auto next = [&]{
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+
+    size_t width = image.width();
+    size_t height = image.height();
+    for (size_t c = 0; c < 10000; c++){
+        size_t min_x = next() % width;
+        size_t min_y = next() % height;
+        size_t max_x = min_x + 1 + next() % (width - min_x);
+        size_t max_y = min_y + 1 + next() % (height - min_y);
+
+        Kernels::PixelSums expected;
+        ImageViewRGB32 box = image.sub_image(min_x, min_y, max_x - min_x, max_y - min_y);
+        Kernels::pixel_sum_sqr(
+            expected, box.width(), box.height(),
+            box.data(), box.bytes_per_row(),
+            box.data(), box.bytes_per_row()
+        );
+
+        Kernels::PixelSums actual;
+        table.add_sums(actual, min_x, min_y, max_x, max_y);
+
+        TEST_RESULT_EQUAL(actual.count, expected.count);
+        TEST_RESULT_EQUAL(actual.sumR, expected.sumR);
+        TEST_RESULT_EQUAL(actual.sumG, expected.sumG);
+        TEST_RESULT_EQUAL(actual.sumB, expected.sumB);
+        TEST_RESULT_EQUAL(actual.sqrR, expected.sqrR);
+        TEST_RESULT_EQUAL(actual.sqrG, expected.sqrG);
+        TEST_RESULT_EQUAL(actual.sqrB, expected.sqrB);
+    }
+
+    return 0;
+}
+
+
+int test_CommonFramework_SuperscalarScheduler(){
+    const size_t resource_count = 8;
+    const size_t issues = 200000;
+
+    //  Replay a dense stream of overlapping presses across the resources.
+    //  This is what the scheduler sees when a program mashes buttons while
+    //  holding joysticks. Each press must show up in the schedule for exactly
+    //  as long as it was held. Idle time need not appear at all.
+    std::vector<std::shared_ptr<const SchedulerResource>> resources;
+    for (size_t c = 0; c < resource_count; c++){
+        resources.emplace_back(std::make_shared<SchedulerResource>(c));
+    }
+
+    SuperscalarScheduler scheduler(global_logger_command_line(), Milliseconds(100));
+    SuperscalarScheduler::Schedule schedule;
+
+    std::vector<WallDuration> expected_hold(resource_count, WallDuration::zero());
+    std::vector<WallDuration> actual_hold(resource_count, WallDuration::zero());
+
+    auto check_schedule = [&]{
+        for (const SuperscalarScheduler::ScheduleEntry& entry : schedule){
+            TEST_RESULT_COMPONENT_EQUAL(entry.duration > WallDuration::zero(), true, "positive duration");
+            for (size_t c = 0; c < entry.state.size(); c++){
+                size_t id = entry.state[c]->id;
+                TEST_RESULT_COMPONENT_EQUAL(id < resource_count, true, "resource id");
+                TEST_RESULT_COMPONENT_EQUAL(c == 0 || entry.state[c - 1]->id < id, true, "sorted state");
+                actual_hold[id] += entry.duration;
+            }
+        }
+        schedule.clear();
+        return 0;
+    };
+
+    uint32_t state = 0x12345678;
+    auto next = [&]{
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+
+    for (size_t c = 0; c < issues; c++){
+        uint32_t r = next();
+        switch (r % 16){
+        case 0:
+            scheduler.issue_nop(schedule, Milliseconds(r % 7));
+            break;
+        case 1:
+            scheduler.issue_wait_for_all(schedule);
+            break;
+        default:{
+            size_t id = (r >> 4) % resource_count;
+            WallDuration hold = Milliseconds(1 + (r >> 12) % 40);
+            scheduler.issue_to_resource(
+                schedule,
+                resources[id],
+                Milliseconds((r >> 8) % 4),
+                hold,
+                Milliseconds((r >> 16) % 8)
+            );
+            expected_hold[id] += hold;
+        }
+        }
+        if (check_schedule() != 0){
+            return 1;
+        }
+    }
+
+    scheduler.issue_wait_for_all(schedule);
+    if (check_schedule() != 0){
+        return 1;
+    }
+    for (size_t id = 0; id < resource_count; id++){
+        TEST_RESULT_COMPONENT_EQUAL(
+            std::chrono::duration_cast<Milliseconds>(actual_hold[id]).count(),
+            std::chrono::duration_cast<Milliseconds>(expected_hold[id]).count(),
+            "hold time of resource " + std::to_string(id)
+        );
+    }
+
+    return 0;
+}
+
+
+
+namespace{
+
+void append_u32(std::string& str, uint32_t x){
+    str += (char)(x >> 24);
+    str += (char)(x >> 16);
+    str += (char)(x >>  8);
+    str += (char)(x >>  0);
+}
+std::string make_box(const char* type, const std::string& payload){
+    std::string ret;
+    append_u32(ret, (uint32_t)(payload.size() + 8));
+    ret.append(type, 4);
+    return ret + payload;
+}
+std::string zeros(size_t bytes){
+    return std::string(bytes, '\0');
+}
+
+//  One track of a generated segment. Every chunk holds the same number of
+//  samples.
+struct GeneratedTrack{
+    const char* handler;
+    uint32_t timescale;
+    uint32_t sample_delta;
+    uint32_t samples_per_chunk;
+    int32_t priming;            //  -1 for no edit list.
+    std::vector<std::string> samples;
+};
+
+std::string make_trak(
+    uint32_t track_id, const GeneratedTrack& track,
+    uint32_t movie_timescale, const std::vector<uint32_t>& chunk_offsets
+){
+    uint32_t media_duration = (uint32_t)track.samples.size() * track.sample_delta;
+
+    std::string tkhd;
+    append_u32(tkhd, 3);
+    tkhd += zeros(8);
+    append_u32(tkhd, track_id);
+    tkhd += zeros(4);
+    append_u32(tkhd, (uint32_t)((uint64_t)media_duration * movie_timescale / track.timescale));
+    tkhd += zeros(60);
+
+    std::string trak = make_box("tkhd", tkhd);
+    if (track.priming >= 0){
+        std::string elst;
+        append_u32(elst, 0);
+        append_u32(elst, 1);
+        append_u32(elst, (uint32_t)((uint64_t)(media_duration - track.priming) * movie_timescale / track.timescale));
+        append_u32(elst, (uint32_t)track.priming);
+        append_u32(elst, 0x00010000);
+        trak += make_box("edts", make_box("elst", elst));
+    }
+
+    std::string mdhd;
+    append_u32(mdhd, 0);
+    mdhd += zeros(8);
+    append_u32(mdhd, track.timescale);
+    append_u32(mdhd, media_duration);
+    mdhd += zeros(4);
+
+    std::string hdlr = zeros(8);
+    hdlr.append(track.handler, 4);
+    hdlr += zeros(13);
+
+    std::string stsd;
+    append_u32(stsd, 0);
+    append_u32(stsd, 1);
+    stsd += make_box("test", zeros(8));
+
+    std::string stts;
+    append_u32(stts, 0);
+    append_u32(stts, 1);
+    append_u32(stts, (uint32_t)track.samples.size());
+    append_u32(stts, track.sample_delta);
+
+    std::string stsc;
+    append_u32(stsc, 0);
+    append_u32(stsc, 1);
+    append_u32(stsc, 1);
+    append_u32(stsc, track.samples_per_chunk);
+    append_u32(stsc, 1);
+
+    std::string stsz;
+    append_u32(stsz, 0);
+    append_u32(stsz, 0);
+    append_u32(stsz, (uint32_t)track.samples.size());
+    for (const std::string& sample : track.samples){
+        append_u32(stsz, (uint32_t)sample.size());
+    }
+
+    std::string stco;
+    append_u32(stco, 0);
+    append_u32(stco, (uint32_t)chunk_offsets.size());
+    for (uint32_t offset : chunk_offsets){
+        append_u32(stco, offset);
+    }
+
+    std::string stbl =
+        make_box("stsd", stsd) + make_box("stts", stts) + make_box("stsc", stsc) +
+        make_box("stsz", stsz) + make_box("stco", stco);
+    std::string mdia =
+        make_box("mdhd", mdhd) + make_box("hdlr", hdlr) +
+        make_box("minf", make_box("stbl", stbl));
+    trak += make_box("mdia", mdia);
+    return make_box("trak", trak);
+}
+
+//  Write a segment with the chunks of the tracks interleaved.
+bool write_segment(const std::string& filename, const std::vector<GeneratedTrack>& tracks){
+    const uint32_t MOVIE_TIMESCALE = 1000;
+
+    std::string ftyp = make_box("ftyp", "isom" + zeros(4) + "isom");
+
+    std::string mdat;
+    std::vector<std::vector<uint32_t>> offsets(tracks.size());
+    for (size_t chunk = 0;; chunk++){
+        bool done = true;
+        for (size_t t = 0; t < tracks.size(); t++){
+            const GeneratedTrack& track = tracks[t];
+            size_t start = chunk * track.samples_per_chunk;
+            if (start >= track.samples.size()){
+                continue;
+            }
+            done = false;
+            offsets[t].emplace_back((uint32_t)mdat.size());
+            size_t end = std::min(start + track.samples_per_chunk, track.samples.size());
+            for (size_t s = start; s < end; s++){
+                mdat += track.samples[s];
+            }
+        }
+        if (done){
+            break;
+        }
+    }
+
+    //  The chunk offsets don't change the size of "moov". Build it once to
+    //  find where the samples start.
+    auto make_moov = [&](uint32_t mdat_start){
+        std::string mvhd;
+        append_u32(mvhd, 0);
+        mvhd += zeros(8);
+        append_u32(mvhd, MOVIE_TIMESCALE);
+        append_u32(mvhd, 0);
+        append_u32(mvhd, 0x00010000);
+        mvhd += zeros(76);
+        std::string moov = make_box("mvhd", mvhd);
+        for (size_t t = 0; t < tracks.size(); t++){
+            std::vector<uint32_t> chunk_offsets = offsets[t];
+            for (uint32_t& offset : chunk_offsets){
+                offset += mdat_start;
+            }
+            moov += make_trak((uint32_t)t + 1, tracks[t], MOVIE_TIMESCALE, chunk_offsets);
+        }
+        return make_box("moov", moov);
+    };
+    uint32_t mdat_start = (uint32_t)(ftyp.size() + make_moov(0).size() + 8);
+
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+    stream << ftyp << make_moov(mdat_start) << make_box("mdat", mdat);
+    return (bool)stream;
+}
+
+//  Presented length of a track in movie timescale units.
+uint64_t presented_duration(const Mp4TrackInfo& track, uint32_t movie_timescale){
+    if (track.edits.empty()){
+        return track.media_duration * movie_timescale / track.timescale;
+    }
+    uint64_t ret = 0;
+    for (const Mp4Edit& edit : track.edits){
+        ret += edit.duration;
+    }
+    return ret;
+}
+
+//  Join "segments" generated segments whose audio tracks start with
+//  "priming" samples of encoder delay, then check the result.
+int check_mp4_concatenation(size_t segments, int32_t priming){
+    Logger& logger = global_logger_command_line();
+    const QDir temp_dir = QDir::temp();
+
+    //  One second of 30 fps video and about one second of 48 kHz AAC-sized
+    //  audio frames per segment. Every sample has different contents.
+    uint32_t state = 0x12345678;
+    auto next = [&]{
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+    auto make_samples = [&](size_t count){
+        std::vector<std::string> ret;
+        for (size_t c = 0; c < count; c++){
+            std::string sample(16 + next() % 200, '\0');
+            for (char& ch : sample){
+                ch = (char)next();
+            }
+            ret.emplace_back(std::move(sample));
+        }
+        return ret;
+    };
+
+    std::vector<std::string> inputs;
+    for (size_t c = 0; c < segments; c++){
+        std::vector<GeneratedTrack> tracks{
+            {"vide", 90000, 3000, 10, -1, make_samples(30)},
+            {"soun", 48000, 1024, 16, priming, make_samples(48)},
+        };
+        inputs.emplace_back(temp_dir.filePath("Mp4Concatenator-" + QString::number(c) + ".mp4").toStdString());
+        if (!write_segment(inputs.back(), tracks)){
+            cerr << "Error: unable to write " << inputs.back() << endl;
+            return 1;
+        }
+    }
+    const std::string output = temp_dir.filePath("Mp4Concatenator-joined.mp4").toStdString();
+
+    bool ok = concatenate_mp4(logger, inputs, output);
+
+    std::vector<uint32_t> movie_timescales(segments);
+    std::vector<std::vector<Mp4TrackInfo>> input_tracks(segments);
+    for (size_t c = 0; c < segments; c++){
+        ok &= read_mp4_tracks(logger, inputs[c], movie_timescales[c], input_tracks[c]);
+    }
+    uint32_t movie_timescale = 0;
+    std::vector<Mp4TrackInfo> output_tracks;
+    ok &= read_mp4_tracks(logger, output, movie_timescale, output_tracks);
+
+    for (const std::string& file : inputs){
+        QFile::remove(QString::fromStdString(file));
+    }
+    QFile::remove(QString::fromStdString(output));
+
+    TEST_RESULT_COMPONENT_EQUAL(ok, true, "concatenate and read back");
+    TEST_RESULT_COMPONENT_EQUAL(movie_timescale, movie_timescales[0], "movie timescale");
+    TEST_RESULT_COMPONENT_EQUAL(output_tracks.size(), input_tracks[0].size(), "number of tracks");
+
+    for (size_t t = 0; t < output_tracks.size(); t++){
+        const Mp4TrackInfo& joined = output_tracks[t];
+        const std::string track_name = "track " + std::to_string(t) + " ";
+
+        //  The samples are the samples of every segment in order.
+        std::vector<uint32_t> checksums;
+        uint64_t media_duration = 0;
+        for (size_t c = 0; c < segments; c++){
+            const Mp4TrackInfo& segment = input_tracks[c][t];
+            checksums.insert(checksums.end(), segment.sample_checksums.begin(), segment.sample_checksums.end());
+            media_duration += segment.media_duration;
+        }
+        TEST_RESULT_COMPONENT_EQUAL(joined.handler, input_tracks[0][t].handler, track_name + "handler");
+        TEST_RESULT_COMPONENT_EQUAL(joined.sample_checksums.size(), checksums.size(), track_name + "number of samples");
+        TEST_RESULT_COMPONENT_EQUAL(joined.sample_checksums == checksums, true, track_name + "sample data");
+        TEST_RESULT_COMPONENT_EQUAL(joined.media_duration, media_duration, track_name + "media duration");
+
+        //  Each segment gets its own edit, starting after its priming
+        //  samples and cut to the length of its shortest track.
+        TEST_RESULT_COMPONENT_EQUAL(joined.edits.size(), segments, track_name + "number of edits");
+        uint64_t media_start = 0;
+        for (size_t c = 0; c < segments; c++){
+            uint64_t length = (uint64_t)-1;
+            for (const Mp4TrackInfo& track : input_tracks[c]){
+                length = std::min(length, presented_duration(track, movie_timescale));
+            }
+            const Mp4TrackInfo& segment = input_tracks[c][t];
+            int64_t media_time = (int64_t)media_start + (segment.edits.empty() ? 0 : segment.edits[0].media_time);
+            const std::string edit_name = track_name + "edit " + std::to_string(c) + " ";
+            TEST_RESULT_COMPONENT_EQUAL(joined.edits[c].media_time, media_time, edit_name + "media time");
+            TEST_RESULT_COMPONENT_EQUAL(joined.edits[c].duration, length, edit_name + "duration");
+            media_start += segment.media_duration;
+        }
+    }
+
+    return 0;
+}
+
+}
+
+int test_CommonFramework_Mp4Concatenator(){
+    //  One segment, priming as a fresh recording has it, a segment without
+    //  an audio edit list, and priming longer than one audio frame.
+    const struct{
+        size_t segments;
+        int32_t priming;
+    } CASES[] = {
+        {1, 1024},
+        {3, 1024},
+        {3, -1},
+        {4, 2112},
+    };
+    for (const auto& item : CASES){
+        if (check_mp4_concatenation(item.segments, item.priming) != 0){
+            cerr << "Error: joining " << item.segments << " segments with " << item.priming << " priming samples failed." << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
 }
@@ -15,6 +15,17 @@ class ImageViewRGB32;
 
 int test_CommonFramework_BlackBorderDetector(const ImageViewRGB32& image, bool target);
 
+//  Compare box stats from ImageStatsTable against scanning the box directly.
+int test_CommonFramework_ImageStatsTable(const ImageViewRGB32& image);
+
+//  Replay random presses through the controller scheduler and check that each
+//  resource is held for as long as it was issued.
+int test_CommonFramework_SuperscalarScheduler();
+
+//  Generate MP4 segments, join them with concatenate_mp4() and read back the
+//  result.
+int test_CommonFramework_Mp4Concatenator();
+
 }
 
 #endif
@@ -0,0 +1,531 @@
+/*  Kernels Benchmarks
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <bit>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include "Common/Compiler.h"
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "Controllers/Schedulers/SuperscalarScheduler.h"
+#include "Kernels/BinaryMatrix/Kernels_BinaryMatrix.h"
+#include "Kernels/BinaryImageFilters/Kernels_BinaryImage_BasicFilters.h"
+#include "Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range.h"
+#include "Kernels/ImageFilters/RGB32_EuclideanDistance/Kernels_ImageFilter_RGB32_Euclidean.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqr.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqrDev.h"
+#include "Kernels/Waterfill/Kernels_Waterfill.h"
+#include "Kernels/AbsFFT/Kernels_AbsFFT.h"
+#include "Kernels/SpikeConvolution/Kernels_SpikeConvolution.h"
+#include "Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch.h"
+#include "Kernels/AudioStreamConversion/AudioStreamConversion.h"
+#include "TestReports.h"
+#include "Kernels_Benchmarks.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+namespace PokemonAutomation{
+
+using namespace Kernels;
+
+namespace{
+
+
+const size_t WARMUP_CALLS = 3;
+const size_t REPETITIONS = 15;
+
+//  Each repetition calls the kernel enough times to last at least this long.
+const std::chrono::microseconds MIN_REPETITION_TIME(2000);
+
+
+struct ImageSize{
+    const char* label;
+    size_t width;
+    size_t height;
+};
+const ImageSize IMAGE_SIZES[] = {
+    {"320x180",     320,  180},
+    {"1280x720",    1280, 720},
+    {"1920x1080",   1920, 1080},
+};
+const size_t AUDIO_LENGTHS[] = {1024, 65536};
+const int FFT_POWERS[] = {10, 12, 14};
+const size_t SPIKE_INPUT_LENGTHS[] = {2048, 16384};
+const size_t SPIKE_KERNEL_LENGTH = 256;
+const ImageSize SPECTROGRAM_SIZES[] = {
+    {"64x32",   64,  32},
+    {"512x64",  512, 64},
+};
+const size_t SCHEDULER_RESOURCES = 8;
+const size_t SCHEDULER_ISSUES_PER_CALL = 1000;
+
+
+//  Keeps the compiler from throwing away kernel results.
+volatile uint64_t SINK;
+
+//  Float results are sunk by their bits. Converting a negative float
+//  straight to an unsigned integer is undefined.
+uint64_t float_bits(float x){
+    return std::bit_cast<uint32_t>(x);
+}
+
+
+struct BenchmarkCase{
+    std::string family;
+    std::string name;
+    size_t items;               //  Pixels, samples or matrix elements per call.
+    std::function<void()> run;
+};
+
+struct BenchmarkStats{
+    double median_ns;
+    double min_ns;
+    double mean_ns;
+    double stddev_ns;
+};
+
+
+std::vector<uint32_t> make_random_pixels(size_t count, uint32_t seed){
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> ret(count);
+    for (uint32_t& pixel : ret){
+        pixel = (uint32_t)rng() | 0xff000000;
+    }
+    return ret;
+}
+AlignedVector<float> make_random_floats(size_t count, uint32_t seed){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    AlignedVector<float> ret(count);
+    for (size_t c = 0; c < count; c++){
+        ret[c] = dist(rng);
+    }
+    return ret;
+}
+
+
+//  The cases are built after switching tiers since binary matrices are
+//  created for the tier that is current at the time.
+
+void add_image_cases(std::vector<BenchmarkCase>& cases, const ImageSize& size){
+    const size_t width = size.width;
+    const size_t height = size.height;
+    const size_t pixels = width * height;
+    const size_t bytes_per_row = width * sizeof(uint32_t);
+    const std::string suffix = std::string(" ") + size.label;
+
+    auto image = std::make_shared<std::vector<uint32_t>>(make_random_pixels(pixels, 1));
+    auto other = std::make_shared<std::vector<uint32_t>>(make_random_pixels(pixels, 2));
+    auto out = std::make_shared<std::vector<uint32_t>>(pixels);
+
+    std::shared_ptr<PackedBinaryMatrix_IB> matrix = make_PackedBinaryMatrix(get_BinaryMatrixType(), width, height);
+    std::shared_ptr<PackedBinaryMatrix_IB> blobs = make_PackedBinaryMatrix(get_BinaryMatrixType(), width, height);
+    compress_rgb32_to_binary_range(image->data(), bytes_per_row, *blobs, 0xff000000, 0xff7f7f7f);
+
+    cases.emplace_back(BenchmarkCase{
+        "ImageFilters", "filter_rgb32_range" + suffix, pixels,
+        [=]{
+            SINK = filter_rgb32_range(
+                image->data(), bytes_per_row, width, height,
+                out->data(), bytes_per_row,
+                0xffffffff, true, 0xff404040, 0xffc0c0c0
+            );
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "ImageFilters", "filter_rgb32_euclidean" + suffix, pixels,
+        [=]{
+            SINK = filter_rgb32_euclidean(
+                image->data(), bytes_per_row, width, height,
+                out->data(), bytes_per_row,
+                0xffffffff, true, 0xff808080, 100
+            );
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "BinaryImageFilters", "compress_rgb32_to_binary_range" + suffix, pixels,
+        [=]{
+            compress_rgb32_to_binary_range(image->data(), bytes_per_row, *matrix, 0xff404040, 0xffc0c0c0);
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "BinaryImageFilters", "compress_rgb32_to_binary_euclidean" + suffix, pixels,
+        [=]{
+            compress_rgb32_to_binary_euclidean(image->data(), bytes_per_row, *matrix, 0xff808080, 100);
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "BinaryImageFilters", "filter_by_mask" + suffix, pixels,
+        [=]{
+            filter_by_mask(*blobs, out->data(), bytes_per_row, 0xffffffff, true);
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "Waterfill", "find_objects_inplace" + suffix, pixels,
+        [=]{
+            //  Waterfill destroys its input. Restore it without reallocating.
+            matrix->set_zero();
+            *matrix |= *blobs;
+            SINK = Waterfill::find_objects_inplace(*matrix, 20).size();
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "ImageStats", "pixel_sum_sqr" + suffix, pixels,
+        [=]{
+            PixelSums sums;
+            pixel_sum_sqr(
+                sums, width, height,
+                image->data(), bytes_per_row,
+                other->data(), bytes_per_row
+            );
+            SINK = sums.sqrR;
+        }
+    });
+    cases.emplace_back(BenchmarkCase{
+        "ImageStats", "sum_sqr_deviation" + suffix, pixels,
+        [=]{
+            uint64_t count, sumsqrs;
+            sum_sqr_deviation(
+                count, sumsqrs, width, height,
+                image->data(), bytes_per_row,
+                other->data(), bytes_per_row
+            );
+            SINK = sumsqrs;
+        }
+    });
+}
+
+void add_audio_cases(std::vector<BenchmarkCase>& cases){
+    for (int k : FFT_POWERS){
+        size_t length = (size_t)1 << k;
+        auto input = std::make_shared<AlignedVector<float>>(make_random_floats(length, 3));
+        auto real = std::make_shared<AlignedVector<float>>(length);
+        auto abs = std::make_shared<AlignedVector<float>>(length / 2);
+        cases.emplace_back(BenchmarkCase{
+            "AbsFFT", "fft_abs " + std::to_string(length), length,
+            [=]{
+                //  The transform destroys its input.
+                std::copy(input->begin(), input->end(), real->begin());
+                AbsFFT::fft_abs(k, abs->data(), real->data());
+                SINK = float_bits((*abs)[1]);
+            }
+        });
+    }
+
+    for (size_t length : SPIKE_INPUT_LENGTHS){
+        auto input = std::make_shared<AlignedVector<float>>(make_random_floats(length, 4));
+        auto kernel = std::make_shared<AlignedVector<float>>(make_random_floats(SPIKE_KERNEL_LENGTH, 5));
+        auto out = std::make_shared<AlignedVector<float>>(length + PA_ALIGNMENT / sizeof(float));
+        cases.emplace_back(BenchmarkCase{
+            "SpikeConvolution",
+            "compute_spike_kernel " + std::to_string(length) + "x" + std::to_string(SPIKE_KERNEL_LENGTH),
+            length - SPIKE_KERNEL_LENGTH + 1,
+            [=]{
+                SpikeConvolution::compute_spike_kernel(
+                    out->data(), input->data(), length,
+                    kernel->data(), SPIKE_KERNEL_LENGTH
+                );
+                SINK = float_bits((*out)[0]);
+            }
+        });
+    }
+
+    for (const ImageSize& size : SPECTROGRAM_SIZES){
+        //  Pad the rows so they all have the same alignment.
+        const size_t stride = (size.width + 15) & ~(size_t)15;
+        struct Matrices{
+            AlignedVector<float> A, T, W;
+            std::vector<const float*> a, t, w;
+        };
+        auto data = std::make_shared<Matrices>();
+        data->A = make_random_floats(stride * size.height, 6);
+        data->T = make_random_floats(stride * size.height, 7);
+        data->W = make_random_floats(stride * size.height, 8);
+        for (size_t r = 0; r < size.height; r++){
+            data->a.emplace_back(data->A.data() + r * stride);
+            data->t.emplace_back(data->T.data() + r * stride);
+            data->w.emplace_back(data->W.data() + r * stride);
+        }
+        const size_t width = size.width;
+        const size_t height = size.height;
+        const std::string suffix = std::string(" ") + size.label;
+        cases.emplace_back(BenchmarkCase{
+            "ScaleInvariantMatrixMatch", "compute_scale" + suffix, width * height,
+            [=]{
+                SINK = float_bits(ScaleInvariantMatrixMatch::compute_scale(
+                    width, height, data->a.data(), data->t.data()
+                ));
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "ScaleInvariantMatrixMatch", "compute_error (weighted)" + suffix, width * height,
+            [=]{
+                SINK = float_bits(ScaleInvariantMatrixMatch::compute_error(
+                    width, height, 1.5f, data->a.data(), data->t.data(), data->w.data()
+                ));
+            }
+        });
+    }
+
+    for (size_t length : AUDIO_LENGTHS){
+        auto floats = std::make_shared<AlignedVector<float>>(make_random_floats(length, 9));
+        auto ints = std::make_shared<std::vector<int16_t>>(length);
+        cases.emplace_back(BenchmarkCase{
+            "AudioStreamConversion", "convert_audio_float_to_sint16 " + std::to_string(length), length,
+            [=]{
+                AudioStreamConversion::convert_audio_float_to_sint16(ints->data(), floats->data(), length);
+                SINK = (*ints)[0];
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "AudioStreamConversion", "convert_audio_sint16_to_float " + std::to_string(length), length,
+            [=]{
+                AudioStreamConversion::convert_audio_sint16_to_float(floats->data(), ints->data(), length, 1.0f / 32768);
+                SINK = float_bits((*floats)[0]);
+            }
+        });
+    }
+}
+
+//  Not a kernel, but just as hot. Every controller command goes through it.
+void add_scheduler_cases(std::vector<BenchmarkCase>& cases){
+    struct State{
+        std::vector<std::shared_ptr<const SchedulerResource>> resources;
+        SuperscalarScheduler scheduler{global_logger_command_line(), Milliseconds(100)};
+        SuperscalarScheduler::Schedule schedule;
+        uint32_t rng = 0x12345678;
+    };
+    auto state = std::make_shared<State>();
+    for (size_t c = 0; c < SCHEDULER_RESOURCES; c++){
+        state->resources.emplace_back(std::make_shared<SchedulerResource>(c));
+    }
+
+    //  A dense stream of overlapping presses across a handful of resources.
+    //  This is what the scheduler sees when a program mashes buttons while
+    //  holding joysticks.
+    cases.emplace_back(BenchmarkCase{
+        "Scheduler",
+        "SuperscalarScheduler " + std::to_string(SCHEDULER_RESOURCES) + " resources",
+        SCHEDULER_ISSUES_PER_CALL,
+        [=]{
+            size_t entries = 0;
+            for (size_t c = 0; c < SCHEDULER_ISSUES_PER_CALL; c++){
+                uint32_t r = state->rng;
+                r ^= r << 13;
+                r ^= r >> 17;
+                r ^= r << 5;
+                state->rng = r;
+                switch (r % 16){
+                case 0:
+                    state->scheduler.issue_nop(state->schedule, Milliseconds(r % 7));
+                    break;
+                case 1:
+                    state->scheduler.issue_wait_for_all(state->schedule);
+                    break;
+                default:
+                    state->scheduler.issue_to_resource(
+                        state->schedule,
+                        state->resources[(r >> 4) % SCHEDULER_RESOURCES],
+                        Milliseconds((r >> 8) % 4),
+                        Milliseconds(1 + (r >> 12) % 40),
+                        Milliseconds((r >> 16) % 8)
+                    );
+                }
+                entries += state->schedule.size();
+                state->schedule.clear();
+            }
+            SINK = entries;
+        }
+    });
+}
+
+std::vector<BenchmarkCase> make_cases(){
+    std::vector<BenchmarkCase> cases;
+    for (const ImageSize& size : IMAGE_SIZES){
+        add_image_cases(cases, size);
+    }
+    add_audio_cases(cases);
+    add_scheduler_cases(cases);
+    return cases;
+}
+
+
+BenchmarkStats run_benchmark(const BenchmarkCase& benchmark){
+    using Clock = std::chrono::steady_clock;
+
+    for (size_t c = 0; c < WARMUP_CALLS; c++){
+        benchmark.run();
+    }
+
+    //  Pick how many calls make up one repetition.
+    size_t calls = 1;
+    while (true){
+        auto start = Clock::now();
+        for (size_t c = 0; c < calls; c++){
+            benchmark.run();
+        }
+        auto elapsed = Clock::now() - start;
+        if (elapsed >= MIN_REPETITION_TIME){
+            break;
+        }
+        calls *= 2;
+    }
+
+    std::vector<double> samples;
+    for (size_t r = 0; r < REPETITIONS; r++){
+        auto start = Clock::now();
+        for (size_t c = 0; c < calls; c++){
+            benchmark.run();
+        }
+        auto end = Clock::now();
+        samples.emplace_back(std::chrono::duration<double, std::nano>(end - start).count() / calls);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    BenchmarkStats stats;
+    stats.median_ns = samples[samples.size() / 2];
+    stats.min_ns = samples[0];
+    double sum = 0;
+    for (double x : samples){
+        sum += x;
+    }
+    stats.mean_ns = sum / samples.size();
+    double variance = 0;
+    for (double x : samples){
+        variance += (x - stats.mean_ns) * (x - stats.mean_ns);
+    }
+    stats.stddev_ns = std::sqrt(variance / samples.size());
+    return stats;
+}
+
+
+//  Returns the number of kernels whose median got slower than the baseline.
+size_t compare_kernel_medians(const JsonObject& baseline, const JsonObject& report){
+    const JsonObject* old_tiers = baseline.get_object("Tiers");
+    if (old_tiers == nullptr){
+        cerr << "Error: baseline report has no kernel tiers." << endl;
+        return 1;
+    }
+
+    size_t regressions = 0;
+    for (const auto& tier : report.get_object_throw("Tiers")){
+        const JsonObject* old_tier = old_tiers->get_object(tier.first);
+        if (old_tier == nullptr){
+            continue;
+        }
+        const JsonObject* old_kernels = old_tier->get_object("Kernels");
+        if (old_kernels == nullptr){
+            continue;
+        }
+        for (const auto& kernel : tier.second.to_object_throw().get_object_throw("Kernels")){
+            const JsonObject* old_kernel = old_kernels->get_object(kernel.first);
+            if (old_kernel == nullptr){
+                continue;
+            }
+            double old_time = old_kernel->get_double_default("MedianNs");
+            double new_time = kernel.second.to_object_throw().get_double_default("MedianNs");
+            if (is_regression(old_time, new_time)){
+                cout << "Regression: [" << tier.first << "] " << kernel.first << ": "
+                     << old_time << " ns -> " << new_time << " ns" << endl;
+                regressions++;
+            }
+        }
+    }
+    return regressions;
+}
+
+
+
+}
+
+
+
+int run_kernel_benchmarks(){
+    const GlobalSettings& settings = GlobalSettings::instance();
+
+    cout << "Kernel benchmarks (" << PA_ARCH_STRING << "): " << WARMUP_CALLS << " warmup calls, "
+         << REPETITIONS << " repetitions." << endl;
+
+    const CPU_Features saved_capability = CPU_CAPABILITY_CURRENT;
+
+    //  Median time of each kernel on the C++ only tier, to compute speedups.
+    std::map<std::string, double> baseline_tier;
+
+    JsonObject tiers;
+    for (const CpuCapabilityOption& option : AVAILABLE_CAPABILITIES()){
+        if (!option.available){
+            continue;
+        }
+        CPU_CAPABILITY_CURRENT = option.features;
+
+        cout << "===========================================" << endl;
+        cout << option.display << ":" << endl;
+
+        JsonObject kernels;
+        for (const BenchmarkCase& benchmark : make_cases()){
+            BenchmarkStats stats = run_benchmark(benchmark);
+            const std::string key = benchmark.family + "/" + benchmark.name;
+
+            auto iter = baseline_tier.find(key);
+            if (iter == baseline_tier.end()){
+                iter = baseline_tier.emplace(key, stats.median_ns).first;
+            }
+            double speedup = iter->second / stats.median_ns;
+
+            cout << "- " << std::left << std::setw(64) << key << std::right
+                 << std::setw(12) << std::fixed << std::setprecision(0) << stats.median_ns << " ns"
+                 << "  (+/- " << std::setprecision(1) << 100 * stats.stddev_ns / stats.mean_ns << "%)"
+                 << "  x" << std::setprecision(2) << speedup << endl;
+            cout.unsetf(std::ios_base::floatfield);
+
+            JsonObject obj;
+            obj["Family"] = benchmark.family;
+            obj["Items"] = (int64_t)benchmark.items;
+            obj["MedianNs"] = stats.median_ns;
+            obj["MinNs"] = stats.min_ns;
+            obj["MeanNs"] = stats.mean_ns;
+            obj["StdDevNs"] = stats.stddev_ns;
+            obj["ItemsPerSecond"] = benchmark.items * 1e9 / stats.median_ns;
+            obj["Speedup"] = speedup;
+            kernels[key] = std::move(obj);
+        }
+
+        JsonObject tier;
+        tier["Display"] = option.display;
+        tier["Kernels"] = std::move(kernels);
+        tiers[option.slug] = std::move(tier);
+    }
+
+    CPU_CAPABILITY_CURRENT = saved_capability;
+
+    JsonObject report;
+    report["Arch"] = PA_ARCH_STRING;
+    report["Warmup"] = (int64_t)WARMUP_CALLS;
+    report["Repetitions"] = (int64_t)REPETITIONS;
+    report["Tiers"] = std::move(tiers);
+
+    cout << "===========================================" << endl;
+    write_report(report, settings.KERNEL_BENCHMARK_REPORT);
+    size_t regressions = compare_with_baseline(report, settings.KERNEL_BENCHMARK_BASELINE, compare_kernel_medians);
+    return regressions == 0 ? 0 : 1;
+}
+
+
+
+}
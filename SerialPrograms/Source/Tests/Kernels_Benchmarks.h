@@ -0,0 +1,39 @@
+/*  Kernels Benchmarks
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Benchmarks every kernel family on every CPU tier the machine supports.
+ *
+ *  Enable it by setting the SerialPrograms-Settings.json field:
+ *  "20-GlobalSettings": "KERNEL_BENCHMARKS": "RUN" to true.
+ *  In this mode, the program does not launch GUI. For each available tier in
+ *  AVAILABLE_CAPABILITIES() it switches CPU_CAPABILITY_CURRENT to that tier and
+ *  times each kernel on synthetic data of several sizes: a few warmup calls,
+ *  then a number of repetitions, each long enough to not be dominated by timer
+ *  resolution. The median, min, mean and standard deviation of the time per
+ *  call are reported, along with the speedup over the C++ only tier.
+ *  The controller scheduler is timed the same way, in issues per second.
+ *
+ *  The results are written as JSON to "KERNEL_BENCHMARKS": "REPORT".
+ *  If "KERNEL_BENCHMARKS": "BASELINE" points to a report from an earlier run,
+ *  every kernel whose median got slower by more than the tolerance is listed
+ *  as a regression and the run returns non-zero.
+ *
+ */
+
+#ifndef PokemonAutomation_Tests_Kernels_Benchmarks_H
+#define PokemonAutomation_Tests_Kernels_Benchmarks_H
+
+
+namespace PokemonAutomation{
+
+
+// Called by main() instead of launching the GUI when
+// GlobalSettings::KERNEL_BENCHMARK_MODE is true.
+// Return 0 if there are no regressions against the baseline.
+int run_kernel_benchmarks();
+
+
+
+}
+#endif
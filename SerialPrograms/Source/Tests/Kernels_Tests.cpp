@@ -26,6 +26,8 @@
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic.h"
 #include "Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range.h"
 #include "Kernels/ImageFilters/RGB32_EuclideanDistance/Kernels_ImageFilter_RGB32_Euclidean.h"
+#include "Kernels/ImageHSV/Kernels_ImageHSV.h"
+#include "Kernels/ImageScale/Kernels_ImageScale.h"
 #include "Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.h"
 #include "Kernels/Waterfill/Kernels_Waterfill.h"
 #include "Kernels/Waterfill/Kernels_Waterfill_Session.h"
@@ -45,7 +47,26 @@ namespace PokemonAutomation{
 
 using namespace Kernels;
 
-namespace Kernels{}
+namespace Kernels{
+    void scale_bilinear_Default(
+        const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+        uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+    );
+    void scale_area_Default(
+        const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+        uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+    );
+    void rgb32_to_hsv32_Default(
+        const uint32_t* in, size_t in_bytes_per_row,
+        uint32_t* out, size_t out_bytes_per_row,
+        size_t width, size_t height
+    );
+    HsvDistanceSum hsv32_distance_Default(
+        const uint32_t* image0, size_t bytes_per_row0,
+        const uint32_t* image1, size_t bytes_per_row1,
+        size_t width, size_t height
+    );
+}
 
 namespace{
 
@@ -75,6 +96,168 @@ int test_kernels_ImageScaleBrightness(const ImageViewRGB32& image){
 }
 
 
+int test_kernels_ImageScale(const ImageViewRGB32& image){
+    using ScaleFunction = void (*)(
+        const uint32_t* in, size_t in_bytes_per_row, size_t in_width, size_t in_height,
+        uint32_t* out, size_t out_bytes_per_row, size_t out_width, size_t out_height
+    );
+    struct Mode{
+        const char* name;
+        ScaleFunction dispatched;
+        ScaleFunction reference;
+    };
+    const Mode modes[] = {
+        {"bilinear", scale_bilinear, scale_bilinear_Default},
+        {"area", scale_area, scale_area_Default},
+    };
+
+    const size_t width = image.width();
+    const size_t height = image.height();
+    const std::pair<size_t, size_t> sizes[] = {
+        {width / 3, height / 3},
+        {width / 2 + 1, height / 2 + 3},
+        {width * 3 / 2 + 7, height * 5 / 4 + 1},
+        {50, 50},
+        {1, 1},
+    };
+
+    //  Every instruction set must produce exactly the same pixels as the
+    //  default implementation.
+    for (const Mode& mode : modes){
+        for (const auto& size : sizes){
+            if (size.first == 0 || size.second == 0){
+                continue;
+            }
+            ImageRGB32 expected(size.first, size.second);
+            ImageRGB32 actual(size.first, size.second);
+            mode.reference(
+                image.data(), image.bytes_per_row(), width, height,
+                expected.data(), expected.bytes_per_row(), expected.width(), expected.height()
+            );
+            mode.dispatched(
+                image.data(), image.bytes_per_row(), width, height,
+                actual.data(), actual.bytes_per_row(), actual.width(), actual.height()
+            );
+            size_t mismatches = 0;
+            for (size_t r = 0; r < expected.height(); r++){
+                for (size_t c = 0; c < expected.width(); c++){
+                    mismatches += expected.pixel(c, r) != actual.pixel(c, r);
+                }
+            }
+            TEST_RESULT_EQUAL(mismatches, (size_t)0);
+        }
+    }
+
+    //  Same size must be an exact copy.
+    for (const Mode& mode : modes){
+        ImageRGB32 out(width, height);
+        mode.dispatched(
+            image.data(), image.bytes_per_row(), width, height,
+            out.data(), out.bytes_per_row(), width, height
+        );
+        size_t mismatches = 0;
+        for (size_t r = 0; r < height; r++){
+            for (size_t c = 0; c < width; c++){
+                mismatches += image.pixel(c, r) != out.pixel(c, r);
+            }
+        }
+        TEST_RESULT_EQUAL(mismatches, (size_t)0);
+    }
+
+    const int num_iterations = 100;
+    for (ImageScaleMode mode : {ImageScaleMode::NEAREST, ImageScaleMode::BILINEAR, ImageScaleMode::AREA}){
+        ImageRGB32 out(width / 3, height / 3);
+        auto time_start = current_time();
+        for (int i = 0; i < num_iterations; i++){
+            image.scale_to(out, mode);
+        }
+        auto time_end = current_time();
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count();
+        cout << "Mode " << (int)mode << ": " << us / num_iterations << " us per scale to 1/3." << endl;
+    }
+
+    return 0;
+}
+
+
+int test_kernels_ImageHSV(const ImageViewRGB32& image){
+    const size_t width = image.width();
+    const size_t height = image.height();
+
+    //  Every instruction set must produce exactly the same pixels as the
+    //  default implementation.
+    ImageRGB32 expected(width, height);
+    ImageRGB32 actual(width, height);
+    rgb32_to_hsv32_Default(
+        image.data(), image.bytes_per_row(),
+        expected.data(), expected.bytes_per_row(),
+        width, height
+    );
+    rgb32_to_hsv32(
+        image.data(), image.bytes_per_row(),
+        actual.data(), actual.bytes_per_row(),
+        width, height
+    );
+    size_t mismatches = 0;
+    for (size_t r = 0; r < height; r++){
+        for (size_t c = 0; c < width; c++){
+            mismatches += expected.pixel(c, r) != actual.pixel(c, r);
+        }
+    }
+    TEST_RESULT_EQUAL(mismatches, (size_t)0);
+
+    //  Compare the image against a shifted copy of itself.
+    for (size_t shift : {0, 1, 7}){
+        if (shift >= width || shift >= height){
+            continue;
+        }
+        const uint32_t* shifted = (const uint32_t*)((const char*)actual.data() + shift * actual.bytes_per_row()) + shift;
+        HsvDistanceSum reference = hsv32_distance_Default(
+            actual.data(), actual.bytes_per_row(),
+            shifted, actual.bytes_per_row(),
+            width - shift, height - shift
+        );
+        HsvDistanceSum dispatched = hsv32_distance(
+            actual.data(), actual.bytes_per_row(),
+            shifted, actual.bytes_per_row(),
+            width - shift, height - shift
+        );
+        TEST_RESULT_EQUAL(dispatched.sum, reference.sum);
+        TEST_RESULT_EQUAL(dispatched.count, reference.count);
+        if (shift == 0){
+            TEST_RESULT_EQUAL(dispatched.sum, (uint64_t)0);
+        }
+    }
+
+    const int num_iterations = 100;
+    auto time_start = current_time();
+    for (int i = 0; i < num_iterations; i++){
+        rgb32_to_hsv32(
+            image.data(), image.bytes_per_row(),
+            actual.data(), actual.bytes_per_row(),
+            width, height
+        );
+    }
+    auto time_end = current_time();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count();
+    cout << "RGB -> HSV: " << us / num_iterations << " us per image." << endl;
+
+    time_start = current_time();
+    for (int i = 0; i < num_iterations; i++){
+        hsv32_distance(
+            actual.data(), actual.bytes_per_row(),
+            expected.data(), expected.bytes_per_row(),
+            width, height
+        );
+    }
+    time_end = current_time();
+    us = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count();
+    cout << "HSV distance: " << us / num_iterations << " us per image." << endl;
+
+    return 0;
+}
+
+
 int test_kernels_BinaryMatrix(const ImageViewRGB32& image){
 
     if (test_binary_matrix_tile() != 0){
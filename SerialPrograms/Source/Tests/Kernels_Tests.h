@@ -15,6 +15,10 @@ class ImageViewRGB32;
 
 int test_kernels_ImageScaleBrightness(const ImageViewRGB32& image);
 
+int test_kernels_ImageScale(const ImageViewRGB32& image);
+
+int test_kernels_ImageHSV(const ImageViewRGB32& image);
+
 int test_kernels_BinaryMatrix(const ImageViewRGB32& image);
 
 int test_kernels_FilterRGB32Range(const ImageViewRGB32& image);
@@ -36,6 +36,7 @@
 #include "PokemonSV/Inference/Overworld/PokemonSV_OverworldDetector.h"
 #include "PokemonSV/Inference/Dialogs/PokemonSV_DialogDetector.h"
 #include "PokemonSV/Inference/PokemonSV_ESPEmotionDetector.h"
+#include "PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedCalc.h"
 
 #include <iostream>
 using std::cout;
@@ -586,4 +587,58 @@ int test_pokemonSV_RecentlyBattledDetector(const ImageViewRGB32& image, bool tar
     return 0;
 }
 
+std::string seed_list_to_str(const std::vector<int64_t>& seeds){
+    std::string str = std::to_string(seeds.size()) + " seeds";
+    if (!seeds.empty()){
+        str += " [" + std::to_string(seeds.front()) + " ... " + std::to_string(seeds.back()) + "]";
+    }
+    return str;
+}
+
+int test_pokemonSV_ItemPrinterSeedSearch(){
+    // The search steps several seeds at once in vector lanes. Every item it finds
+    // must match the scalar generator exactly.
+    // The range is odd sized and starts off a lane boundary so the partial
+    // batches at both ends are covered too.
+    const int64_t start = 1700000001;
+    const size_t num_seeds = 20003;
+    const int64_t end = start + (int64_t)num_seeds;
+
+    for (ItemPrinter::PrintMode mode : {ItemPrinter::PrintMode::Regular, ItemPrinter::PrintMode::ItemBonus, ItemPrinter::PrintMode::BallBonus}){
+        const std::string mode_name = "mode " + std::to_string((int)mode);
+
+        std::vector<ItemPrinter::PrizeRolls> scalar_rolls;
+        std::map<uint16_t, uint32_t> max_quantity;
+        for (int64_t seed = start; seed < end; seed++){
+            const ItemPrinter::PrizeRolls& rolls = scalar_rolls.emplace_back(ItemPrinter::calculate_prize_rolls(seed, mode));
+            for (const ItemPrinter::PrizeRoll& roll : rolls){
+                uint32_t& quantity = max_quantity[roll.item_id];
+                quantity = std::max(quantity, ItemPrinter::count_item(rolls, roll.item_id));
+            }
+        }
+
+        // For each item, check the seeds that print any of it and the seeds that print the most of it.
+        for (const auto& item : max_quantity){
+            for (uint32_t min_quantity : {(uint32_t)1, item.second}){
+                std::vector<int64_t> expected;
+                for (size_t c = 0; c < num_seeds; c++){
+                    if (ItemPrinter::count_item(scalar_rolls[c], item.first) >= min_quantity){
+                        expected.emplace_back(start + (int64_t)c);
+                    }
+                }
+                const std::vector<int64_t> result = ItemPrinter::search_seeds_for_item(
+                    start, end, mode, item.first, min_quantity, num_seeds
+                );
+                TEST_RESULT_COMPONENT_EQUAL_WITH_PRINT_FUNC(
+                    result, expected,
+                    mode_name + ", item " + std::to_string(item.first) + " x" + std::to_string(min_quantity),
+                    seed_list_to_str
+                );
+            }
+        }
+    }
+
+    return 0;
+}
+
 }
@@ -66,6 +66,9 @@ int test_pokemonSV_SandwichPlateDetector(const ImageViewRGB32& image, const std:
 
 int test_pokemonSV_RecentlyBattledDetector(const ImageViewRGB32& image, bool target);
 
+//  Check the vectorized seed search against the scalar prize generator.
+int test_pokemonSV_ItemPrinterSeedSearch();
+
 }
 
 #endif
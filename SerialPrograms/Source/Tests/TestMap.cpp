@@ -221,6 +221,8 @@ int sound_bool_detector_helper(SoundBoolDetectorFunction test_func, const std::s
 
 const std::map<std::string, TestFunction> TEST_MAP = {
     {"Kernels_ImageScaleBrightness", std::bind(image_void_detector_helper, test_kernels_ImageScaleBrightness, _1)},
+    {"Kernels_ImageScale", std::bind(image_void_detector_helper, test_kernels_ImageScale, _1)},
+    {"Kernels_ImageHSV", std::bind(image_void_detector_helper, test_kernels_ImageHSV, _1)},
     {"Kernels_BinaryMatrix", std::bind(image_void_detector_helper, test_kernels_BinaryMatrix, _1)},
     {"Kernels_FilterRGB32Range", std::bind(image_void_detector_helper, test_kernels_FilterRGB32Range, _1)},
     {"Kernels_FilterRGB32Euclidean", std::bind(image_void_detector_helper, test_kernels_FilterRGB32Euclidean, _1)},
@@ -229,6 +231,7 @@ const std::map<std::string, TestFunction> TEST_MAP = {
     {"Kernels_CompressRGB32ToBinaryEuclidean", std::bind(image_void_detector_helper, test_kernels_CompressRGB32ToBinaryEuclidean, _1)},
     {"Kernels_Waterfill", std::bind(image_void_detector_helper, test_kernels_Waterfill, _1)},
     {"CommonFramework_BlackBorderDetector", std::bind(image_bool_detector_helper, test_CommonFramework_BlackBorderDetector, _1)},
+    {"CommonFramework_ImageStatsTable", std::bind(image_void_detector_helper, test_CommonFramework_ImageStatsTable, _1)},
     {"NintendoSwitch_UpdatePopupDetector", std::bind(image_bool_detector_helper, test_NintendoSwitch_UpdatePopupDetector, _1)},
     {"PokemonSwSh_YCommMenuDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_YCommMenuDetector, _1)},
     {"PokemonSwSh_MaxLair_BattleMenuDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_MaxLair_BattleMenuDetector, _1)},
@@ -312,4 +315,14 @@ TestFunction find_test_function(const std::string& test_space, const std::string
     return it->second;
 }
 
+const std::map<std::string, SelfContainedTestFunction> SELF_CONTAINED_TEST_MAP = {
+    {"CommonFramework_SuperscalarScheduler", test_CommonFramework_SuperscalarScheduler},
+    {"CommonFramework_Mp4Concatenator", test_CommonFramework_Mp4Concatenator},
+    {"PokemonSV_ItemPrinterSeedSearch", test_pokemonSV_ItemPrinterSeedSearch},
+};
+
+const std::map<std::string, SelfContainedTestFunction>& self_contained_tests(){
+    return SELF_CONTAINED_TEST_MAP;
+}
+
 }
@@ -9,6 +9,7 @@
 #ifndef PokemonAutomation_Tests_TestMap_H
 #define PokemonAutomation_Tests_TestMap_H
 
+#include <map>
 #include <string>
 #include <functional>
 
@@ -25,6 +26,14 @@ using TestFunction = std::function<int(const std::string& test_file_path)>;
 // See CommandLineTests.h for details on test space and test object.
 TestFunction find_test_function(const std::string& test_space, const std::string& test_obj_name);
 
+// Tests that generate their own input and need no test files.
+// Returns 0 if the test succeeds, > 0 if it fails.
+using SelfContainedTestFunction = std::function<int()>;
+
+// Every self-contained test, keyed the same way as the file based tests:
+// "<test space>_<test object>".
+const std::map<std::string, SelfContainedTestFunction>& self_contained_tests();
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*  Test Reports
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <iostream>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "TestReports.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+namespace PokemonAutomation{
+
+
+bool is_regression(double old_value, double new_value, double min_difference){
+    return old_value > 0
+        && new_value > old_value * REGRESSION_RATIO
+        && new_value - old_value > min_difference;
+}
+
+void write_report(const JsonObject& report, const std::string& path){
+    if (path.empty()){
+        return;
+    }
+    report.dump(path);
+    cout << "Report written to " << path << endl;
+}
+
+size_t compare_with_baseline(
+    const JsonObject& report,
+    const std::string& baseline_path,
+    const std::function<size_t(const JsonObject& baseline, const JsonObject& report)>& compare
+){
+    if (baseline_path.empty()){
+        return 0;
+    }
+
+    JsonValue baseline_json;
+    try{
+        baseline_json = load_json_file(baseline_path);
+    }catch (FileException&){
+    }catch (ParseException&){}
+    const JsonObject* baseline = baseline_json.to_object();
+    if (baseline == nullptr){
+        cerr << "Error: cannot read baseline report " << baseline_path << endl;
+        return 1;
+    }
+
+    size_t regressions = compare(*baseline, report);
+    cout << regressions << " regression" << (regressions != 1 ? "s" : "") << " against baseline "
+         << baseline_path << endl;
+    return regressions;
+}
+
+
+}
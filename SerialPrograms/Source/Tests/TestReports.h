@@ -0,0 +1,45 @@
+/*  Test Reports
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  JSON reports and baseline comparison shared by the command line tests and
+ *  the kernel benchmarks.
+ *
+ */
+
+#ifndef PokemonAutomation_Tests_TestReports_H
+#define PokemonAutomation_Tests_TestReports_H
+
+#include <string>
+#include <functional>
+
+namespace PokemonAutomation{
+
+class JsonObject;
+
+
+// A timing is a regression if it's this much slower than the baseline.
+constexpr double REGRESSION_RATIO = 1.15;
+
+// Return true if "new_value" is more than REGRESSION_RATIO times "old_value"
+// and also more than "min_difference" above it. Use "min_difference" to keep
+// timer noise on tiny measurements from showing up. A baseline value that is
+// zero or missing is never a regression.
+bool is_regression(double old_value, double new_value, double min_difference = 0);
+
+// Write "report" to "path" and say so. Does nothing if "path" is empty.
+void write_report(const JsonObject& report, const std::string& path);
+
+// Load the report at "baseline_path" and count the regressions in "report"
+// with "compare", which prints each one it finds. Prints the total.
+// Returns 0 if "baseline_path" is empty. An unreadable baseline counts as one
+// regression so that it isn't silently ignored.
+size_t compare_with_baseline(
+    const JsonObject& report,
+    const std::string& baseline_path,
+    const std::function<size_t(const JsonObject& baseline, const JsonObject& report)>& compare
+);
+
+
+}
+#endif
@@ -167,6 +167,8 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/SerialConnection/SerialConnection.h
     ../Common/Cpp/SerialConnection/SerialConnectionPOSIX.h
     ../Common/Cpp/SerialConnection/SerialConnectionWinAPI.h
+    ../Common/Cpp/SerialConnection/SerialReactorPOSIX.cpp
+    ../Common/Cpp/SerialConnection/SerialReactorPOSIX.h
     ../Common/Cpp/SerialConnection/StreamInterface.h
     ../Common/Cpp/Sockets/AbstractClientSocket.h
     ../Common/Cpp/Sockets/ClientSocket.cpp
@@ -346,6 +348,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/ImageTools/ImageDiff.h
     Source/CommonFramework/ImageTools/ImageStats.cpp
     Source/CommonFramework/ImageTools/ImageStats.h
+    Source/CommonFramework/ImageTools/ImageStatsTable.cpp
+    Source/CommonFramework/ImageTools/ImageStatsTable.h
     Source/CommonFramework/ImageTypes/BinaryImage.cpp
     Source/CommonFramework/ImageTypes/BinaryImage.h
     Source/CommonFramework/ImageTypes/ImageHSV32.cpp
@@ -425,6 +429,9 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/ProgramStats/StatsDatabase.h
     Source/CommonFramework/ProgramStats/StatsTracking.cpp
     Source/CommonFramework/ProgramStats/StatsTracking.h
+    Source/CommonFramework/Recording/Mp4Concatenator.cpp
+    Source/CommonFramework/Recording/Mp4Concatenator.h
+    Source/CommonFramework/Recording/Mp4Concatenator_Debugging.h
     Source/CommonFramework/Recording/StreamHistoryOption.cpp
     Source/CommonFramework/Recording/StreamHistoryOption.h
     Source/CommonFramework/Recording/StreamHistorySession.cpp
@@ -433,6 +440,7 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/Recording/StreamHistoryTracker_ParallelStreams.h
     Source/CommonFramework/Recording/StreamHistoryTracker_RecordOnTheFly.h
     Source/CommonFramework/Recording/StreamHistoryTracker_SaveFrames.h
+    Source/CommonFramework/Recording/StreamHistoryTracker_SegmentedStream.h
     Source/CommonFramework/Recording/StreamRecorder.cpp
     Source/CommonFramework/Recording/StreamRecorder.h
     Source/CommonFramework/Startup/NewVersionCheck.cpp
@@ -449,6 +457,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/Tools/GlobalThreadPools.h
     Source/CommonFramework/Tools/ProgramEnvironment.cpp
     Source/CommonFramework/Tools/ProgramEnvironment.h
+    Source/CommonFramework/Tools/ScreenshotEncoder.cpp
+    Source/CommonFramework/Tools/ScreenshotEncoder.h
     Source/CommonFramework/Tools/StatAccumulator.cpp
     Source/CommonFramework/Tools/StatAccumulator.h
     Source/CommonFramework/Tools/VideoStream.cpp
@@ -471,6 +481,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/Stats/CpuUtilizationStats.h
     Source/CommonFramework/VideoPipeline/Stats/MemoryUtilizationStats.cpp
     Source/CommonFramework/VideoPipeline/Stats/MemoryUtilizationStats.h
+    Source/CommonFramework/VideoPipeline/Stats/ProcessUtilizationSampler.cpp
+    Source/CommonFramework/VideoPipeline/Stats/ProcessUtilizationSampler.h
     Source/CommonFramework/VideoPipeline/Stats/ThreadUtilizationStats.cpp
     Source/CommonFramework/VideoPipeline/Stats/ThreadUtilizationStats.h
     Source/CommonFramework/VideoPipeline/UI/VideoDisplayWidget.cpp
@@ -482,6 +494,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/UI/VideoSourceSelectorWidget.cpp
     Source/CommonFramework/VideoPipeline/UI/VideoSourceSelectorWidget.h
     Source/CommonFramework/VideoPipeline/VideoFeed.h
+    Source/CommonFramework/VideoPipeline/VideoFrameDispatcher.cpp
+    Source/CommonFramework/VideoPipeline/VideoFrameDispatcher.h
     Source/CommonFramework/VideoPipeline/VideoOverlay.cpp
     Source/CommonFramework/VideoPipeline/VideoOverlay.h
     Source/CommonFramework/VideoPipeline/VideoOverlayOption.cpp
@@ -500,6 +514,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/VideoSourceDescriptor.h
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Camera.cpp
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Camera.h
+    Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_File.cpp
+    Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_File.h
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Null.cpp
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Null.h
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_StillImage.cpp
@@ -683,6 +699,7 @@ file(GLOB LIBRARY_SOURCES
     Source/Controllers/SerialPABotBase/Connection/PABotBase.h
     Source/Controllers/SerialPABotBase/Connection/PABotBaseConnection.cpp
     Source/Controllers/SerialPABotBase/Connection/PABotBaseConnection.h
+    Source/Controllers/SerialPABotBase/Connection/RttEstimator.h
     Source/Controllers/SerialPABotBase/SerialPABotBase.cpp
     Source/Controllers/SerialPABotBase/SerialPABotBase.h
     Source/Controllers/SerialPABotBase/SerialPABotBase_Connection.cpp
@@ -835,6 +852,22 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range_x64_AVX2.cpp
     Source/Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range_x64_AVX512.cpp
     Source/Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range_x64_SSE42.cpp
+    Source/Kernels/ImageHSV/Kernels_ImageHSV.cpp
+    Source/Kernels/ImageHSV/Kernels_ImageHSV.h
+    Source/Kernels/ImageHSV/Kernels_ImageHSV_Default.cpp
+    Source/Kernels/ImageHSV/Kernels_ImageHSV_Routines.h
+    Source/Kernels/ImageHSV/Kernels_ImageHSV_arm64_NEON.cpp
+    Source/Kernels/ImageHSV/Kernels_ImageHSV_x64_AVX2.cpp
+    Source/Kernels/ImageHSV/Kernels_ImageHSV_x64_AVX512.cpp
+    Source/Kernels/ImageHSV/Kernels_ImageHSV_x64_SSE41.cpp
+    Source/Kernels/ImageScale/Kernels_ImageScale.cpp
+    Source/Kernels/ImageScale/Kernels_ImageScale.h
+    Source/Kernels/ImageScale/Kernels_ImageScale_Default.cpp
+    Source/Kernels/ImageScale/Kernels_ImageScale_Routines.h
+    Source/Kernels/ImageScale/Kernels_ImageScale_arm64_NEON.cpp
+    Source/Kernels/ImageScale/Kernels_ImageScale_x64_AVX2.cpp
+    Source/Kernels/ImageScale/Kernels_ImageScale_x64_AVX512.cpp
+    Source/Kernels/ImageScale/Kernels_ImageScale_x64_SSE41.cpp
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.cpp
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.h
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness_Default.cpp
@@ -980,6 +1013,7 @@ file(GLOB LIBRARY_SOURCES
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_Connection.h
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_Descriptor.cpp
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_Descriptor.h
+    Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_LatencyHistogram.h
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_ProController.cpp
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_ProController.h
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_SelectorWidget.h
@@ -2515,6 +2549,8 @@ file(GLOB LIBRARY_SOURCES
     Source/Tests/CommandLineTests.h
     Source/Tests/CommonFramework_Tests.cpp
     Source/Tests/CommonFramework_Tests.h
+    Source/Tests/Kernels_Benchmarks.cpp
+    Source/Tests/Kernels_Benchmarks.h
     Source/Tests/Kernels_Tests.cpp
     Source/Tests/Kernels_Tests.h
     Source/Tests/NintendoSwitch_Tests.cpp
@@ -2529,6 +2565,8 @@ file(GLOB LIBRARY_SOURCES
     Source/Tests/PokemonSwSh_Tests.h
     Source/Tests/TestMap.cpp
     Source/Tests/TestMap.h
+    Source/Tests/TestReports.cpp
+    Source/Tests/TestReports.h
     Source/Tests/TestUtils.cpp
     Source/Tests/TestUtils.h
     Source/ZeldaTotK/Programs/ZeldaTotK_BowItemDuper.cpp